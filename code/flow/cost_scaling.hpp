@@ -0,0 +1,508 @@
+#pragma once
+
+#include "struct/csr_graph.hpp"
+
+/**
+ * Goldberg-Tarjan cost scaling push-relabel for mincost circulation/flow with supply and
+ * demand at nodes, a drop-in for network_simplex: lower bounds, negative costs and
+ * negative cost cycles are fine, and like there every node gets an artificial arc to or
+ * from a root carrying its supply at a cost above any path, so mincost_flow() routes as
+ * much supply as possible and mincost_circulation() fails if any of it stays artificial.
+ *
+ * Costs are multiplied by V+1 so that a 1-optimal circulation is optimal. Each phase
+ * divides ε by alpha and restores ε-optimality: price_refinement() looks for prices that
+ * make the current circulation ε-optimal as it is, and only if that fails refine()
+ * saturates the arcs of negative reduced cost and pushes the excesses back, FIFO.
+ * Like the global relabels of push_relabel_flow, refine() runs a global price update at
+ * the start and again after O(V+E) relabel work.
+ * After a phase, an arc whose reduced cost exceeds 2(V+1)ε in absolute value is fixed:
+ * no later phase can change its flow, so it is moved past last[u] and never scanned.
+ * The exact potentials are recovered at the end from the scaled prices.
+ *
+ * Flow type should be large enough to hold node supply/excess and sum of all capacities
+ * Cost type should hold (V+1)·(1+sum of |costs|) and potentials, usually 64 bits
+ * O(V³ log(VC))
+ * Usage:
+ *   cost_scaling<int, long> cs(V);
+ *   for (edges...) { cs.add(u, v, lower, upper, unit_cost); }
+ *   for (nodes...) { cs.set_supply(u, supply); }
+ *   auto max_flow = cs.mincost_flow();           or mincost_circulation()
+ *   auto min_cost = cs.get_circulation_cost();
+ */
+template <typename Flow = int64_t, typename Cost = int64_t>
+struct cost_scaling {
+    explicit cost_scaling(int V = 0) : V(V), supply(V + 1), pi(V + 1) {}
+
+    int add(int u, int v, Flow lower, Flow upper, Cost cost) {
+        assert(0 <= u && u < V && 0 <= v && v < V && lower <= upper);
+        return edge.push_back({{u, v}, lower, upper, cost}), E++;
+    }
+    int add_node() { return supply.push_back(0), pi.push_back(0), V++; }
+
+    void add_supply(int u, Flow supply) { this->supply[u] += supply; }
+    void add_demand(int u, Flow demand) { this->supply[u] -= demand; }
+    void set_supply(int u, Flow supply) { this->supply[u] = supply; }
+
+    void update_edge(int e, Flow lower, Flow upper, Cost cost) {
+        edge[e].lower = lower, edge[e].upper = upper, edge[e].cost = cost;
+    }
+
+    auto get_supply(int u) const { return supply[u]; }
+    auto get_potential(int u) const { return pi[u]; }
+    auto get_flow(int e) const { return edge[e].flow; }
+
+    auto reduced_cost(int e) const {
+        auto [u, v] = edge[e].node;
+        return edge[e].cost + pi[u] - pi[v];
+    }
+
+    // Get excess for every vertex: excess(u) = flow(out of u) - flow(into u)
+    auto get_excesses() const {
+        vector<Flow> excess(V);
+        for (int e = 0; e < E; e++) {
+            auto [u, v] = edge[e].node;
+            excess[u] += edge[e].flow;
+            excess[v] -= edge[e].flow;
+        }
+        return excess;
+    }
+
+    template <typename CostSum = int64_t>
+    auto get_circulation_cost() const {
+        CostSum sum = 0;
+        for (int e = 0; e < E; e++) {
+            sum += edge[e].flow * CostSum(edge[e].cost);
+        }
+        return sum;
+    }
+
+    void verify() const {
+        for (int e = 0; e < E; e++) {
+            assert(edge[e].lower <= edge[e].flow && edge[e].flow <= edge[e].upper);
+            assert(edge[e].flow == edge[e].lower || reduced_cost(e) <= 0);
+            assert(edge[e].flow == edge[e].upper || reduced_cost(e) >= 0);
+        }
+    }
+
+    // Run as circulation: find a feasible circulation and fail if one doesn't exist.
+    // Also checks for zero supply sum. Usually this is not what you want.
+    bool mincost_circulation() {
+        static constexpr bool INFEASIBLE = false, OPTIMAL = true;
+
+        Flow sum_supply = 0;
+        for (int u = 0; u < V; u++) {
+            sum_supply += supply[u];
+        }
+        if (sum_supply != 0) {
+            return INFEASIBLE;
+        }
+
+        run();
+
+        for (int e = E; e < E + V; e++) {
+            if (edge[e].flow != 0) {
+                edge.resize(E);
+                return INFEASIBLE;
+            }
+        }
+        edge.resize(E);
+        return OPTIMAL;
+    }
+
+    // Run as mincost maxflow: ignore extra artificial flow and non-zero supply sum
+    // You must set supply at the source(s) and demand at the sink(s) (inf for maxflow)
+    // The excess at a supply/source node u will be in the range [0,supply[u]].
+    // The excess at a demand/sink   node u will be in the range [supply[u],0].
+    Flow mincost_flow() {
+        run();
+
+        Flow maxflow = 0;
+        for (int e = E; e < E + V; e++) {
+            if (edge[e].node[1] == V) {
+                maxflow += edge[e].upper - edge[e].flow;
+            }
+        }
+
+        edge.resize(E);
+        return maxflow;
+    }
+
+    // Implementation
+    struct Edge {
+        int node[2];
+        Flow lower, upper;
+        Cost cost;
+        Flow flow = 0;
+    };
+    int V, E = 0;
+    vector<Flow> supply;
+    vector<Cost> pi;
+    vector<Edge> edge;
+    int alpha = 32; // ε is divided by alpha in each phase
+
+    struct Arc {
+        int head, rev;
+        Flow rescap;
+        Cost cost; // scaled by V+1
+    };
+    csr_graph<> res; // residual edge ids out of each node, in the order of arc[]
+    vector<Arc> arc;
+    vector<int> last; // the arcs of u that aren't fixed are [off[u],last[u])
+    vector<Flow> excess;
+    vector<int> cur, Q, rank, bucket, bucket_next, bucket_prev;
+    int64_t work = 0; // relabel work since the last price update
+
+    // residual id 2e is edge e forwards, 2e+1 is edge e backwards
+    void build_residual() {
+        int N = V + 1, M = 2 * (E + V);
+        vector<int> pos(M);
+        arc.resize(M);
+        auto tail = [&](int a) { return edge[a >> 1].node[a & 1]; };
+        res.build(N, M, tail, [&](int a, int k) {
+            res.to[k] = a, pos[a] = k, arc[k].head = edge[a >> 1].node[~a & 1];
+        });
+        for (int k = 0; k < M; k++) {
+            int a = res.to[k];
+            const auto& [node, lower, upper, c, flow] = edge[a >> 1];
+            arc[k].rev = pos[a ^ 1];
+            arc[k].rescap = node[0] == node[1] ? 0 : a & 1 ? flow : upper - flow;
+            arc[k].cost = a & 1 ? -c * N : c * N;
+        }
+        last.assign(begin(res.off) + 1, end(res.off));
+    }
+
+    void run() {
+        // Remove non-zero lower bounds and compute artif_cost as sum of all costs
+        Cost artif_cost = 1;
+        for (int e = 0; e < E; e++) {
+            auto [u, v] = edge[e].node;
+            edge[e].flow = 0;
+            edge[e].upper -= edge[e].lower;
+            supply[u] -= edge[e].lower;
+            supply[v] += edge[e].lower;
+            artif_cost += edge[e].cost < 0 ? -edge[e].cost : edge[e].cost;
+            // self-loops take no part in the residual network, they are optimal already
+            if (u == v && edge[e].cost < 0) {
+                edge[e].flow = edge[e].upper;
+            }
+        }
+
+        // Add node<->root artificial edges able to take each node's supply or demand
+        int N = V + 1, root = V;
+        edge.resize(E + V);
+        excess.assign(N, 0);
+        for (int u = 0, e = E; u < V; u++, e++) {
+            auto s = supply[u];
+            if (s >= 0) {
+                edge[e] = {{u, root}, 0, s, artif_cost};
+            } else {
+                edge[e] = {{root, u}, 0, -s, artif_cost};
+            }
+            excess[u] = s, excess[root] -= s;
+        }
+
+        build_residual();
+        cur.resize(N), Q.resize(N), rank.resize(N);
+        bucket_next.resize(N), bucket_prev.resize(N);
+        fill(begin(pi), end(pi), 0);
+
+        Cost epsilon = 1;
+        for (int k = 0; k < 2 * (E + V); k++) {
+            epsilon = max(epsilon, arc[k].cost);
+        }
+        bool circulation = false;
+        do {
+            epsilon = max<Cost>(1, epsilon / alpha);
+            if (!circulation || !price_refinement(epsilon)) {
+                refine(epsilon);
+                circulation = true;
+            }
+            fix_arcs(epsilon);
+        } while (epsilon > 1);
+
+        exact_potentials();
+
+        // Write the flows back, then restore flows and supplies
+        for (int k = 0; k < 2 * (E + V); k++) {
+            int a = res.to[k];
+            auto& [node, lower, upper, c, flow] = edge[a >> 1];
+            if (!(a & 1) && node[0] != node[1]) {
+                flow = upper - arc[k].rescap;
+            }
+        }
+        for (int e = 0; e < E; e++) {
+            auto [u, v] = edge[e].node;
+            edge[e].flow += edge[e].lower;
+            edge[e].upper += edge[e].lower;
+            supply[u] += edge[e].lower;
+            supply[v] -= edge[e].lower;
+        }
+    }
+
+    void push(int u, int k, Flow d) {
+        arc[k].rescap -= d, arc[arc[k].rev].rescap += d;
+        excess[u] -= d, excess[arc[k].head] += d;
+    }
+
+    void bucket_insert(int u, int r) {
+        bucket_prev[u] = -1, bucket_next[u] = bucket[r];
+        if (bucket[r] != -1) {
+            bucket_prev[bucket[r]] = u;
+        }
+        bucket[r] = u;
+    }
+    void bucket_erase(int u, int r) {
+        if (bucket_prev[u] != -1) {
+            bucket_next[bucket_prev[u]] = bucket_next[u];
+        } else {
+            bucket[r] = bucket_next[u];
+        }
+        if (bucket_next[u] != -1) {
+            bucket_prev[bucket_next[u]] = bucket_prev[u];
+        }
+    }
+
+    // Make the pseudoflow a circulation again with all residual arcs ε-optimal
+    void refine(Cost epsilon) {
+        int N = V + 1, first = 0, size = 0;
+        for (int u = 0; u < N; u++) {
+            for (int k = res.off[u]; k < last[u]; k++) {
+                if (arc[k].rescap > 0 && arc[k].cost + pi[u] - pi[arc[k].head] < 0) {
+                    push(u, k, arc[k].rescap);
+                }
+            }
+        }
+        for (int u = 0; u < N; u++) {
+            if (excess[u] > 0) {
+                Q[size++] = u;
+            }
+        }
+        price_update(epsilon);
+        while (size > 0) {
+            int u = Q[first];
+            first = first + 1 == N ? 0 : first + 1, size--;
+            while (excess[u] > 0) {
+                if (work > 6 * N + res.E / 2) {
+                    price_update(epsilon);
+                }
+                for (int& k = cur[u]; k < last[u]; k++) {
+                    int v = arc[k].head;
+                    if (arc[k].rescap > 0 && arc[k].cost + pi[u] - pi[v] < 0) {
+                        Flow d = min(excess[u], arc[k].rescap);
+                        if (excess[v] <= 0 && excess[v] + d > 0) {
+                            Q[first + size < N ? first + size : first + size - N] = v;
+                            size++;
+                        }
+                        push(u, k, d);
+                        if (excess[u] == 0) {
+                            break;
+                        }
+                    }
+                }
+                if (excess[u] > 0) {
+                    relabel(u, epsilon);
+                }
+            }
+        }
+    }
+
+    // Lower pi[u] so that the best residual arc out of u has reduced cost -ε
+    void relabel(int u, Cost epsilon) {
+        Cost best = numeric_limits<Cost>::min();
+        for (int k = res.off[u]; k < last[u]; k++) {
+            if (arc[k].rescap > 0 && best < pi[arc[k].head] - arc[k].cost) {
+                best = pi[arc[k].head] - arc[k].cost, cur[u] = k;
+            }
+        }
+        assert(best != numeric_limits<Cost>::min());
+        pi[u] = best - epsilon;
+        work += 12 + res.degree(u);
+    }
+
+    // Global price update: lower every price by ε times the residual distance to a node
+    // with a deficit, where arc u->v has length ⌊c_p(u,v)/ε⌋+1, so every excess gets an
+    // admissible path. Dial's buckets, up to the farthest excess; the rest go that far.
+    void price_update(Cost epsilon) {
+        int N = V + 1, active = 0, d = 0;
+        work = 0;
+        copy(begin(res.off), end(res.off) - 1, begin(cur));
+        if (epsilon > numeric_limits<Cost>::max() / (2 * N)) {
+            return;
+        }
+        fill(begin(rank), end(rank), N);
+        bucket.assign(N + 1, -1);
+        for (int u = 0; u < N; u++) {
+            active += excess[u] > 0;
+            if (excess[u] < 0) {
+                rank[u] = 0, bucket_insert(u, 0);
+            }
+        }
+        for (; active > 0 && d < N; d++) {
+            while (active > 0 && bucket[d] != -1) {
+                int v = bucket[d];
+                bucket[d] = bucket_next[v], active -= excess[v] > 0;
+                for (int k = res.off[v]; k < last[v]; k++) {
+                    int u = arc[k].head;
+                    if (arc[arc[k].rev].rescap > 0 && rank[u] > d) {
+                        Cost rc = -(arc[k].cost + pi[v] - pi[u]);
+                        Cost len = rc < 0 ? 0 : rc / epsilon + 1;
+                        if (len < rank[u] - d) {
+                            if (rank[u] < N) {
+                                bucket_erase(u, rank[u]);
+                            }
+                            rank[u] = d + len, bucket_insert(u, rank[u]);
+                        }
+                    }
+                }
+            }
+            if (active == 0) {
+                break;
+            }
+        }
+        for (int u = 0; u < N; u++) {
+            pi[u] -= min(rank[u], d) * epsilon;
+        }
+    }
+
+    // Look for prices that make the circulation ε-optimal without touching the flow.
+    // Lowering pi[u] by rank[u]·ε works if rank[v] >= rank[u] + ⌈-c_p(u,v)/ε⌉ - 1 for
+    // every residual arc u->v: take the longest paths in the dag of negative arcs, then
+    // settle the ranks top-down with buckets like Dial's. Repeat until no arc is below
+    // -ε, fail if the negative arcs have a cycle or it takes too many rounds.
+    bool price_refinement(Cost epsilon) {
+        int N = V + 1, max_rank = alpha * N;
+        if (epsilon > numeric_limits<Cost>::max() / (2 * max_rank)) {
+            return false;
+        }
+        auto admissible = [&](int u, int k) {
+            return arc[k].rescap > 0 && arc[k].cost + pi[u] - pi[arc[k].head] < 0;
+        };
+
+        for (int round = 0; round < 4; round++) {
+            // Topological order of the negative arcs in Q, using rank as indegree
+            fill(begin(rank), end(rank), 0);
+            for (int u = 0; u < N; u++) {
+                for (int k = res.off[u]; k < last[u]; k++) {
+                    rank[arc[k].head] += admissible(u, k);
+                }
+            }
+            int S = 0;
+            for (int u = 0; u < N; u++) {
+                if (rank[u] == 0) {
+                    Q[S++] = u;
+                }
+            }
+            for (int i = 0; i < S; i++) {
+                int u = Q[i];
+                for (int k = res.off[u]; k < last[u]; k++) {
+                    if (admissible(u, k) && --rank[arc[k].head] == 0) {
+                        Q[S++] = arc[k].head;
+                    }
+                }
+            }
+            if (S < N) {
+                return false;
+            }
+
+            // Longest paths in the dag
+            int top = 0;
+            for (int i = 0; i < N; i++) {
+                int u = Q[i];
+                for (int k = res.off[u]; k < last[u]; k++) {
+                    if (admissible(u, k)) {
+                        int v = arc[k].head;
+                        Cost len = (-(arc[k].cost + pi[u] - pi[v]) - 1) / epsilon;
+                        if (len < max_rank - rank[u] && rank[u] + len > rank[v]) {
+                            rank[v] = rank[u] + len;
+                        }
+                    }
+                }
+                top = max(top, rank[u]);
+            }
+            if (top == 0) {
+                return true;
+            }
+
+            // Settle the ranks from the top bucket down, dropping the prices
+            bucket.assign(top + 1, -1);
+            for (int u = 0; u < N; u++) {
+                if (rank[u] > 0) {
+                    bucket_insert(u, rank[u]);
+                }
+            }
+            for (int r = top; r > 0; r--) {
+                while (bucket[r] != -1) {
+                    int u = bucket[r];
+                    bucket[r] = bucket_next[u];
+                    for (int k = res.off[u]; k < last[u]; k++) {
+                        int v = arc[k].head;
+                        if (arc[k].rescap > 0 && rank[v] < r) {
+                            Cost rc = arc[k].cost + pi[u] - pi[v];
+                            Cost drop = rc < 0 ? 0 : rc / epsilon + 1;
+                            if (drop < r - rank[v]) {
+                                if (rank[v] > 0) {
+                                    bucket_erase(v, rank[v]);
+                                }
+                                rank[v] = r - drop;
+                                bucket_insert(v, rank[v]);
+                            }
+                        }
+                    }
+                    pi[u] -= r * epsilon;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Fix the arcs whose flow can't change anymore by moving them past last[u]
+    void fix_arcs(Cost epsilon) {
+        int N = V + 1;
+        if (epsilon > numeric_limits<Cost>::max() / (2 * N)) {
+            return;
+        }
+        Cost bound = 2 * N * epsilon;
+        for (int u = 0; u < N; u++) {
+            for (int k = res.off[u]; k < last[u];) {
+                Cost rc = arc[k].cost + pi[u] - pi[arc[k].head];
+                if (arc[k].head != u && (rc > bound || rc < -bound)) {
+                    swap_arcs(k, --last[u]);
+                } else {
+                    k++;
+                }
+            }
+        }
+    }
+
+    // Swap two arcs of the same node, neither of them a self-loop
+    void swap_arcs(int i, int j) {
+        if (i != j) {
+            swap(arc[i], arc[j]), swap(res.to[i], res.to[j]);
+            arc[arc[i].rev].rev = i, arc[arc[j].rev].rev = j;
+        }
+    }
+
+    // The flow is optimal, so the residual network has no negative cycles: start from the
+    // scaled down prices and fix the few arcs still below 0 with Bellman-Ford, FIFO.
+    void exact_potentials() {
+        int N = V + 1, first = 0, size = N;
+        for (int u = 0; u < N; u++) {
+            pi[u] = pi[u] >= 0 ? pi[u] / N : -((-pi[u] + N - 1) / N);
+            Q[u] = u, cur[u] = 1;
+        }
+        while (size > 0) {
+            int u = Q[first];
+            first = first + 1 == N ? 0 : first + 1, size--, cur[u] = 0;
+            for (int k = res.off[u]; k < res.off[u + 1]; k++) {
+                int v = arc[k].head;
+                if (arc[k].rescap > 0 && pi[v] > pi[u] + arc[k].cost / N) {
+                    pi[v] = pi[u] + arc[k].cost / N;
+                    if (!cur[v]) {
+                        Q[first + size < N ? first + size : first + size - N] = v;
+                        size++, cur[v] = 1;
+                    }
+                }
+            }
+        }
+    }
+};
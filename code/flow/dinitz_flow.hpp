@@ -1,9 +1,9 @@
 #pragma once
 
-#include <bits/stdc++.h>
-using namespace std;
+#include "struct/csr_graph.hpp"
 
 // Dinitz's blocking flows. O(V²E)
+// The residual arcs of each node are kept in csr form, rebuilt by maxflow() after adds
 template <typename Flow = int64_t, typename FlowSum = Flow>
 struct dinitz_flow {
     static inline default_random_engine rng = default_random_engine(random_device{}());
@@ -12,23 +12,44 @@ struct dinitz_flow {
         Flow cap, flow = 0;
     };
     int V, E = 0;
-    vector<vector<int>> res;
+    csr_graph<> res; // residual edge ids out of each node
     vector<Edge> edge;
 
-    explicit dinitz_flow(int V = 0) : V(V), res(V) {}
+    explicit dinitz_flow(int V = 0) : V(V) {}
+
+    // Network with the arcs of g, the capacity of arc i is g.cost[i]
+    template <typename Cap>
+    explicit dinitz_flow(const csr_graph<Cap>& g) : V(g.V) {
+        edge.reserve(2 * g.E);
+        for (int u = 0; u < V; u++) {
+            for (int i = g.off[u]; i < g.off[u + 1]; i++) {
+                add(u, g.to[i], g.cost[i]);
+            }
+        }
+    }
 
     int add(int u, int v, Flow capacity) {
         assert(0 <= u && u < V && 0 <= v && v < V && capacity >= 0);
-        res[u].push_back(E++), edge.push_back({{u, v}, capacity, 0});
-        res[v].push_back(E++), edge.push_back({{v, u}, 0, 0});
+        edge.push_back({{u, v}, capacity, 0});
+        edge.push_back({{v, u}, 0, 0});
+        E += 2;
         return (E - 2) >> 1;
     }
-    int add_node() { return res.emplace_back(), V++; }
+    int add_node() { return V++; }
     void update_edge(int e, Flow capacity) { edge[2 * e].cap = capacity; }
 
+    void build_residual() {
+        if (res.V != V || res.E != E) {
+            res.build(V, E, [&](int e) { return edge[e].node[0]; },
+                      [&](int e, int k) { res.to[k] = e; });
+        }
+    }
+
+    // Adding edges or nodes afterwards rebuilds the residual lists in insertion order
     void shuffle_edges() {
+        build_residual();
         for (int u = 0; u < V; u++) {
-            shuffle(begin(res[u]), end(res[u]), rng);
+            shuffle(begin(res.to) + res.off[u], begin(res.to) + res.off[u + 1], rng);
         }
     }
 
@@ -81,6 +102,7 @@ struct dinitz_flow {
     }
 
     FlowSum maxflow(int s, int t) {
+        build_residual();
         Q.resize(V);
         FlowSum max_flow = 0;
         while (bfs(s, t)) {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "struct/integer_heaps.hpp"
+#include "struct/csr_graph.hpp"
 
 // Edmonds-Karp augmenting paths for mincost flow. O(V+ElogV) or (V²) per augmentation
 // For min-cost flow problems with one source, one sink. Requires pairing_int_heap
@@ -14,6 +15,7 @@
 //     for (edges...) { mcf.add(u, v, cap, cost); }
 //     bool st_path_exists = mcf.*_init(s, t);
 //     auto [flow, cost, augmentations] = mcf.mincost_flow*(s, t, ...);
+// The residual arcs of each node are kept in csr form, rebuilt by *_init() after adds
 template <typename Flow = int64_t, typename Cost = int64_t, typename FlowSum = Flow,
           typename CostSum = Cost>
 struct mcmflow {
@@ -23,15 +25,33 @@ struct mcmflow {
         Cost cost;
     };
     int V, E = 0;
-    vector<vector<int>> res;
+    csr_graph<> res; // residual edge ids out of each node
     vector<Edge> edge;
 
-    explicit mcmflow(int V) : V(V), res(V), pi(V, 0), heap(V, dist) {}
+    explicit mcmflow(int V) : V(V), pi(V, 0), heap(V, dist) {}
+
+    // Network with the arcs of g, arc i has cost g.cost[i] and capacity cap[i]
+    mcmflow(const csr_graph<Cost>& g, const vector<Flow>& cap) : mcmflow(g.V) {
+        edge.reserve(2 * g.E);
+        for (int u = 0; u < V; u++) {
+            for (int i = g.off[u]; i < g.off[u + 1]; i++) {
+                add(u, g.to[i], cap[i], g.cost[i]);
+            }
+        }
+    }
 
     void add(int u, int v, Flow capacity, Cost cost) {
         assert(0 <= u && u < V && 0 <= v && v < V && u != v && capacity > 0);
-        res[u].push_back(E++), edge.push_back({{u, v}, capacity, 0, cost});
-        res[v].push_back(E++), edge.push_back({{v, u}, 0, 0, -cost});
+        edge.push_back({{u, v}, capacity, 0, cost});
+        edge.push_back({{v, u}, 0, 0, -cost});
+        E += 2;
+    }
+
+    void build_residual() {
+        if (res.V != V || res.E != E) {
+            res.build(V, E, [&](int e) { return edge[e].node[0]; },
+                      [&](int e, int k) { res.to[k] = e; });
+        }
     }
 
     using heap_t = pairing_int_heap<less_container<vector<CostSum>>>;
@@ -44,6 +64,7 @@ struct mcmflow {
 
     // First augmenting path on a DAG in O(V+E) with topological sort
     bool dag_init(int s, int t) {
+        build_residual();
         dist.assign(V, costsuminf);
         prev.assign(V, -1);
         dist[s] = 0;
@@ -83,6 +104,7 @@ struct mcmflow {
 
     // First augmenting path with SPFA in O(V+E) expected time.
     bool spfa_init(int s, int t) {
+        build_residual();
         dist.assign(V, costsuminf);
         prev.assign(V, -1);
         dist[s] = 0;
@@ -119,6 +141,7 @@ struct mcmflow {
 
     // First augmenting path with dijkstra (also the regular augmentor) in O(E log V)
     bool dijkstra(int s, int t) {
+        build_residual();
         dist.assign(V, costsuminf);
         prev.assign(V, -1);
         dist[s] = 0;
@@ -9,8 +9,11 @@ using namespace std;
 // Cost type should be large enough to hold costs and potentials (usually >=64 bits)
 // CostSum type should be large enough to hold inner product of capacities and costs
 // Expected runtime: O(VE) for positive costs, O(E²) for negative costs too
+// Pivot rules: the most negative reduced cost arc in blocks of block_factor·sqrt(E) arcs
+// (BLOCK_SEARCH, the default), the first eligible arc, or the best of all arcs.
 // Usage:
 //   network_simplex<int, long> netw(V);
+//   netw.set_pivot_rule(netw.BLOCK_SEARCH, 2.0);   // optional
 //   for (edges...) { netw.add(u, v, lower, upper, unit_cost); }
 //   for (nodes...) { netw.set_supply(u, supply); }
 //   auto max_flow = netw.mincost_flow();           or mincost_circulation()
@@ -33,6 +36,12 @@ struct network_simplex {
         edge[e].lower = lower, edge[e].upper = upper, edge[e].cost = cost;
     }
 
+    enum PivotRule : int8_t { FIRST_ELIGIBLE, BLOCK_SEARCH, BEST_ELIGIBLE };
+    void set_pivot_rule(PivotRule rule, double block_factor = 1.0) {
+        assert(block_factor > 0);
+        this->rule = rule, this->block_factor = block_factor;
+    }
+
     auto get_supply(int u) const { return node[u].supply; }
     auto get_potential(int u) const { return node[u].pi; }
     auto get_flow(int e) const { return edge[e].flow; }
@@ -165,6 +174,8 @@ struct network_simplex {
     vector<Edge> edge;
     int_lists children;
 
+    PivotRule rule = BLOCK_SEARCH;
+    double block_factor = 1.0;
     int next_arc = 0, block_size = 0;
     vector<int> bfs, perm; // scratchpad for bfs and upwards walk / random permutation
 
@@ -205,7 +216,14 @@ struct network_simplex {
         // We want to, hopefully, find a pivot edge in O(sqrt(E))
         // This should be <E to check different sets of edges in each select()
         // Otherwise we are vulnerable to simplex killers
-        block_size = max(int(ceil(sqrt(E + V))), min(5, V + 1));
+        // A block of 1 is the first eligible arc, a block of E+V is the best arc
+        if (rule == FIRST_ELIGIBLE) {
+            block_size = 1;
+        } else if (rule == BEST_ELIGIBLE) {
+            block_size = E + V;
+        } else {
+            block_size = max(int(ceil(block_factor * sqrt(E + V))), min(5, V + 1));
+        }
         next_arc = 0;
 
         // Random permutation of the edges; helps with wide graphs and killer test cases
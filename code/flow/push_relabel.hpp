@@ -0,0 +1,362 @@
+#pragma once
+
+#include "struct/csr_graph.hpp"
+#include "parallel/fork_join.hpp" // thread_pool, parallel_for
+
+/**
+ * Push-relabel maximum flow, highest label first and FIFO among nodes of equal label.
+ * The residual arcs are csr arrays rebuilt by maxflow() after adds: arc k leaves its node
+ * to head[k] with residual capacity rescap[k], and its reverse is arc rev[k].
+ * Global relabeling sets every label to the residual bfs distance to t, at the start and
+ * again after O(V+E) relabel work. Gap relabeling lifts the nodes above a label that has
+ * just emptied to V, where they are inactive: they cannot reach t anymore.
+ * Phase 1 finds a maximum preflow, phase 2 returns the excess left below V to s so that
+ * get_flow() is a flow, and left_of_mincut() is the residual reach of s like dinitz_flow.
+ *
+ * maxflow(pool, s, t) runs phase 1 in parallel rounds. The active nodes of a round are
+ * split among the threads and each is discharged by one thread only, lock-free: residual
+ * capacities and excesses are atomic, and a push only ever lowers the residual of an arc
+ * leaving the pushing node (Hong's asynchronous push-relabel). Nodes that gain excess
+ * form the next round, with global relabels between rounds.
+ * O(V²√E)
+ */
+template <typename Flow = int64_t, typename FlowSum = Flow>
+struct push_relabel_flow {
+    struct Edge {
+        int node[2];
+        Flow cap, flow = 0;
+    };
+    int V, E = 0;
+    csr_graph<> res; // residual edge ids out of each node
+    vector<Edge> edge;
+    vector<int> head, rev, pos; // pos[e] is the residual arc of edge e
+    vector<Flow> rescap;
+
+    explicit push_relabel_flow(int V = 0) : V(V) {}
+
+    // Network with the arcs of g, the capacity of arc i is g.cost[i]
+    template <typename Cap>
+    explicit push_relabel_flow(const csr_graph<Cap>& g) : V(g.V) {
+        edge.reserve(2 * g.E);
+        for (int u = 0; u < V; u++) {
+            for (int i = g.off[u]; i < g.off[u + 1]; i++) {
+                add(u, g.to[i], g.cost[i]);
+            }
+        }
+    }
+
+    int add(int u, int v, Flow capacity) {
+        assert(0 <= u && u < V && 0 <= v && v < V && capacity >= 0);
+        edge.push_back({{u, v}, capacity, 0});
+        edge.push_back({{v, u}, 0, 0});
+        E += 2;
+        return (E - 2) >> 1;
+    }
+    int add_node() { return V++; }
+    void update_edge(int e, Flow capacity) { edge[2 * e].cap = capacity; }
+
+    void build_residual() {
+        rescap.resize(E);
+        if (res.V != V || res.E != E) {
+            head.resize(E), rev.resize(E), pos.resize(E);
+            res.build(V, E, [&](int e) { return edge[e].node[0]; }, [&](int e, int k) {
+                res.to[k] = e, pos[e] = k, head[k] = edge[e].node[1];
+            });
+            for (int k = 0; k < E; k++) {
+                const auto& [node, cap, flow] = edge[res.to[k]];
+                rev[k] = pos[res.to[k] ^ 1], rescap[k] = cap - flow;
+            }
+        } else {
+            for (int k = 0; k < E; k++) {
+                const auto& [node, cap, flow] = edge[res.to[k]];
+                rescap[k] = cap - flow;
+            }
+        }
+    }
+
+    vector<int> height, cur, Q;
+    vector<int> active_head, active_tail, active_next; // FIFO of active nodes per label
+    vector<int> label_head, label_next, label_prev;    // all nodes per label, for gaps
+    vector<FlowSum> excess;
+    int sink = -1, max_active = -1, max_label = -1;
+    int64_t work = 0;
+
+    FlowSum maxflow(int s, int t) {
+        start_preflow(s);
+        discharge_all(t, s, true);
+        FlowSum max_flow = excess[t];
+        discharge_all(s, t, false);
+        finish(s);
+        return max_flow;
+    }
+
+    FlowSum maxflow(thread_pool& pool, int s, int t) {
+        start_preflow(s);
+        parallel_discharge_all(pool, s, t);
+        FlowSum max_flow = excess[t];
+        discharge_all(s, t, false);
+        finish(s);
+        return max_flow;
+    }
+
+    void clear_flow() {
+        for (int e = 0; e < E; e++) {
+            edge[e].flow = 0;
+        }
+    }
+    Flow get_flow(int e) const { return edge[2 * e].flow; }
+    bool left_of_mincut(int u) const { return Q[u] >= 0; }
+
+  private:
+    void start_preflow(int s) {
+        build_residual();
+        height.assign(V, 0), excess.assign(V, 0), cur.assign(V, 0), Q.resize(V);
+        active_head.assign(V + 1, -1), active_tail.resize(V + 1), active_next.resize(V);
+        label_head.assign(V + 1, -1), label_next.resize(V), label_prev.resize(V);
+        for (int k = res.off[s]; k < res.off[s + 1]; k++) {
+            Flow d = rescap[k];
+            rescap[k] -= d, rescap[rev[k]] += d;
+            excess[s] -= d, excess[head[k]] += d;
+        }
+    }
+
+    // write the flows back to the edges, and the residual reach of s into Q (-1 if not)
+    void finish(int s) {
+        for (int k = 0; k < E; k++) {
+            auto& [node, cap, flow] = edge[res.to[k]];
+            flow = cap - rescap[k];
+        }
+        fill(begin(Q), end(Q), -1);
+        vector<int> bfs = {s};
+        Q[s] = 0;
+        for (int i = 0; i < int(bfs.size()); i++) {
+            int u = bfs[i];
+            for (int k = res.off[u]; k < res.off[u + 1]; k++) {
+                if (rescap[k] > 0 && Q[head[k]] == -1) {
+                    Q[head[k]] = Q[u] + 1, bfs.push_back(head[k]);
+                }
+            }
+        }
+    }
+
+    void activate(int u) {
+        int h = height[u];
+        active_next[u] = -1;
+        if (active_head[h] == -1) {
+            active_head[h] = u;
+        } else {
+            active_next[active_tail[h]] = u;
+        }
+        active_tail[h] = u, max_active = max(max_active, h);
+    }
+    void label_insert(int u) {
+        int h = height[u];
+        label_prev[u] = -1, label_next[u] = label_head[h];
+        if (label_head[h] != -1) {
+            label_prev[label_head[h]] = u;
+        }
+        label_head[h] = u, max_label = max(max_label, h);
+    }
+    void label_erase(int u) {
+        if (label_prev[u] != -1) {
+            label_next[label_prev[u]] = label_next[u];
+        } else {
+            label_head[height[u]] = label_next[u];
+        }
+        if (label_next[u] != -1) {
+            label_prev[label_next[u]] = label_prev[u];
+        }
+    }
+
+    // labels become the residual distance to the sink t, V if unreachable or u == other
+    void global_relabel(int t, int other) {
+        fill(begin(height), end(height), V);
+        fill(begin(label_head), end(label_head), -1);
+        fill(begin(active_head), end(active_head), -1);
+        max_active = max_label = -1, work = 0;
+        height[t] = 0, Q[0] = t;
+        for (int i = 0, S = 1; i < S; i++) {
+            int v = Q[i];
+            for (int k = res.off[v]; k < res.off[v + 1]; k++) {
+                int u = head[k];
+                if (height[u] == V && u != other && rescap[rev[k]] > 0) {
+                    height[u] = height[v] + 1, Q[S++] = u;
+                    label_insert(u), cur[u] = res.off[u];
+                    if (excess[u] > 0) {
+                        activate(u);
+                    }
+                }
+            }
+        }
+    }
+
+    void gap(int g) {
+        for (int h = g + 1; h <= max_label; h++) {
+            for (int u = label_head[h]; u != -1; u = label_next[u]) {
+                height[u] = V;
+            }
+            label_head[h] = active_head[h] = -1;
+        }
+        max_label = g - 1;
+    }
+
+    void relabel(int u, bool gaps) {
+        int old = height[u], h = V;
+        label_erase(u);
+        cur[u] = res.off[u];
+        for (int k = res.off[u]; k < res.off[u + 1]; k++) {
+            if (rescap[k] > 0 && height[head[k]] + 1 < h) {
+                h = height[head[k]] + 1, cur[u] = k;
+            }
+        }
+        work += 12 + res.degree(u);
+        height[u] = h;
+        if (gaps && label_head[old] == -1) {
+            gap(old), height[u] = V;
+        } else if (h < V) {
+            label_insert(u);
+        }
+    }
+
+    void discharge(int u, bool gaps) {
+        while (true) {
+            for (int& k = cur[u]; k < res.off[u + 1]; k++) {
+                int v = head[k];
+                if (rescap[k] > 0 && height[v] + 1 == height[u]) {
+                    Flow d = min<FlowSum>(excess[u], rescap[k]);
+                    if (excess[v] == 0 && v != sink) {
+                        activate(v);
+                    }
+                    rescap[k] -= d, rescap[rev[k]] += d;
+                    excess[u] -= d, excess[v] += d;
+                    if (excess[u] == 0) {
+                        return;
+                    }
+                }
+            }
+            relabel(u, gaps);
+            if (height[u] >= V) {
+                return;
+            }
+        }
+    }
+
+    // move all excess below label V to the sink t, highest label first
+    void discharge_all(int t, int other, bool gaps) {
+        sink = t;
+        global_relabel(t, other);
+        while (max_active >= 0) {
+            int h = max_active, u = active_head[h];
+            if (u == -1) {
+                max_active--;
+                continue;
+            }
+            active_head[h] = active_next[u];
+            discharge(u, gaps);
+            if (work > 6 * V + E / 2) {
+                global_relabel(t, other);
+            }
+        }
+    }
+
+    void parallel_discharge_all(thread_pool& pool, int s, int t) {
+        vector<atomic<Flow>> cf(E);
+        vector<atomic<FlowSum>> ex(V);
+        vector<atomic<int>> ht(V);
+        auto load = [&]() {
+            for (int k = 0; k < E; k++) {
+                cf[k].store(rescap[k], memory_order_relaxed);
+            }
+            for (int u = 0; u < V; u++) {
+                ex[u].store(excess[u], memory_order_relaxed);
+                ht[u].store(height[u], memory_order_relaxed);
+            }
+        };
+        auto store = [&]() {
+            for (int k = 0; k < E; k++) {
+                rescap[k] = cf[k].load(memory_order_relaxed);
+            }
+            for (int u = 0; u < V; u++) {
+                excess[u] = ex[u].load(memory_order_relaxed);
+                height[u] = ht[u].load(memory_order_relaxed);
+            }
+        };
+
+        vector<int> frontier;
+        vector<vector<int>> out;
+        vector<int64_t> in_frontier(V, -1);
+        auto relabel_all = [&]() {
+            global_relabel(t, s), load(), frontier.clear();
+            for (int u = 0; u < V; u++) {
+                if (u != s && u != t && height[u] < V && excess[u] > 0) {
+                    frontier.push_back(u);
+                }
+            }
+        };
+
+        // push to the lowest residual neighbour or relabel above it until u has no excess
+        auto discharge = [&](int u, vector<int>& activated) {
+            int64_t relabel_work = 0;
+            int hu = ht[u].load(memory_order_relaxed);
+            while (hu < V && ex[u].load(memory_order_relaxed) > 0) {
+                int low = -1, hlow = INT_MAX;
+                for (int k = res.off[u]; k < res.off[u + 1]; k++) {
+                    if (cf[k].load(memory_order_relaxed) > 0) {
+                        int hv = ht[head[k]].load(memory_order_relaxed);
+                        if (hv < hlow) {
+                            low = k, hlow = hv;
+                        }
+                    }
+                }
+                if (low == -1 || hu <= hlow) {
+                    hu = low == -1 ? V : min(V, hlow + 1);
+                    ht[u].store(hu, memory_order_relaxed);
+                    relabel_work += 12 + res.degree(u);
+                    continue;
+                }
+                // only u's thread lowers cf[low] and ex[u], others can only raise them
+                FlowSum e = ex[u].load(memory_order_relaxed);
+                Flow d = min<FlowSum>(e, cf[low].load(memory_order_relaxed));
+                int v = head[low];
+                cf[low].fetch_sub(d), cf[rev[low]].fetch_add(d);
+                ex[u].fetch_sub(d);
+                if (ex[v].fetch_add(d) == 0 && v != s && v != t) {
+                    activated.push_back(v);
+                }
+            }
+            return relabel_work;
+        };
+
+        relabel_all();
+        for (int64_t round = 0; !frontier.empty(); round++) {
+            int64_t F = frontier.size(), C = min<int64_t>(F, 8 * pool.pool_size());
+            out.resize(C);
+            atomic<int64_t> round_work = 0;
+            parallel_for(
+                pool, 0, C,
+                [&](int64_t c) {
+                    int64_t w = 0;
+                    for (int64_t j = F * c / C; j < F * (c + 1) / C; j++) {
+                        w += discharge(frontier[j], out[c]);
+                    }
+                    round_work += w;
+                },
+                1);
+
+            frontier.clear();
+            for (int64_t c = 0; c < C; c++) {
+                for (int v : out[c]) {
+                    if (in_frontier[v] != round) {
+                        frontier.push_back(v), in_frontier[v] = round;
+                    }
+                }
+                out[c].clear();
+            }
+            work += round_work;
+            if (work > 6 * V + E / 2) {
+                store(), relabel_all();
+            }
+        }
+        store();
+    }
+};
@@ -2,6 +2,7 @@
 
 #include "algo/y_combinator.hpp"
 #include "struct/disjoint_set.hpp"
+#include "struct/csr_graph.hpp"
 
 struct block_cut_tree {
     vector<int> rep, revcut;
@@ -10,9 +11,11 @@ struct block_cut_tree {
 
     block_cut_tree() = default;
     block_cut_tree(int N, const vector<vector<int>>& adj) { assign(N, adj); }
+    template <typename Cost>
+    block_cut_tree(int N, const csr_graph<Cost>& g) { assign(N, g); }
 
     void assign(int N, const vector<vector<int>>& adj) {
-        rep.assign(N, -1);
+        rep.assign(N, -1), block.clear();
         A = B = 0;
 
         vector<int> cutcount(N), index(N), lowlink(N), stack(N);
@@ -56,6 +59,67 @@ struct block_cut_tree {
             }
         }
 
+        build_tree(N, cutcount);
+    }
+
+    // Same as above on a csr graph, with an explicit stack so deep graphs can't overflow
+    template <typename Cost>
+    void assign(int N, const csr_graph<Cost>& g) {
+        rep.assign(N, -1), block.clear();
+        A = B = 0;
+
+        vector<int> cutcount(N), index(N), lowlink(N), stack(N), calls(N), cursor(N);
+        vector<int> parent(N, -1);
+        int timer = 1, S = 0;
+
+        for (int s = 0; s < N; s++) {
+            if (index[s]) {
+                continue;
+            }
+            int D = 0;
+            auto enter = [&](int u, int p) {
+                index[u] = lowlink[u] = timer++;
+                stack[S++] = u, calls[D++] = u, cursor[u] = g.off[u], parent[u] = p;
+            };
+            enter(s, -1);
+            while (D > 0) {
+                int u = calls[D - 1], p = parent[u];
+                if (cursor[u] < g.off[u + 1]) {
+                    int v = g.to[cursor[u]++];
+                    if (v != p) {
+                        if (index[v]) {
+                            lowlink[u] = min(lowlink[u], index[v]);
+                        } else {
+                            enter(v, u);
+                        }
+                    }
+                    continue;
+                }
+                cutcount[u] -= p == -1 && cutcount[u] > 0;
+                A += cutcount[u] > 0;
+                D--;
+
+                if (p != -1) {
+                    lowlink[p] = min(lowlink[p], lowlink[u]);
+                    if (lowlink[u] >= index[p]) {
+                        cutcount[p]++;
+                        block.push_back({p});
+                        int w = stack[--S];
+                        while (w != u) {
+                            block[B].push_back(w);
+                            w = stack[--S];
+                        }
+                        block[B].push_back(u);
+                        B++;
+                    }
+                }
+            }
+        }
+
+        build_tree(N, cutcount);
+    }
+
+    void build_tree(int N, const vector<int>& cutcount) {
         tree.assign(A + B, {});
         revcut.assign(A + B, -1);
 
@@ -2,6 +2,7 @@
 
 #include "algo/y_combinator.hpp"
 #include "hash.hpp"
+#include "struct/csr_graph.hpp"
 
 auto build_scc(const vector<vector<int>>& adj, bool reverse_order = true) {
     int V = adj.size(), C = 0; // C = number of scc
@@ -47,6 +48,58 @@ auto build_scc(const vector<vector<int>>& adj, bool reverse_order = true) {
     return make_pair(C, cmap);
 }
 
+// Same as above on a csr graph, with an explicit stack so deep graphs can't overflow
+template <typename Cost>
+auto build_scc(const csr_graph<Cost>& g, bool reverse_order = true) {
+    int V = g.V, C = 0;
+
+    vector<int> cmap(V, -1), index(V), lowlink(V), stack(V), calls(V), cursor(V);
+    int timer = 1, S = 0;
+
+    for (int s = 0; s < V; s++) {
+        if (index[s]) {
+            continue;
+        }
+        int D = 0;
+        auto enter = [&](int u) {
+            index[u] = lowlink[u] = timer++;
+            stack[S++] = u, calls[D++] = u, cursor[u] = g.off[u];
+        };
+        enter(s);
+        while (D > 0) {
+            int u = calls[D - 1];
+            if (cursor[u] < g.off[u + 1]) {
+                int v = g.to[cursor[u]++];
+                if (index[v] && cmap[v] == -1) {
+                    lowlink[u] = min(lowlink[u], index[v]);
+                } else if (!index[v]) {
+                    enter(v);
+                }
+                continue;
+            }
+            if (index[u] == lowlink[u]) {
+                int c = C++;
+                int v;
+                do {
+                    v = stack[--S];
+                    cmap[v] = c;
+                } while (u != v);
+            }
+            if (--D > 0) {
+                int p = calls[D - 1];
+                lowlink[p] = min(lowlink[p], lowlink[u]);
+            }
+        }
+    }
+    if (!reverse_order) {
+        for (int u = 0; u < V; u++) {
+            cmap[u] = C - 1 - cmap[u];
+        }
+    }
+
+    return make_pair(C, cmap);
+}
+
 auto condensate_sccedges(const vector<vector<int>>& adj, const vector<int>& cmap) {
     int V = adj.size();
     vector<array<int, 2>> edges;
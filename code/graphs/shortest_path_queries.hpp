@@ -0,0 +1,461 @@
+#pragma once
+
+#include "graphs/shortest_paths.hpp" // csr_graph, pairing_int_heap
+
+/**
+ * Point-to-point shortest path engines on a fixed csr graph with non-negative costs.
+ * Each one preprocesses the graph once and then answers query(s, t) = dist(s, t), or
+ * inf = max/2 if t is unreachable. The arrays of V entries are allocated once and a query
+ * only resets the nodes its search reached, so it costs what it explores, not O(V).
+ *
+ *   bidirectional_dijkstra: forward search from s on g and backward search from t on
+ *       the reversed g, always advancing the side with the smaller key, until the two
+ *       keys add up to the best meeting found.
+ *   alt_landmarks: A* with landmark lower bounds (ALT). K landmarks picked by farthest
+ *       selection, d(L,v) and d(v,L) stored for all L and v, and
+ *       h(v) = max_L max(d(v,L) - d(t,L), d(L,t) - d(L,v)).
+ *       2K dijkstras of preprocessing and 2K·V distances of index.
+ *   contraction_hierarchy: nodes contracted one at a time by least 2·edge difference
+ *       plus contracted neighbours plus level, with lazy updates. Contracting u adds a
+ *       shortcut x->y for x->u->y unless a witness search from x, capped at witness_limit
+ *       settled nodes, finds a path no longer without u. A query is a bidirectional
+ *       dijkstra going up the order only, with stall-on-demand. save(out) / load(in)
+ *       write and read the index. Graphs without hierarchy (random graphs) grow a dense
+ *       top: once the next node has more than core_degree arcs the rest is left as an
+ *       uncontracted core, which queries search in both senses.
+ *
+ * Usage:
+ *   contraction_hierarchy<long> ch(g);
+ *   long d = ch.query(s, t);
+ *   ofstream file("index.ch", ios::binary); ch.save(file);
+ */
+template <typename CostSum>
+struct p2p_search {
+    static constexpr CostSum inf = numeric_limits<CostSum>::max() / 2;
+    vector<CostSum> dist, key; // key is dist plus the heuristic, if any
+    vector<int> seen;
+    pairing_int_heap<less_container<vector<CostSum>>> heap;
+
+    explicit p2p_search(int V = 0) : dist(V, inf), key(V, inf), heap(V, key) {}
+    // the heap's compare points into key, so copies get their own (empty) heap
+    p2p_search(const p2p_search& o)
+        : dist(o.dist), key(o.key), seen(o.seen), heap(o.dist.size(), key) {}
+    p2p_search& operator=(const p2p_search& o) {
+        dist = o.dist, key = o.key, seen = o.seen;
+        heap = decltype(heap)(dist.size(), key);
+        return *this;
+    }
+
+    bool empty() const { return heap.empty(); }
+    CostSum top_key() const { return heap.empty() ? inf : key[heap.top()]; }
+    void reach(int v, CostSum d, CostSum k) {
+        if (dist[v] == inf) {
+            seen.push_back(v);
+        }
+        dist[v] = d, key[v] = k;
+        heap.push_or_improve(v);
+    }
+    void reset() {
+        while (!heap.empty()) {
+            heap.pop();
+        }
+        for (int u : seen) {
+            dist[u] = key[u] = inf;
+        }
+        seen.clear();
+    }
+};
+
+template <typename Cost = long, typename CostSum = Cost>
+struct bidirectional_dijkstra {
+    static constexpr CostSum inf = numeric_limits<CostSum>::max() / 2;
+    csr_graph<Cost> g, rev;
+    p2p_search<CostSum> fwd, bwd;
+
+    explicit bidirectional_dijkstra(const csr_graph<Cost>& g)
+        : g(g), rev(g.reversed()), fwd(g.V), bwd(g.V) {}
+
+    CostSum query(int s, int t) {
+        fwd.reset(), bwd.reset();
+        fwd.reach(s, 0, 0), bwd.reach(t, 0, 0);
+        CostSum best = s == t ? 0 : inf;
+        while (fwd.top_key() + bwd.top_key() < best) {
+            if (fwd.top_key() <= bwd.top_key()) {
+                settle(g, fwd, bwd, best);
+            } else {
+                settle(rev, bwd, fwd, best);
+            }
+        }
+        return best;
+    }
+
+  private:
+    static void settle(const csr_graph<Cost>& G, p2p_search<CostSum>& A,
+                       const p2p_search<CostSum>& B, CostSum& best) {
+        int u = A.heap.pop();
+        for (int i = G.off[u]; i < G.off[u + 1]; i++) {
+            int v = G.to[i];
+            CostSum d = A.dist[u] + G.cost[i];
+            if (d < A.dist[v]) {
+                A.reach(v, d, d);
+                best = min(best, d + B.dist[v]);
+            }
+        }
+    }
+};
+
+template <typename Cost = long, typename CostSum = Cost>
+struct alt_landmarks {
+    static constexpr CostSum inf = numeric_limits<CostSum>::max() / 2;
+    csr_graph<Cost> g;
+    int K = 0;
+    vector<int> landmarks;
+    vector<CostSum> from, to; // from[v·K+i] = d(L_i,v), to[v·K+i] = d(v,L_i)
+    p2p_search<CostSum> search;
+
+    explicit alt_landmarks(const csr_graph<Cost>& g, int num_landmarks = 16)
+        : g(g), search(g.V) {
+        int V = g.V;
+        auto rev = g.reversed();
+        K = min(num_landmarks, V);
+        from.assign(1LL * V * K, inf), to.assign(1LL * V * K, inf);
+
+        // next landmark: the node farthest (there and back) from the nearest landmark so
+        // far, among the nodes strongly connected to one. The first is farthest from 0
+        vector<CostSum> nearest(V, inf);
+        auto farthest = [&]() {
+            int best = -1;
+            for (int v = 0; v < V; v++) {
+                if (nearest[v] < inf && (best == -1 || nearest[v] > nearest[best])) {
+                    best = v;
+                }
+            }
+            return best;
+        };
+        auto visit = [&](int L) {
+            auto df = dijkstra<Cost, CostSum>(L, g), db = dijkstra<Cost, CostSum>(L, rev);
+            for (int v = 0; v < V; v++) {
+                if (df[v] < inf && db[v] < inf) {
+                    nearest[v] = min(nearest[v], df[v] + db[v]);
+                }
+            }
+            return make_pair(move(df), move(db));
+        };
+        if (V > 0) {
+            visit(0);
+        }
+        for (int i = 0; i < K; i++) {
+            int L = farthest();
+            if (L == -1 || (i > 0 && nearest[L] == 0)) {
+                break;
+            }
+            if (i == 0) {
+                fill(begin(nearest), end(nearest), inf);
+            }
+            auto [df, db] = visit(L);
+            nearest[L] = 0;
+            for (int v = 0; v < V; v++) {
+                from[1LL * v * K + i] = df[v], to[1LL * v * K + i] = db[v];
+            }
+            landmarks.push_back(L);
+        }
+    }
+
+    // lower bound on d(v,t), inf if v provably cannot reach t
+    CostSum heuristic(int v, int t) const {
+        const CostSum *fv = &from[1LL * v * K], *ft = &from[1LL * t * K];
+        const CostSum *tv = &to[1LL * v * K], *tt = &to[1LL * t * K];
+        CostSum h = 0;
+        for (int i = 0, L = landmarks.size(); i < L; i++) {
+            h = max(h, max(tv[i] - tt[i], ft[i] - fv[i]));
+        }
+        return h >= inf / 2 ? inf : h;
+    }
+
+    CostSum query(int s, int t) {
+        search.reset();
+        if (CostSum h = heuristic(s, t); h < inf) {
+            search.reach(s, 0, h);
+        }
+        auto& dist = search.dist;
+        while (!search.empty()) {
+            int u = search.heap.pop();
+            if (u == t) {
+                return dist[t];
+            }
+            for (int i = g.off[u]; i < g.off[u + 1]; i++) {
+                int v = g.to[i];
+                CostSum d = dist[u] + g.cost[i];
+                if (d < dist[v]) {
+                    auto h = dist[v] == inf ? heuristic(v, t) : search.key[v] - dist[v];
+                    if (h < inf) {
+                        search.reach(v, d, d + h);
+                    }
+                }
+            }
+        }
+        return inf;
+    }
+};
+
+template <typename Cost = long, typename CostSum = Cost>
+struct contraction_hierarchy {
+    static constexpr CostSum inf = numeric_limits<CostSum>::max() / 2;
+    int V = 0;
+    vector<int> rank;            // position of each node in the order, the core last
+    csr_graph<CostSum> up, down; // up: u->v, down: u->v for arc v->u, v above u or core
+    p2p_search<CostSum> fwd, bwd;
+
+    contraction_hierarchy() = default;
+    explicit contraction_hierarchy(const csr_graph<Cost>& g, int witness_limit = 100,
+                                   int core_degree = INT_MAX) {
+        build(g, witness_limit, core_degree);
+    }
+
+    void build(const csr_graph<Cost>& g, int witness_limit = 100,
+               int core_degree = INT_MAX) {
+        using arc_t = pair<int, CostSum>;
+        V = g.V;
+        vector<vector<arc_t>> out(V), in(V); // arcs between uncontracted nodes
+        for (int u = 0; u < V; u++) {
+            for (int i = g.off[u]; i < g.off[u + 1]; i++) {
+                if (int v = g.to[i]; v != u) {
+                    out[u].emplace_back(v, g.cost[i]), in[v].emplace_back(u, g.cost[i]);
+                }
+            }
+        }
+        for (auto* adj : {&out, &in}) { // keep the cheapest of parallel arcs
+            for (auto& arcs : *adj) {
+                sort(begin(arcs), end(arcs));
+                arcs.erase(unique(begin(arcs), end(arcs),
+                                  [](auto& a, auto& b) { return a.first == b.first; }),
+                           end(arcs));
+            }
+        }
+
+        // dijkstra from x avoiding u until all the targets or witness_limit nodes settle
+        // or the keys pass bound
+        vector<CostSum> wdist(V, inf);
+        vector<int> wseen;
+        vector<char> target(V);
+        vector<pair<CostSum, int>> wheap; // binary heap with lazy deletion, small anyway
+        auto witness = [&](int x, int u, CostSum bound, int targets) {
+            for (int v : wseen) {
+                wdist[v] = inf;
+            }
+            wseen.assign(1, x), wdist[x] = 0, wheap.assign(1, {0, x});
+            for (int settled = 0; !wheap.empty() && settled < witness_limit;) {
+                pop_heap(begin(wheap), end(wheap), greater<>{});
+                auto [d, v] = wheap.back();
+                wheap.pop_back();
+                if (d > wdist[v]) {
+                    continue;
+                }
+                if (d > bound || (target[v] && --targets == 0)) {
+                    break;
+                }
+                for (auto [y, c] : out[v]) {
+                    if (y != u && d + c < wdist[y]) {
+                        if (wdist[y] == inf) {
+                            wseen.push_back(y);
+                        }
+                        wdist[y] = d + c;
+                        wheap.emplace_back(d + c, y);
+                        push_heap(begin(wheap), end(wheap), greater<>{});
+                    }
+                }
+                settled++;
+            }
+        };
+        // shortcuts(x, y, cost) needed to contract u, given to fn one at a time
+        auto shortcuts = [&](int u, auto&& fn) {
+            CostSum out_max = 0;
+            for (auto [y, c] : out[u]) {
+                out_max = max(out_max, c), target[y] = true;
+            }
+            for (auto [x, cx] : in[u]) {
+                witness(x, u, cx + out_max, out[u].size());
+                for (auto [y, cy] : out[u]) {
+                    if (y != x && wdist[y] > cx + cy) {
+                        fn(x, y, cx + cy);
+                    }
+                }
+            }
+            for (auto [y, c] : out[u]) {
+                target[y] = false;
+            }
+        };
+        auto add_arc = [&](vector<arc_t>& arcs, int v, CostSum c) {
+            for (auto& [w, cw] : arcs) {
+                if (w == v) {
+                    cw = min(cw, c);
+                    return;
+                }
+            }
+            arcs.emplace_back(v, c);
+        };
+        auto erase_arc = [&](vector<arc_t>& arcs, int v) {
+            for (auto& arc : arcs) {
+                if (arc.first == v) {
+                    swap(arc, arcs.back()), arcs.pop_back();
+                    return;
+                }
+            }
+        };
+
+        vector<int> deleted(V), priority(V), level(V), mark(V, -1);
+        auto compute_priority = [&](int u) {
+            int added = 0;
+            shortcuts(u, [&](int, int, CostSum) { added++; });
+            int removed = in[u].size() + out[u].size();
+            return priority[u] = 2 * (added - removed) + deleted[u] + level[u];
+        };
+        using entry_t = pair<int, int>;
+        priority_queue<entry_t, vector<entry_t>, greater<entry_t>> Q;
+        for (int u = 0; u < V; u++) {
+            Q.emplace(compute_priority(u), u);
+        }
+
+        rank.assign(V, -1);
+        int contracted = 0;
+        edges_t up_arcs, down_arcs;
+        vector<CostSum> up_cost, down_cost;
+        while (!Q.empty()) {
+            auto [p, u] = Q.top();
+            Q.pop();
+            if (rank[u] != -1 || p != priority[u]) {
+                continue;
+            }
+            // lazy update: contract u only if it is still the minimum once recomputed
+            if (compute_priority(u) > p && !Q.empty() && priority[u] > Q.top().first) {
+                Q.emplace(priority[u], u);
+                continue;
+            }
+            if (int(in[u].size() + out[u].size()) > core_degree) {
+                break;
+            }
+            rank[u] = contracted++;
+            vector<tuple<int, int, CostSum>> added;
+            shortcuts(u, [&](int x, int y, CostSum c) { added.emplace_back(x, y, c); });
+            for (auto [x, y, c] : added) {
+                add_arc(out[x], y, c), add_arc(in[y], x, c);
+            }
+            for (auto [v, c] : out[u]) {
+                up_arcs.push_back({u, v}), up_cost.push_back(c);
+                erase_arc(in[v], u);
+            }
+            for (auto [v, c] : in[u]) {
+                down_arcs.push_back({u, v}), down_cost.push_back(c);
+                erase_arc(out[v], u);
+            }
+            // the neighbours' priorities only follow deleted[] and level[] here, the edge
+            // difference is recomputed when they come up in Q
+            for (auto* adj : {&out[u], &in[u]}) {
+                for (auto [v, c] : *adj) {
+                    if (mark[v] != u) {
+                        int raise = max(0, level[u] + 1 - level[v]);
+                        mark[v] = u, deleted[v]++, level[v] += raise;
+                        Q.emplace(priority[v] += 1 + raise, v);
+                    }
+                }
+            }
+            vector<arc_t>().swap(out[u]), vector<arc_t>().swap(in[u]);
+        }
+        for (int u = 0; u < V; u++) {
+            if (rank[u] == -1) {
+                rank[u] = contracted++;
+                for (auto [v, c] : out[u]) {
+                    up_arcs.push_back({u, v}), up_cost.push_back(c);
+                }
+                for (auto [v, c] : in[u]) {
+                    down_arcs.push_back({u, v}), down_cost.push_back(c);
+                }
+            }
+        }
+
+        up = csr_graph<CostSum>(V, up_arcs, up_cost);
+        down = csr_graph<CostSum>(V, down_arcs, down_cost);
+        fwd = p2p_search<CostSum>(V), bwd = p2p_search<CostSum>(V);
+    }
+
+    CostSum query(int s, int t) {
+        fwd.reset(), bwd.reset();
+        fwd.reach(s, 0, 0), bwd.reach(t, 0, 0);
+        CostSum best = inf;
+        while (min(fwd.top_key(), bwd.top_key()) < best) {
+            if (fwd.top_key() <= bwd.top_key()) {
+                settle(up, down, fwd, bwd, best);
+            } else {
+                settle(down, up, bwd, fwd, best);
+            }
+        }
+        return best;
+    }
+
+    // Bytes of the preprocessed form, what save() writes minus the headers
+    int64_t index_size() const {
+        int64_t ints = rank.size() + up.off.size() + up.to.size();
+        ints += down.off.size() + down.to.size();
+        return ints * sizeof(int) + (up.cost.size() + down.cost.size()) * sizeof(CostSum);
+    }
+
+    void save(ostream& out) const {
+        int64_t header[2] = {V, sizeof(CostSum)};
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        for (auto* v : {&rank, &up.off, &up.to, &down.off, &down.to}) {
+            write_vector(out, *v);
+        }
+        write_vector(out, up.cost), write_vector(out, down.cost);
+    }
+
+    void load(istream& in) {
+        int64_t header[2];
+        in.read(reinterpret_cast<char*>(header), sizeof(header));
+        assert(in && header[1] == int64_t(sizeof(CostSum)));
+        V = header[0];
+        for (auto* v : {&rank, &up.off, &up.to, &down.off, &down.to}) {
+            read_vector(in, *v);
+        }
+        read_vector(in, up.cost), read_vector(in, down.cost);
+        assert(in && int(rank.size()) == V);
+        up.V = down.V = V, up.E = up.to.size(), down.E = down.to.size();
+        fwd = p2p_search<CostSum>(V), bwd = p2p_search<CostSum>(V);
+    }
+
+  private:
+    // settle the top of A and relax its arcs in G, unless some arc v->u in H from a node
+    // above u reaches u shorter (stall-on-demand): then u is not on a shortest up path
+    static void settle(const csr_graph<CostSum>& G, const csr_graph<CostSum>& H,
+                       p2p_search<CostSum>& A, const p2p_search<CostSum>& B,
+                       CostSum& best) {
+        int u = A.heap.pop();
+        CostSum du = A.dist[u];
+        best = min(best, du + B.dist[u]);
+        for (int i = H.off[u]; i < H.off[u + 1]; i++) {
+            if (A.dist[H.to[i]] + H.cost[i] < du) {
+                return;
+            }
+        }
+        for (int i = G.off[u]; i < G.off[u + 1]; i++) {
+            int v = G.to[i];
+            CostSum d = du + G.cost[i];
+            if (d < A.dist[v]) {
+                A.reach(v, d, d);
+            }
+        }
+    }
+
+    template <typename T>
+    static void write_vector(ostream& out, const vector<T>& v) {
+        int64_t n = v.size();
+        out.write(reinterpret_cast<const char*>(&n), sizeof(n));
+        out.write(reinterpret_cast<const char*>(v.data()), n * sizeof(T));
+    }
+    template <typename T>
+    static void read_vector(istream& in, vector<T>& v) {
+        int64_t n = 0;
+        in.read(reinterpret_cast<char*>(&n), sizeof(n));
+        v.resize(in ? n : 0);
+        in.read(reinterpret_cast<char*>(v.data()), v.size() * sizeof(T));
+    }
+};
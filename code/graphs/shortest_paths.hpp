@@ -3,6 +3,8 @@
 #include "struct/pbds.hpp"
 #include "struct/integer_heaps.hpp"
 #include "struct/circular_queue.hpp"
+#include "struct/csr_graph.hpp"
+#include "parallel/fork_join.hpp" // thread_pool, parallel_blocks
 
 template <typename Cost = long, typename CostSum = Cost>
 auto spfa(int s, const vector<vector<pair<int, Cost>>>& adj) {
@@ -36,6 +38,31 @@ auto spfa(int s, const vector<vector<pair<int, Cost>>>& adj) {
     return dist;
 }
 
+template <typename Cost = long, typename CostSum = Cost>
+auto spfa(int s, const csr_graph<Cost>& g) {
+    constexpr CostSum inf = numeric_limits<CostSum>::max() / 2;
+
+    int V = g.V;
+    vector<CostSum> dist(V, inf);
+    dist[s] = 0;
+
+    spfa_deque<less_container<vector<CostSum>>> Q(V, dist);
+    Q.push(s);
+
+    do {
+        int u = Q.pop();
+        for (int i = g.off[u]; i < g.off[u + 1]; i++) {
+            int v = g.to[i];
+            if (dist[v] > dist[u] + g.cost[i]) {
+                dist[v] = dist[u] + g.cost[i];
+                Q.push(v);
+            }
+        }
+    } while (!Q.empty());
+
+    return dist;
+}
+
 template <typename Cost = long, typename CostSum = Cost>
 auto dijkstra(int s, const vector<vector<pair<int, Cost>>>& adj) {
     constexpr CostSum inf = numeric_limits<CostSum>::max() / 2;
@@ -63,6 +90,31 @@ auto dijkstra(int s, const vector<vector<pair<int, Cost>>>& adj) {
     return dist;
 }
 
+template <typename Cost = long, typename CostSum = Cost>
+auto dijkstra(int s, const csr_graph<Cost>& g) {
+    constexpr CostSum inf = numeric_limits<CostSum>::max() / 2;
+
+    int V = g.V;
+    vector<CostSum> dist(V, inf);
+    dist[s] = 0;
+
+    pairing_int_heap<less_container<vector<CostSum>>> heap(V, dist);
+    heap.push(s);
+
+    do {
+        int u = heap.pop();
+        for (int i = g.off[u]; i < g.off[u + 1]; i++) {
+            int v = g.to[i];
+            if (dist[v] > dist[u] + g.cost[i]) {
+                dist[v] = dist[u] + g.cost[i];
+                heap.push_or_improve(v);
+            }
+        }
+    } while (!heap.empty());
+
+    return dist;
+}
+
 template <typename Cost = long, typename CostSum = Cost>
 auto bellman_ford(int V, int s, const vector<tuple<int, int, Cost>>& edge) {
     constexpr CostSum inf = numeric_limits<CostSum>::max() / 2;
@@ -118,6 +170,36 @@ auto bellman_ford(int s, const vector<vector<pair<int, Cost>>>& adj) {
     return dist;
 }
 
+template <typename Cost = long, typename CostSum = Cost>
+auto bellman_ford(int s, const csr_graph<Cost>& g) {
+    constexpr CostSum inf = numeric_limits<CostSum>::max() / 2;
+
+    int V = g.V;
+    vector<CostSum> dist(V, inf);
+    dist[s] = 0;
+
+    bool stop = false;
+    for (int phase = 0; phase < V && !stop; phase++) {
+        stop = true;
+        for (int u = 0; u < V; u++) {
+            if (dist[u] == inf) {
+                continue;
+            }
+            for (int i = g.off[u]; i < g.off[u + 1]; i++) {
+                int v = g.to[i];
+                if (dist[v] > dist[u] + g.cost[i]) {
+                    dist[v] = dist[u] + g.cost[i];
+                    stop = false;
+                }
+            }
+        }
+    }
+    // if stop is false, negative cycle detected
+    assert(stop);
+
+    return dist;
+}
+
 template <typename Cost = long, typename CostSum = Cost>
 bool bellman_ford_check(vector<vector<pair<int, Cost>>>& adj) {
     constexpr CostSum inf = numeric_limits<CostSum>::max() / 2;
@@ -382,3 +464,177 @@ auto dial(int s, int B, const vector<vector<pair<int, int>>>& adj) {
 
     return dist;
 }
+
+/**
+ * Single source shortest paths engines on csr graphs with non-negative costs, drop-in
+ * replacements for dijkstra(s, g) that return the same dist[] with inf = max/2.
+ *
+ *   radix_dijkstra:  dijkstra with radix_int_heap, integer costs. O(E + V log C)
+ *   dial:            dijkstra with maxcost+1 circular buckets, small integer costs.
+ *                    O(E + V + maxcost·V) worst case but usually ~O(E + dist[t])
+ *   delta_stepping:  parallel, buckets of width delta. Each bucket relaxes its light arcs
+ *                    (cost <= delta) in parallel rounds until it stops changing, then its
+ *                    heavy arcs once. delta defaults to maxcost/average degree. The
+ *                    circular bucket array has maxcost/delta+2 slots.
+ */
+template <typename Cost = long, typename CostSum = Cost>
+auto radix_dijkstra(int s, const csr_graph<Cost>& g) {
+    static_assert(is_integral_v<CostSum>);
+    constexpr CostSum inf = numeric_limits<CostSum>::max() / 2;
+
+    int V = g.V;
+    vector<CostSum> dist(V, inf);
+    dist[s] = 0;
+
+    radix_int_heap<vector<CostSum>> heap(V, dist);
+    heap.push(s);
+
+    do {
+        int u = heap.pop();
+        for (int i = g.off[u]; i < g.off[u + 1]; i++) {
+            int v = g.to[i];
+            if (dist[v] > dist[u] + g.cost[i]) {
+                dist[v] = dist[u] + g.cost[i];
+                heap.push_or_improve(v);
+            }
+        }
+    } while (!heap.empty());
+
+    return dist;
+}
+
+template <typename Cost = long, typename CostSum = Cost>
+auto dial(int s, const csr_graph<Cost>& g) {
+    static_assert(is_integral_v<Cost> && is_integral_v<CostSum>);
+    constexpr CostSum inf = numeric_limits<CostSum>::max() / 2;
+
+    int V = g.V;
+    vector<CostSum> dist(V, inf);
+    dist[s] = 0;
+
+    Cost maxcost = g.E ? *max_element(begin(g.cost), end(g.cost)) : 0;
+    assert(0 <= maxcost && maxcost < INT_MAX);
+    int B = maxcost + 1;
+    circular_buckets_queue heap(V, B);
+    heap.push(s, 0);
+
+    do {
+        int u = heap.pop();
+        for (int i = g.off[u]; i < g.off[u + 1]; i++) {
+            int v = g.to[i];
+            if (dist[v] > dist[u] + g.cost[i]) {
+                dist[v] = dist[u] + g.cost[i];
+                heap.push(v, dist[v] % B);
+            }
+        }
+    } while (!heap.empty());
+
+    return dist;
+}
+
+template <typename Cost = long, typename CostSum = Cost>
+auto delta_stepping(thread_pool& pool, int s, const csr_graph<Cost>& g, Cost delta = 0) {
+    constexpr CostSum inf = numeric_limits<CostSum>::max() / 2;
+
+    int V = g.V;
+    Cost maxcost = g.E ? *max_element(begin(g.cost), end(g.cost)) : 0;
+    if (delta <= 0) {
+        delta = max<Cost>(1, maxcost / max(1, g.E / max(V, 1)));
+    }
+    delta = max<Cost>(delta, maxcost / (1 << 20)); // at most ~1M buckets
+    int NB = maxcost / delta + 2;
+
+    vector<atomic<CostSum>> dist(V);
+    for (int u = 0; u < V; u++) {
+        dist[u].store(inf, memory_order_relaxed);
+    }
+    dist[s].store(0, memory_order_relaxed);
+    auto get = [&](int u) { return dist[u].load(memory_order_relaxed); };
+    auto relax = [&](int v, CostSum d) {
+        CostSum old = get(v);
+        while (d < old) {
+            if (dist[v].compare_exchange_weak(old, d, memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    vector<vector<int>> bucket(NB), out;
+    vector<int> frontier, settled;
+    vector<int64_t> in_frontier(V, -1), in_settled(V, -1);
+    int64_t pending = 1, round = 0;
+    bucket[0].push_back(s);
+
+    // relax the light or the heavy arcs out of nodes[], improved heads go to out[]
+    auto relax_all = [&](const vector<int>& nodes, bool light) {
+        int F = nodes.size();
+        int grain = max<int>(256, F / (8 * pool.pool_size()) + 1);
+        out.resize((F + grain - 1) / grain);
+        parallel_for(
+            pool, 0, out.size(),
+            [&](int64_t c) {
+                auto& o = out[c];
+                for (int64_t j = c * grain, r = min<int64_t>(F, j + grain); j < r; j++) {
+                    int u = nodes[j];
+                    CostSum du = get(u);
+                    for (int i = g.off[u]; i < g.off[u + 1]; i++) {
+                        int v = g.to[i];
+                        if ((g.cost[i] <= delta) == light && relax(v, du + g.cost[i])) {
+                            o.push_back(v);
+                        }
+                    }
+                }
+            },
+            1);
+    };
+
+    for (int64_t b = 0; pending > 0; b++) {
+        auto& current = bucket[b % NB];
+        pending -= current.size(), round++;
+        frontier.clear(), settled.clear();
+        for (int u : current) {
+            if (int64_t(get(u) / delta) == b && in_frontier[u] != round) {
+                frontier.push_back(u), in_frontier[u] = round;
+            }
+        }
+        current.clear();
+
+        while (!frontier.empty()) {
+            for (int u : frontier) {
+                if (in_settled[u] != b) {
+                    settled.push_back(u), in_settled[u] = b;
+                }
+            }
+            relax_all(frontier, true);
+            frontier.clear(), round++;
+            for (auto& o : out) {
+                for (int v : o) {
+                    int64_t k = get(v) / delta;
+                    if (k == b) {
+                        if (in_frontier[v] != round) {
+                            frontier.push_back(v), in_frontier[v] = round;
+                        }
+                    } else {
+                        bucket[k % NB].push_back(v), pending++;
+                    }
+                }
+                o.clear();
+            }
+        }
+
+        relax_all(settled, false);
+        for (auto& o : out) {
+            for (int v : o) {
+                bucket[int64_t(get(v) / delta) % NB].push_back(v), pending++;
+            }
+            o.clear();
+        }
+    }
+
+    vector<CostSum> ans(V);
+    for (int u = 0; u < V; u++) {
+        ans[u] = get(u);
+    }
+    return ans;
+}
@@ -152,6 +152,22 @@ auto cycle_graph(int V) {
     return g;
 }
 
+// W×H grid, node (x,y) is y*W+x, with edges to the right and lower neighbours
+auto grid_graph(int W, int H) {
+    assert(W > 0 && H > 0);
+    edges_t g;
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            int u = y * W + x;
+            if (x + 1 < W)
+                g.push_back({u, u + 1});
+            if (y + 1 < H)
+                g.push_back({u, u + W});
+        }
+    }
+    return g;
+}
+
 auto complete_graph(int V) {
     assert(V > 0 && V <= 5000);
     edges_t g;
@@ -1,9 +1,8 @@
 #pragma once
 
-#include <bits/stdc++.h>
-using namespace std;
+#include "linear/matrix_multiply.hpp" // gemm, strassen_gemm
 
-// General matrix operations (no fast matrix multiplication).
+// General matrix operations, products go through the gemm kernels.
 // For gaussian algorithms T must be invertible
 template <typename T>
 struct mat {
@@ -94,13 +93,38 @@ struct mat {
         return a;
     }
 
+    // c = a·b reusing c's buffer if it has the right size, c must not alias a or b
+    friend void multiply_into(mat& c, const mat& a, const mat& b) {
+        assert(a.m == b.n && "Invalid proper matrix multiplication");
+        assert(c.data != a.data && c.data != b.data);
+        if (c.n * c.m != a.n * b.m) {
+            c.assign(a.n, b.m, T());
+        } else {
+            c.n = a.n, c.m = b.m, std::fill(c.data, c.data + c.n * c.m, T());
+        }
+        gemm(a.n, a.m, b.m, a.data, b.data, c.data);
+    }
+
     friend mat operator*(const mat& a, const mat& b) {
         assert(a.m == b.n && "Invalid proper matrix multiplication");
         mat c(a.n, b.m);
-        for (int i = 0; i < a.n; i++)
-            for (int k = 0; k < a.m; k++)
-                for (int j = 0; j < b.m; j++)
-                    c[i][j] += a[i][k] * b[k][j];
+        gemm(a.n, a.m, b.m, a.data, b.data, c.data);
+        return c;
+    }
+
+    // a·b with the rows of the product split over the pool
+    friend mat multiply(thread_pool& pool, const mat& a, const mat& b) {
+        assert(a.m == b.n && "Invalid proper matrix multiplication");
+        mat c(a.n, b.m);
+        gemm(pool, a.n, a.m, b.m, a.data, b.data, c.data);
+        return c;
+    }
+
+    // a·b for square matrices by Strassen's algorithm down to leaf×leaf blocks
+    friend mat strassen_multiply(const mat& a, const mat& b, int leaf = 256) {
+        assert(a.n == a.m && b.n == b.m && a.n == b.n && "Strassen operands not square");
+        mat c(a.n, a.n);
+        strassen_gemm(a.n, a.data, b.data, c.data, leaf);
         return c;
     }
 
@@ -113,14 +137,15 @@ struct mat {
         return c;
     }
 
+    // Squarings and products go into one scratch buffer that is swapped in, no allocs
     friend mat operator^(mat a, int64_t e) {
         assert(a.n == a.m && "Matrix exp operand is not square");
-        mat c = mat::identity(a.n);
+        mat c = mat::identity(a.n), tmp(a.n, a.n);
         while (e > 0) {
             if (e & 1)
-                c = c * a;
+                multiply_into(tmp, c, a), swap(c, tmp);
             if (e >>= 1)
-                a = a * a;
+                multiply_into(tmp, a, a), swap(a, tmp);
         }
         return c;
     }
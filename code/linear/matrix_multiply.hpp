@@ -0,0 +1,249 @@
+#pragma once
+
+#include "parallel/fork_join.hpp" // thread_pool, parallel_blocks
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+/**
+ * Matrix multiplication kernels on row-major arrays, C += A·B for A n×m and B m×p.
+ * gemm(n, m, p, A, B, C) picks one by the element type:
+ *
+ *   float/double: Goto-style blocked GEMM. A KC×NC block of B and an MC×KC block of A
+ *                 are packed into panels of NR columns and MR rows, and a register-tiled
+ *                 MR×NR micro-kernel (6×8 FMAs on 12 ymm accumulators for double with
+ *                 AVX2) runs over them, so B stays in L3, A in L2 and the panels in L1.
+ *   modnum-like:  types with a static mod() and a single u32 field n (modnum, dmodnum).
+ *                 Lazy reduction: products are accumulated in 64 bits and reduced once
+ *                 per chunk of k, as many as fit below 2^64, with 4 rows of C sharing
+ *                 each load of B. The inner loop is plain u64 multiply-adds.
+ *   otherwise:    the i-k-j loop.
+ *
+ * The thread_pool overloads split the rows of C into blocks, each multiplied separately.
+ * strassen_gemm(n, A, B, C, leaf) computes C = A·B for square matrices with Strassen's 7
+ * products down to leaf size, for exact types or when the error growth is acceptable.
+ */
+template <typename T, typename = void>
+struct gemm_lazy_mod_type : false_type {};
+template <typename T>
+struct gemm_lazy_mod_type<T, void_t<decltype(T::mod()), decltype(declval<T>().n)>>
+    : bool_constant<sizeof(T) == sizeof(uint32_t)> {};
+
+template <typename T>
+void gemm_naive(int n, int m, int p, const T* A, const T* B, T* C) {
+    for (int i = 0; i < n; i++)
+        for (int k = 0; k < m; k++)
+            for (int j = 0; j < p; j++)
+                C[i * p + j] += A[i * m + k] * B[k * p + j];
+}
+
+template <typename T>
+void gemm_lazy_mod(int n, int m, int p, const T* A, const T* B, T* C) {
+    using u64 = uint64_t;
+    constexpr int RB = 4, JB = 256;
+    const u64 mod = T::mod(), sq = max<u64>(1, (mod - 1) * (mod - 1));
+    const int chunk = min<u64>(max(m, 1), (~u64(0) - mod) / sq); // acc < mod + chunk·sq
+    assert(chunk >= 1);
+    u64 acc[RB][JB];
+
+    for (int j0 = 0; j0 < p; j0 += JB) {
+        int jb = min(JB, p - j0);
+        for (int i0 = 0; i0 < n; i0 += RB) {
+            int rb = min(RB, n - i0);
+            for (int r = 0; r < rb; r++)
+                for (int j = 0; j < jb; j++)
+                    acc[r][j] = C[(i0 + r) * p + j0 + j].n;
+
+            for (int k0 = 0; k0 < m; k0 += chunk) {
+                int k1 = min(m, k0 + chunk);
+                if (rb == RB) {
+                    for (int k = k0; k < k1; k++) {
+                        const T* b = B + k * p + j0;
+                        u64 a0 = A[i0 * m + k].n, a1 = A[(i0 + 1) * m + k].n;
+                        u64 a2 = A[(i0 + 2) * m + k].n, a3 = A[(i0 + 3) * m + k].n;
+                        for (int j = 0; j < jb; j++) {
+                            u64 v = b[j].n;
+                            acc[0][j] += a0 * v, acc[1][j] += a1 * v;
+                            acc[2][j] += a2 * v, acc[3][j] += a3 * v;
+                        }
+                    }
+                } else {
+                    for (int r = 0; r < rb; r++) {
+                        for (int k = k0; k < k1; k++) {
+                            const T* b = B + k * p + j0;
+                            u64 a = A[(i0 + r) * m + k].n;
+                            for (int j = 0; j < jb; j++)
+                                acc[r][j] += a * b[j].n;
+                        }
+                    }
+                }
+                for (int r = 0; r < rb; r++)
+                    for (int j = 0; j < jb; j++)
+                        acc[r][j] %= mod;
+            }
+
+            for (int r = 0; r < rb; r++)
+                for (int j = 0; j < jb; j++)
+                    C[(i0 + r) * p + j0 + j] = T(acc[r][j]);
+        }
+    }
+}
+
+constexpr int GEMM_MR = 6, GEMM_NR = 8, GEMM_MC = 96, GEMM_KC = 256, GEMM_NC = 2048;
+
+// c[0,mr)×[0,nr) += a·b for a packed kc×MR panel of A and a packed kc×NR panel of B
+template <typename T>
+void gemm_micro_kernel(int kc, const T* a, const T* b, T* c, int ldc, int mr, int nr) {
+    constexpr int MR = GEMM_MR, NR = GEMM_NR;
+    T tile[MR][NR] = {};
+#if defined(__AVX2__) && defined(__FMA__)
+    if constexpr (is_same_v<T, double>) {
+        __m256d acc[MR][2];
+        for (int r = 0; r < MR; r++)
+            acc[r][0] = acc[r][1] = _mm256_setzero_pd();
+        for (int k = 0; k < kc; k++, a += MR, b += NR) {
+            __m256d b0 = _mm256_loadu_pd(b), b1 = _mm256_loadu_pd(b + 4);
+            for (int r = 0; r < MR; r++) {
+                __m256d x = _mm256_broadcast_sd(a + r);
+                acc[r][0] = _mm256_fmadd_pd(x, b0, acc[r][0]);
+                acc[r][1] = _mm256_fmadd_pd(x, b1, acc[r][1]);
+            }
+        }
+        if (mr == MR && nr == NR) {
+            for (int r = 0; r < MR; r++) {
+                double *lo = c + r * ldc, *hi = lo + 4;
+                _mm256_storeu_pd(lo, _mm256_add_pd(_mm256_loadu_pd(lo), acc[r][0]));
+                _mm256_storeu_pd(hi, _mm256_add_pd(_mm256_loadu_pd(hi), acc[r][1]));
+            }
+            return;
+        }
+        for (int r = 0; r < MR; r++) {
+            _mm256_storeu_pd(tile[r], acc[r][0]);
+            _mm256_storeu_pd(tile[r] + 4, acc[r][1]);
+        }
+    } else
+#endif
+    {
+        for (int k = 0; k < kc; k++, a += MR, b += NR)
+            for (int r = 0; r < MR; r++)
+                for (int j = 0; j < NR; j++)
+                    tile[r][j] += a[r] * b[j];
+    }
+    for (int r = 0; r < mr; r++)
+        for (int j = 0; j < nr; j++)
+            c[r * ldc + j] += tile[r][j];
+}
+
+template <typename T>
+void gemm_packed(int n, int m, int p, const T* A, const T* B, T* C) {
+    constexpr int MR = GEMM_MR, NR = GEMM_NR, MC = GEMM_MC, KC = GEMM_KC, NC = GEMM_NC;
+    vector<T> Ap(MC * KC), Bp(KC * (NC + NR));
+
+    for (int jc = 0; jc < p; jc += NC) {
+        int nc = min(NC, p - jc);
+        for (int pc = 0; pc < m; pc += KC) {
+            int kc = min(KC, m - pc);
+            for (int jr = 0; jr < nc; jr += NR) { // B panels, kc×NR each, zero padded
+                T* panel = Bp.data() + jr * kc;
+                const T* b = B + pc * p + jc + jr;
+                for (int k = 0; k < kc; k++)
+                    for (int j = 0; j < NR; j++)
+                        panel[k * NR + j] = jr + j < nc ? b[k * p + j] : T();
+            }
+            for (int ic = 0; ic < n; ic += MC) {
+                int mc = min(MC, n - ic);
+                for (int ir = 0; ir < mc; ir += MR) { // A panels, kc×MR each
+                    T* panel = Ap.data() + ir * kc;
+                    const T* a = A + (ic + ir) * m + pc;
+                    for (int k = 0; k < kc; k++)
+                        for (int r = 0; r < MR; r++)
+                            panel[k * MR + r] = ir + r < mc ? a[r * m + k] : T();
+                }
+                for (int jr = 0; jr < nc; jr += NR) {
+                    for (int ir = 0; ir < mc; ir += MR) {
+                        T* c = C + (ic + ir) * p + jc + jr;
+                        gemm_micro_kernel(kc, Ap.data() + ir * kc, Bp.data() + jr * kc, c,
+                                          p, min(MR, mc - ir), min(NR, nc - jr));
+                    }
+                }
+            }
+        }
+    }
+}
+
+// C += A·B, A n×m and B m×p
+template <typename T>
+void gemm(int n, int m, int p, const T* A, const T* B, T* C) {
+    if constexpr (is_floating_point_v<T>) {
+        gemm_packed(n, m, p, A, B, C);
+    } else if constexpr (gemm_lazy_mod_type<T>::value) {
+        gemm_lazy_mod(n, m, p, A, B, C);
+    } else {
+        gemm_naive(n, m, p, A, B, C);
+    }
+}
+
+template <typename T>
+void gemm(thread_pool& pool, int n, int m, int p, const T* A, const T* B, T* C) {
+    int rows = max(GEMM_MC, n / (4 * pool.pool_size()) / GEMM_MC * GEMM_MC);
+    parallel_blocks(
+        pool, 0, n,
+        [&](int64_t l, int64_t r) {
+            gemm(int(r - l), m, p, A + l * m, B, C + l * p);
+        },
+        rows);
+}
+
+// C = A·B for square n×n matrices, Strassen down to leaf size then gemm
+template <typename T>
+void strassen_gemm(int n, const T* A, const T* B, T* C, int leaf = 256) {
+    if (n <= leaf) {
+        fill(C, C + n * n, T());
+        gemm(n, n, n, A, B, C);
+        return;
+    }
+    int h = (n + 1) / 2, H = h * h; // quadrants of size h, zero padded for odd n
+    vector<T> buf(17 * H); // 8 quadrants, s, t and m1..m7
+    T *a11 = &buf[0], *a12 = a11 + H, *a21 = a12 + H, *a22 = a21 + H;
+    T *b11 = a22 + H, *b12 = b11 + H, *b21 = b12 + H, *b22 = b21 + H;
+    T *s = b22 + H, *t = s + H, *m1 = t + H, *m2 = m1 + H, *m3 = m2 + H, *m4 = m3 + H;
+    T *m5 = m4 + H, *m6 = m5 + H, *m7 = m6 + H;
+    auto split = [&](const T* X, T* x11, T* x12, T* x21, T* x22) {
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                T* q = i < h ? (j < h ? x11 : x12) : (j < h ? x21 : x22);
+                q[(i % h) * h + j % h] = X[i * n + j];
+            }
+        }
+    };
+    split(A, a11, a12, a21, a22), split(B, b11, b12, b21, b22);
+    auto add = [&](const T* x, const T* y, T* z) {
+        for (int i = 0; i < H; i++)
+            z[i] = x[i] + y[i];
+    };
+    auto sub = [&](const T* x, const T* y, T* z) {
+        for (int i = 0; i < H; i++)
+            z[i] = x[i] - y[i];
+    };
+    add(a11, a22, s), add(b11, b22, t), strassen_gemm(h, s, t, m1, leaf);
+    add(a21, a22, s), strassen_gemm(h, s, b11, m2, leaf);
+    sub(b12, b22, t), strassen_gemm(h, a11, t, m3, leaf);
+    sub(b21, b11, t), strassen_gemm(h, a22, t, m4, leaf);
+    add(a11, a12, s), strassen_gemm(h, s, b22, m5, leaf);
+    sub(a21, a11, s), add(b11, b12, t), strassen_gemm(h, s, t, m6, leaf);
+    sub(a12, a22, s), add(b21, b22, t), strassen_gemm(h, s, t, m7, leaf);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            int q = (i % h) * h + j % h;
+            if (i < h && j < h) {
+                C[i * n + j] = m1[q] + m4[q] - m5[q] + m7[q];
+            } else if (i < h) {
+                C[i * n + j] = m3[q] + m5[q];
+            } else if (j < h) {
+                C[i * n + j] = m2[q] + m4[q];
+            } else {
+                C[i * n + j] = m1[q] - m2[q] + m3[q] + m6[q];
+            }
+        }
+    }
+}
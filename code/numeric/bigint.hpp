@@ -2,10 +2,16 @@
 
 #include "hash.hpp"
 #include "numeric/int128.hpp"
+#include "numeric/fft.hpp"      // ntt_multiply
+#include "algo/y_combinator.hpp" // y_combinator
 
 /**
  * Bigint number over base 2^32
- * No Karatsuba multiplication yet unfortunately
+ * Multiplication is tiered on the length in limbs of the shorter operand: schoolbook,
+ * Karatsuba, Toom-3, then a three-prime NTT; operands of uneven length are multiplied
+ * in blocks. Each tier is also callable on its own (mul_schoolbook, mul_karatsuba, ...).
+ * Long division switches to a Newton reciprocal for long divisors and quotients, and
+ * base conversion of long numbers splits by powers of the base (divide and conquer).
  */
 struct bigint {
     using cint = uint32_t;
@@ -14,6 +20,12 @@ struct bigint {
     static constexpr cint CMAX = UINT32_MAX;
     static constexpr lint LMAX = UINT64_MAX;
 
+    static constexpr int KARATSUBA_THRESHOLD = 32;
+    static constexpr int TOOM3_THRESHOLD = 160;
+    static constexpr int NTT_THRESHOLD = 400;
+    static constexpr int NEWTON_THRESHOLD = 2000;
+    static constexpr int CONVERSION_THRESHOLD = 200;
+
     nums_vec nums;
     bool sign = 0; // 0=positive, 1=negative
 
@@ -26,8 +38,15 @@ struct bigint {
             i++; // skip whitespace
         bool neg = i < S && s[i] == '-', pos = i < S && s[i] == '+';
         i += neg || pos, sign = neg;
+        int j = i;
+        while (j < S && ('0' <= s[j] && s[j] < char('0' + b)))
+            j++;
+        if (j - i > 9 * CONVERSION_THRESHOLD) {
+            *this = parse_digits(s, i, j, b), sign = neg && !zero();
+            return;
+        }
         cint n = 0, tens = 1, threshold = CMAX / (b + 1);
-        while (i < S && ('0' <= s[i] && s[i] < char('0' + b))) {
+        while (i < j) {
             n = b * n + cint(s[i++] - '0');
             tens *= b;
             if (tens >= threshold) {
@@ -76,6 +95,201 @@ struct bigint {
         sign = sign && !zero();
     }
 
+    static bigint from_limbs(const cint* a, int n) {
+        bigint c;
+        c.nums.assign(a, a + n);
+        c.trim();
+        return c;
+    }
+
+    // Largest power of b that fits a limb, and its exponent
+    static pair<cint, int> base_chunk(cint b) {
+        cint divisor = b, digits = 1;
+        while (divisor < CMAX / b) {
+            divisor *= b, digits++;
+        }
+        return {divisor, digits};
+    }
+
+    // Value of digits s[i,j) in base b. Chunks of digits are paired bottom up, at level l
+    // by multiplying the upper one by the l-th square of the chunk base.
+    static bigint parse_digits(const string& s, int i, int j, cint b) {
+        auto [divisor, digits] = base_chunk(b);
+        vector<bigint> x;
+        for (int r = j; r > i; r -= digits) {
+            cint n = 0;
+            for (int k = max(i, r - digits); k < r; k++) {
+                n = b * n + cint(s[k] - '0');
+            }
+            x.push_back(bigint(n));
+        }
+        bigint pw = divisor;
+        while (x.size() > 1u) {
+            int X = x.size();
+            for (int k = 0; 2 * k < X; k++) {
+                x[k] = 2 * k + 1 < X ? x[2 * k] + x[2 * k + 1] * pw : move(x[2 * k]);
+            }
+            x.resize((X + 1) / 2);
+            if (x.size() > 1u) {
+                pw = pw * pw;
+            }
+        }
+        return x.empty() ? bigint() : move(x[0]);
+    }
+
+    // Digits of u in base b without sign, "" for zero, quadratic
+    static string digits_small(bigint u, cint b) {
+        static auto uint_to_string = [](cint n, cint base) {
+            string s;
+            while (n > 0) {
+                cint m = n / base;
+                s += '0' + (n - base * m), n = m;
+            }
+            reverse(begin(s), end(s));
+            return s;
+        };
+
+        auto [divisor, digits] = base_chunk(b);
+        vector<string> rems;
+        while (!u.zero()) {
+            rems.push_back(uint_to_string(div_int(u, divisor), b));
+        }
+        string s;
+        for (int i = 0, n = rems.size(); i < n; i++) {
+            string pad(i ? digits - rems[n - i - 1].length() : 0, '0');
+            s += pad + rems[n - i - 1];
+        }
+        return s;
+    }
+
+    // c[0,n+m) = a[0,n) * b[0,m)
+    static void schoolbook_limbs(const cint* a, int n, const cint* b, int m, cint* c) {
+        fill_n(c, n + m, 0);
+        for (int j = 0; j < m; j++) {
+            lint k = 0;
+            for (int i = 0; i < n; i++) {
+                lint t = lint(a[i]) * b[j] + c[i + j] + k;
+                c[i + j] = t, k = t >> 32;
+            }
+            c[n + j] = k;
+        }
+    }
+
+    // a[0,n) += b[0,m) for n >= m, returns the carry out
+    static cint add_limbs(cint* a, int n, const cint* b, int m) {
+        lint k = 0;
+        for (int i = 0; i < m; i++) {
+            k += lint(a[i]) + b[i], a[i] = k, k >>= 32;
+        }
+        for (int i = m; k && i < n; i++) {
+            k += a[i], a[i] = k, k >>= 32;
+        }
+        return k;
+    }
+
+    // a[0,n) -= b[0,m) for n >= m, returns the borrow out
+    static cint sub_limbs(cint* a, int n, const cint* b, int m) {
+        lint k = 0;
+        for (int i = 0; i < m; i++) {
+            lint t = lint(a[i]) - b[i] - k;
+            a[i] = t, k = t >> 63;
+        }
+        for (int i = m; k && i < n; i++) {
+            k = a[i] == 0, a[i]--;
+        }
+        return k;
+    }
+
+    // c[0,2n) = a[0,n) * b[0,n), with scratch t of 4n+256 limbs
+    static void karatsuba_limbs(const cint* a, const cint* b, int n, cint* c, cint* t) {
+        if (n < KARATSUBA_THRESHOLD) {
+            return schoolbook_limbs(a, n, b, n, c);
+        }
+        int lo = n / 2, hi = n - lo;
+        cint *sa = t, *sb = t + (hi + 1), *z = t + 2 * (hi + 1), *rest = z + 2 * (hi + 1);
+        copy_n(a + lo, hi, sa), sa[hi] = add_limbs(sa, hi, a, lo);
+        copy_n(b + lo, hi, sb), sb[hi] = add_limbs(sb, hi, b, lo);
+        karatsuba_limbs(a, b, lo, c, rest);
+        karatsuba_limbs(a + lo, b + lo, hi, c + 2 * lo, rest);
+        karatsuba_limbs(sa, sb, hi + 1, z, rest);
+        sub_limbs(z, 2 * hi + 2, c, 2 * lo);
+        sub_limbs(z, 2 * hi + 2, c + 2 * lo, 2 * hi);
+        add_limbs(c + lo, 2 * n - lo, z, min(2 * hi + 2, 2 * n - lo));
+    }
+
+    // |u*v| for n >= m, blocks of m limbs of u times v with balanced(), the last with *
+    template <typename Fn>
+    static bigint mul_blocks(const bigint& u, const bigint& v, Fn&& balanced) {
+        int n = u.len(), m = v.len();
+        bigint c;
+        c.nums.assign(n + m + 1, 0);
+        for (int i = 0; i < n; i += m) {
+            int k = min(m, n - i);
+            bigint block = from_limbs(u.nums.data() + i, k), p;
+            if (k == m) {
+                p = balanced(block, v);
+            } else {
+                p = mul_vec(block, v);
+            }
+            add_limbs(c.nums.data() + i, n + m + 1 - i, p.nums.data(), p.len());
+        }
+        c.trim();
+        return c;
+    }
+
+    // |u*v| for u, v of up to n limbs
+    static bigint karatsuba_balanced(const bigint& u, const bigint& v) {
+        int n = max(u.len(), v.len());
+        nums_vec a(u.nums), b(v.nums), t(4 * n + 256);
+        a.resize(n, 0), b.resize(n, 0);
+        bigint c;
+        c.nums.resize(2 * n);
+        karatsuba_limbs(a.data(), b.data(), n, c.nums.data(), t.data());
+        c.trim();
+        return c;
+    }
+
+    // |u*v| for u, v of up to n limbs: 5 products of n/3 limbs, Bodrato's interpolation
+    static bigint toom3_balanced(const bigint& u, const bigint& v) {
+        int n = max(u.len(), v.len()), k = (n + 2) / 3;
+        auto piece = [&](const bigint& x, int i) {
+            int l = min(i * k, x.len()), r = min(l + k, x.len());
+            return from_limbs(x.nums.data() + l, r - l);
+        };
+        bigint u0 = piece(u, 0), u1 = piece(u, 1), u2 = piece(u, 2);
+        bigint v0 = piece(v, 0), v1 = piece(v, 1), v2 = piece(v, 2);
+
+        bigint p = u0 + u2, q = v0 + v2;
+        bigint p1 = p + u1, q1 = q + v1, pm1 = p - u1, qm1 = q - v1;
+        bigint pm2 = ((pm1 + u2) << 1) - u0, qm2 = ((qm1 + v2) << 1) - v0;
+
+        bigint r0 = u0 * v0, r1 = p1 * q1, rm1 = pm1 * qm1, rm2 = pm2 * qm2, r4 = u2 * v2;
+        bigint r3 = (rm2 - r1) / 3;
+        r1 = (r1 - rm1) >> 1;
+        bigint r2 = rm1 - r0;
+        r3 = ((r2 - r3) >> 1) + (r4 << 1);
+        r2 += r1 - r4;
+        r1 -= r3;
+
+        bigint c;
+        c.nums.assign(2 * n + 2 * k + 1, 0);
+        const bigint* rs[] = {&r0, &r1, &r2, &r3, &r4};
+        for (int i = 0; i < 5; i++) {
+            assert(rs[i]->sign == 0);
+            int at = i * k, C = c.len();
+            add_limbs(c.nums.data() + at, C - at, rs[i]->nums.data(), rs[i]->len());
+        }
+        c.trim();
+        return c;
+    }
+
+    // Three NTT primes with P0*P1*P2 > 2^85, so products of up to 2^21 limbs are exact
+    static constexpr uint32_t NTT_P0 = 754974721, NTT_P1 = 167772161, NTT_P2 = 469762049;
+
+    static bool ntt_fits(int n, int m) {
+        return min(n, m) <= (1 << 21) && n + m - 1 <= (1 << 24);
+    }
+
   public:
     auto& operator[](cint x) { return nums[x]; }
     const auto& operator[](cint x) const { return nums[x]; }
@@ -351,25 +565,81 @@ struct bigint {
             assert(k == 0);
         }
     }
-    friend bigint mul_vec(const bigint& u, const bigint& v) {
+    friend bigint mul_schoolbook(const bigint& u, const bigint& v) {
         if (u.zero() || v.zero())
             return 0;
-        int n = u.len(), m = v.len();
         bigint c;
-        c.nums.resize(n + m, 0);
+        c.nums.resize(u.len() + v.len());
+        schoolbook_limbs(u.nums.data(), u.len(), v.nums.data(), v.len(), c.nums.data());
         c.sign = u.sign ^ v.sign;
-        for (int j = 0; j < m; j++) {
-            cint k = 0;
-            for (int i = 0; i < n; i++) {
-                lint t = lint(u[i]) * v[j] + c[i + j] + k;
-                c[i + j] = t & CMAX;
-                k = t >> 32;
-            }
-            c[n + j] = k;
+        c.trim();
+        return c;
+    }
+    friend bigint mul_karatsuba(const bigint& u, const bigint& v) {
+        if (u.zero() || v.zero())
+            return 0;
+        bigint c = u.len() >= v.len() ? mul_blocks(u, v, karatsuba_balanced)
+                                       : mul_blocks(v, u, karatsuba_balanced);
+        c.sign = u.sign ^ v.sign;
+        return c;
+    }
+    friend bigint mul_toom3(const bigint& u, const bigint& v) {
+        if (u.zero() || v.zero())
+            return 0;
+        bigint c = u.len() >= v.len() ? mul_blocks(u, v, toom3_balanced)
+                                       : mul_blocks(v, u, toom3_balanced);
+        c.sign = u.sign ^ v.sign;
+        return c;
+    }
+    friend bigint mul_ntt(const bigint& u, const bigint& v) {
+        if (u.zero() || v.zero())
+            return 0;
+        constexpr uint32_t P0 = NTT_P0, P1 = NTT_P1, P2 = NTT_P2;
+        int n = u.len(), m = v.len(), S = n + m - 1;
+        assert(ntt_fits(n, m));
+
+        auto residues = [&](auto prime) {
+            constexpr uint32_t P = decltype(prime)::value;
+            vector<modnum<P>> a(begin(u.nums), end(u.nums));
+            vector<modnum<P>> b(begin(v.nums), end(v.nums));
+            auto c = fft::ntt_multiply(a, b);
+            c.resize(S);
+            return c;
+        };
+        auto r0 = residues(integral_constant<uint32_t, P0>{});
+        auto r1 = residues(integral_constant<uint32_t, P1>{});
+        auto r2 = residues(integral_constant<uint32_t, P2>{});
+
+        // Garner: x = r0 + P0*t1 + P0*P1*t2 < 2^86, then carry along the limbs
+        static const auto inv0 = modnum<P1>(P0).inv();
+        static const auto inv01 = modnum<P2>(uint64_t(P0) * P1).inv();
+        bigint c;
+        c.nums.resize(n + m);
+        __uint128_t k = 0;
+        for (int i = 0; i < S; i++) {
+            auto t1 = (modnum<P1>(r1[i].n) - modnum<P1>(r0[i].n)) * inv0;
+            auto t2 = (r2[i] - modnum<P2>(r0[i].n) - modnum<P2>(uint64_t(P0) * t1.n)) *
+                      inv01;
+            k += r0[i].n + __uint128_t(P0) * t1.n + __uint128_t(uint64_t(P0) * P1) * t2.n;
+            c[i] = cint(k), k >>= 32;
         }
+        c[S] = cint(k);
+        c.sign = u.sign ^ v.sign;
         c.trim();
         return c;
     }
+    friend bigint mul_vec(const bigint& u, const bigint& v) {
+        int m = min(u.len(), v.len());
+        if (m < KARATSUBA_THRESHOLD) {
+            return mul_schoolbook(u, v);
+        } else if (m < TOOM3_THRESHOLD) {
+            return mul_karatsuba(u, v);
+        } else if (m < NTT_THRESHOLD || !ntt_fits(u.len(), v.len())) {
+            return mul_toom3(u, v);
+        } else {
+            return mul_ntt(u, v);
+        }
+    }
     friend bigint div_vec(bigint& u, bigint v) {
         constexpr lint b = 1L + CMAX;
         assert(!v.zero());
@@ -424,6 +694,52 @@ struct bigint {
         swap(u, d);
         return d;
     }
+    // floor(B^2p / w) for w of p limbs with the top bit set. The reciprocal of the top
+    // half of w gives p/2 limbs, one Newton step doubles them, then it is made exact.
+    static bigint reciprocal(const bigint& w, int p) {
+        if (p <= NEWTON_THRESHOLD / 2) {
+            bigint x;
+            x.nums.assign(2 * p + 1, 0), x.nums[2 * p] = 1;
+            div_vec(x, w);
+            return x;
+        }
+        int h = (p + 1) / 2;
+        bigint x = reciprocal(w >> (32 * (p - h)), h) << (32 * (p - h));
+        bigint e = (bigint(1) << (64 * p)) - w * x;
+        bigint d = (x * e) >> (64 * p);
+        x += d, e -= w * d;
+        while (e.sign) {
+            x -= 1, e += w;
+        }
+        while (e >= w) {
+            x += 1, e -= w;
+        }
+        return x;
+    }
+    // Same as div_vec, with one multiplication by the Newton reciprocal of v
+    friend bigint div_newton(bigint& u, bigint v) {
+        assert(!v.zero());
+        bool su = u.sign, sv = v.sign;
+        u.sign = v.sign = 0;
+
+        // pad v to p limbs, at least the length of the quotient, so that u < B^2p
+        int n = v.len(), m = u.len(), p = max(n, m - n + 1);
+        cint shift = 32 * (p - n) + __builtin_clz(v[n - 1]);
+        u <<= shift, v <<= shift;
+        assert(v.len() == p && u.len() <= 2 * p);
+
+        bigint x = reciprocal(v, p);
+        bigint q = (u * x) >> (64 * p);
+        bigint r = u - q * v;
+        while (r >= v) {
+            q += 1, r -= v;
+        }
+
+        r >>= shift;
+        q.sign = (su ^ sv) && !q.zero(), r.sign = su && !r.zero();
+        u = move(q);
+        return r;
+    }
     friend bigint div_mod(bigint& u, const bigint& v) {
         bigint r;
         if (magnitude_cmp(u, v)) {
@@ -432,6 +748,8 @@ struct bigint {
         } else if (v.len() == 1) {
             r = bigint(div_int(u, v[0]), u.sign);
             u.sign ^= v.sign, r.sign &= !r.zero();
+        } else if (min(v.len(), u.len() - v.len()) >= NEWTON_THRESHOLD) {
+            r = div_newton(u, v);
         } else {
             r = div_vec(u, v);
         }
@@ -567,31 +885,33 @@ struct bigint {
     }
 
     friend string to_string(bigint u, cint b = 10) {
-        static auto uint_to_string = [](cint n, cint base) {
-            string s;
-            while (n > 0) {
-                cint m = n / base;
-                s += '0' + (n - base * m), n = m;
-            }
-            reverse(begin(s), end(s));
-            return s;
-        };
-
         if (u.zero())
             return "0";
         string s = u.sign ? "-" : "";
-        vector<string> rems;
-        cint divisor = b, digits = 1;
-        while (divisor < CMAX / b) {
-            divisor *= b, digits++;
+        u.sign = 0;
+        if (u.len() <= CONVERSION_THRESHOLD) {
+            return s + digits_small(move(u), b);
         }
-        while (!u.zero()) {
-            rems.push_back(uint_to_string(div_int(u, divisor), b));
-        }
-        for (int i = 0, n = rems.size(); i < n; i++) {
-            string pad(i ? digits - rems[n - i - 1].length() : 0, '0');
-            s += pad + rems[n - i - 1];
+
+        // split x < pw[j+1] into x / pw[j] and x % pw[j], the latter padded with zeros
+        auto [divisor, digits] = base_chunk(b);
+        vector<bigint> pw = {bigint(divisor)};
+        while (!magnitude_cmp(u, pw.back())) {
+            pw.push_back(pw.back() * pw.back());
         }
+        y_combinator([&](auto self, bigint x, int j, int64_t width) -> void {
+            if (j < 0 || x.len() <= CONVERSION_THRESHOLD) {
+                auto t = digits_small(move(x), b);
+                s += string(max<int64_t>(0, width - int64_t(t.size())), '0') + t;
+            } else if (width == 0 && magnitude_cmp(x, pw[j])) {
+                self(move(x), j - 1, 0); // leading part, no zero padding
+            } else {
+                int64_t lower = int64_t(digits) << j;
+                bigint r = div_mod(x, pw[j]);
+                self(move(x), j - 1, max<int64_t>(0, width - lower));
+                self(move(r), j - 1, lower);
+            }
+        })(move(u), int(pw.size()) - 2, 0);
         return s;
     }
 
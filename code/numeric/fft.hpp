@@ -1,6 +1,9 @@
 #pragma once
 
 #include "numeric/modnum.hpp"
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
 
 // Base include with my_complex, reverse/root/scratch caches, naive mult, fft_transform
 namespace fft {
@@ -8,6 +11,7 @@ namespace fft {
 template <typename T>
 struct my_complex {
     using self = my_complex<T>;
+    using value_type = T;
     T x, y;
     constexpr my_complex(T x = T(0), T y = T(0)) : x(x), y(y) {}
 
@@ -54,6 +58,16 @@ struct my_complex {
 using default_complex = my_complex<double>;
 constexpr double TAU = 6.283185307179586476925286766559;
 
+// Define FFT_COUNT_TRANSFORMS to count fft_transform and ntt_montgomery_transform calls
+#ifdef FFT_COUNT_TRANSFORMS
+inline atomic<int64_t> fft_transform_count = 0;
+inline void fft_count_transform() {
+    fft_transform_count.fetch_add(1, memory_order_relaxed);
+}
+#else
+inline void fft_count_transform() {}
+#endif
+
 int next_two(int32_t N) { return N > 1 ? 8 * sizeof(N) - __builtin_clz(N - 1) : 0; }
 
 template <typename T, typename D>
@@ -155,6 +169,7 @@ template <bool inverse, bool standard = true, typename T>
 void fft_transform(vector<T>& a, int N) {
     // With standard=true, reverse bits at start and end of forward transform.
     // With standard=false, reverse bits at start of forward and backward transform.
+    fft_count_transform();
     if constexpr (!standard || !inverse) {
         fft_bit_reverse(a, N);
     }
@@ -199,7 +214,7 @@ void fft_doubling_inplace(vector<T>& a, int N) {
 
 } // namespace fft
 
-// NTT with modnums | 60,125,270ms for 250K,500K,1M
+// NTT with modnums | 25,50,90ms for 250K,500K,1M
 namespace fft {
 
 template <uint32_t MOD>
@@ -264,6 +279,353 @@ struct root_of_unity<modnum<MOD>> {
     }
 };
 
+/**
+ * Montgomery NTT for primes MOD < 2^30 (998244353, 469762049, 167772161, ...)
+ * Forward is decimation in frequency from natural order to bit-reversed order, inverse is
+ * decimation in time from bit-reversed order back to natural order, so there is no bit
+ * reversal pass at all, and pointwise products don't care about the order.
+ * Both go two levels at a time (radix-4) with a radix-2 level if log N is odd. Within a
+ * block all butterflies share the same twiddles, so the inner loop is a plain strided
+ * loop over u32 lanes, done 8 at a time with AVX2 if available at compile time.
+ * Everything is lazily reduced in [0,2MOD), so the transform never divides.
+ */
+template <uint32_t MOD>
+struct ntt_lanes1 {
+    using M = montgomery<MOD>;
+    using V = uint32_t;
+    static constexpr int W = 1;
+    static V load(const uint32_t* p) { return *p; }
+    static void store(uint32_t* p, V x) { *p = x; }
+    static V set1(uint32_t x) { return x; }
+    static V add(V a, V b) { return a + b; }
+    static V sub(V a, V b) { return a - b; }
+    static V mul(V a, V b) { return M::mul(a, b); }
+    static V shrink(V a) { return M::shrink(a); }
+};
+
+#ifdef __AVX2__
+template <uint32_t MOD>
+struct ntt_lanes8 {
+    using V = __m256i;
+    static constexpr int W = 8;
+    static V load(const uint32_t* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+    static void store(uint32_t* p, V x) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x);
+    }
+    static V set1(uint32_t x) { return _mm256_set1_epi32(x); }
+    static V add(V a, V b) { return _mm256_add_epi32(a, b); }
+    static V sub(V a, V b) { return _mm256_sub_epi32(a, b); }
+    static V shrink(V a) { return _mm256_min_epu32(a, sub(a, set1(2 * MOD))); }
+    static V mul(V a, V b) {
+        // 32x32->64 products of even and odd lanes, then reduce both like montgomery<>
+        const V mod = set1(MOD), inv = set1(montgomery<MOD>::INV);
+        V pe = _mm256_mul_epu32(a, b);
+        V po = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+        V qe = _mm256_mul_epu32(_mm256_mul_epu32(pe, inv), mod);
+        V qo = _mm256_mul_epu32(_mm256_mul_epu32(po, inv), mod);
+        V hi = _mm256_blend_epi32(_mm256_srli_epi64(pe, 32), po, 0b10101010);
+        V qhi = _mm256_blend_epi32(_mm256_srli_epi64(qe, 32), qo, 0b10101010);
+        return add(sub(hi, qhi), mod);
+    }
+};
+#endif
+
+template <uint32_t MOD>
+struct ntt_montgomery_roots {
+    using M = montgomery<MOD>;
+    static constexpr int rank2 = __builtin_ctz(MOD - 1);
+    static inline uint32_t imag, iimag, root[rank2 + 1], iroot[rank2 + 1];
+    static inline uint32_t rate2[rank2 + 1], irate2[rank2 + 1];
+    static inline uint32_t rate3[rank2 + 1], irate3[rank2 + 1];
+
+    static void init() {
+        static const bool done = build();
+        assert(done);
+    }
+
+    static uint32_t pow(uint32_t x, int e) {
+        uint32_t y = M::R1;
+        for (; e > 0; e >>= 1, x = M::mul(x, x)) {
+            if (e & 1)
+                y = M::mul(y, x);
+        }
+        return y;
+    }
+
+    static bool build() {
+        using T = modnum<MOD>;
+        T root[rank2 + 1], iroot[rank2 + 1];
+        root[rank2] = root_of_unity<T>::get(1 << rank2), iroot[rank2] = root[rank2].inv();
+        for (int i = rank2 - 1; i >= 0; i--) {
+            root[i] = root[i + 1] * root[i + 1];
+            iroot[i] = iroot[i + 1] * iroot[i + 1];
+        }
+        for (int i = 0; i <= rank2; i++) {
+            ntt_montgomery_roots::root[i] = M::to(root[i].n);
+            ntt_montgomery_roots::iroot[i] = M::to(iroot[i].n);
+        }
+        T prod = 1, iprod = 1;
+        for (int i = 0; i + 2 <= rank2; i++) {
+            rate2[i] = M::to((root[i + 2] * prod).n);
+            irate2[i] = M::to((iroot[i + 2] * iprod).n);
+            prod *= iroot[i + 2], iprod *= root[i + 2];
+        }
+        prod = iprod = 1;
+        for (int i = 0; i + 3 <= rank2; i++) {
+            rate3[i] = M::to((root[i + 3] * prod).n);
+            irate3[i] = M::to((iroot[i + 3] * iprod).n);
+            prod *= iroot[i + 3], iprod *= root[i + 3];
+        }
+        imag = M::to(root[2].n), iimag = M::to(iroot[2].n);
+        return true;
+    }
+};
+
+template <typename L, uint32_t MOD>
+void ntt_dif_radix4(uint32_t* a, int p, int n, uint32_t rot, uint32_t imag) {
+    using M = montgomery<MOD>;
+    auto m2 = L::set1(M::MOD2), im = L::set1(imag);
+    auto rot2 = M::mul(rot, rot), rot3 = M::mul(rot2, rot);
+    auto r1 = L::set1(rot), r2 = L::set1(rot2), r3 = L::set1(rot3);
+    for (int i = 0; i < n; i += L::W) {
+        auto a0 = L::load(a + i);
+        auto a1 = L::mul(L::load(a + i + p), r1);
+        auto a2 = L::mul(L::load(a + i + 2 * p), r2);
+        auto a3 = L::mul(L::load(a + i + 3 * p), r3);
+        auto s02 = L::shrink(L::add(a0, a2));
+        auto d02 = L::shrink(L::add(a0, L::sub(m2, a2)));
+        auto s13 = L::shrink(L::add(a1, a3));
+        auto d13 = L::mul(L::shrink(L::add(a1, L::sub(m2, a3))), im);
+        L::store(a + i, L::shrink(L::add(s02, s13)));
+        L::store(a + i + p, L::shrink(L::add(s02, L::sub(m2, s13))));
+        L::store(a + i + 2 * p, L::shrink(L::add(d02, d13)));
+        L::store(a + i + 3 * p, L::shrink(L::add(d02, L::sub(m2, d13))));
+    }
+}
+
+template <typename L, uint32_t MOD>
+void ntt_dif_radix2(uint32_t* a, int p, int n, uint32_t rot) {
+    using M = montgomery<MOD>;
+    auto m2 = L::set1(M::MOD2), r1 = L::set1(rot);
+    for (int i = 0; i < n; i += L::W) {
+        auto l = L::load(a + i), r = L::mul(L::load(a + i + p), r1);
+        L::store(a + i, L::shrink(L::add(l, r)));
+        L::store(a + i + p, L::shrink(L::add(l, L::sub(m2, r))));
+    }
+}
+
+template <typename L, uint32_t MOD>
+void ntt_dit_radix4(uint32_t* a, int p, int n, uint32_t irot, uint32_t iimag) {
+    using M = montgomery<MOD>;
+    auto m2 = L::set1(M::MOD2), im = L::set1(iimag);
+    auto irot2 = M::mul(irot, irot), irot3 = M::mul(irot2, irot);
+    auto r1 = L::set1(irot), r2 = L::set1(irot2), r3 = L::set1(irot3);
+    for (int i = 0; i < n; i += L::W) {
+        auto a0 = L::load(a + i), a1 = L::load(a + i + p);
+        auto a2 = L::load(a + i + 2 * p), a3 = L::load(a + i + 3 * p);
+        auto s01 = L::shrink(L::add(a0, a1));
+        auto d01 = L::shrink(L::add(a0, L::sub(m2, a1)));
+        auto s23 = L::shrink(L::add(a2, a3));
+        auto d23 = L::mul(L::shrink(L::add(a2, L::sub(m2, a3))), im);
+        L::store(a + i, L::shrink(L::add(s01, s23)));
+        L::store(a + i + p, L::mul(L::shrink(L::add(d01, d23)), r1));
+        L::store(a + i + 2 * p, L::mul(L::shrink(L::add(s01, L::sub(m2, s23))), r2));
+        L::store(a + i + 3 * p, L::mul(L::shrink(L::add(d01, L::sub(m2, d23))), r3));
+    }
+}
+
+template <typename L, uint32_t MOD>
+void ntt_dit_radix2(uint32_t* a, int p, int n, uint32_t irot) {
+    using M = montgomery<MOD>;
+    auto m2 = L::set1(M::MOD2), r1 = L::set1(irot);
+    for (int i = 0; i < n; i += L::W) {
+        auto l = L::load(a + i), r = L::load(a + i + p);
+        L::store(a + i, L::shrink(L::add(l, r)));
+        L::store(a + i + p, L::mul(L::shrink(L::add(l, L::sub(m2, r))), r1));
+    }
+}
+
+// Call fn(L{}) with the widest lanes L that fit in blocks of p elements
+template <uint32_t MOD, typename Fn>
+void ntt_lanes_dispatch([[maybe_unused]] int p, Fn&& fn) {
+#ifdef __AVX2__
+    if (p >= 8) {
+        return fn(ntt_lanes8<MOD>{});
+    }
+#endif
+    fn(ntt_lanes1<MOD>{});
+}
+
+/**
+ * Levels [l,h) of the forward transform of size 2^h, or the same levels of the inverse,
+ * on the block a = a[r*2^(h-l), (r+1)*2^(h-l)) that is block r at level l (l even).
+ * Twiddles of the first block at each level are computed directly, then chained.
+ */
+template <bool inverse, uint32_t MOD>
+void ntt_montgomery_levels(uint32_t* a, int h, int l, int r) {
+    using M = montgomery<MOD>;
+    using R = ntt_montgomery_roots<MOD>;
+    int rev = 0;
+    for (int i = 0; i < l; i++) {
+        rev |= (r >> i & 1) << (l - 1 - i);
+    }
+
+    if constexpr (!inverse) {
+        for (int len = l; len < h;) {
+            int radix4 = h - len >= 2, p = 1 << (h - len - 1 - radix4);
+            ntt_lanes_dispatch<MOD>(p, [&](auto lanes) {
+                using L = decltype(lanes);
+                uint32_t rot = R::pow(R::root[len + 1 + radix4], rev);
+                for (int s = 0; s < (1 << (len - l)); s++) {
+                    if (radix4) {
+                        ntt_dif_radix4<L, MOD>(a + (s << (h - len)), p, p, rot, R::imag);
+                        rot = M::mul(rot, R::rate3[__builtin_ctz(~s)]);
+                    } else {
+                        ntt_dif_radix2<L, MOD>(a + (s << (h - len)), p, p, rot);
+                        rot = M::mul(rot, R::rate2[__builtin_ctz(~s)]);
+                    }
+                }
+            });
+            len += 1 + radix4;
+        }
+    } else {
+        // mirror of the forward: radix-2 first if h is odd, then radix-4 up to level l
+        for (int len = h; len > l;) {
+            int radix4 = len % 2 == 0, p = 1 << (h - len);
+            ntt_lanes_dispatch<MOD>(p, [&](auto lanes) {
+                using L = decltype(lanes);
+                uint32_t irot = R::pow(R::iroot[len], rev);
+                for (int s = 0; s < (1 << (len - 1 - radix4 - l)); s++) {
+                    auto block = a + (s << (h - len + 1 + radix4));
+                    if (radix4) {
+                        ntt_dit_radix4<L, MOD>(block, p, p, irot, R::iimag);
+                        irot = M::mul(irot, R::irate3[__builtin_ctz(~s)]);
+                    } else {
+                        ntt_dit_radix2<L, MOD>(block, p, p, irot);
+                        irot = M::mul(irot, R::irate2[__builtin_ctz(~s)]);
+                    }
+                }
+            });
+            len -= 1 + radix4;
+        }
+    }
+}
+
+/**
+ * Levels [0,l) of the forward transform of size 2^h, or the same levels of the inverse,
+ * restricted to the columns [c0,c1) of a seen as 2^l rows of length 2^(h-l) (l even).
+ * Together with ntt_montgomery_levels on each row this is the whole transform, split
+ * like the six-step FFT without the transposes: each column and row group fits in cache.
+ */
+template <bool inverse, uint32_t MOD>
+void ntt_montgomery_columns(uint32_t* a, int h, int l, int c0, int c1) {
+    using M = montgomery<MOD>;
+    using R = ntt_montgomery_roots<MOD>;
+    int B = 1 << (h - l), n = c1 - c0;
+
+    ntt_lanes_dispatch<MOD>(n, [&](auto lanes) {
+        using L = decltype(lanes);
+        if constexpr (!inverse) {
+            for (int len = 0; len < l; len += 2) {
+                int p = 1 << (h - len - 2);
+                uint32_t rot = M::R1;
+                for (int s = 0; s < (1 << len); s++) {
+                    for (int t = 0; t < p; t += B) {
+                        auto block = a + (s << (h - len)) + t + c0;
+                        ntt_dif_radix4<L, MOD>(block, p, n, rot, R::imag);
+                    }
+                    rot = M::mul(rot, R::rate3[__builtin_ctz(~s)]);
+                }
+            }
+        } else {
+            for (int len = l; len > 0; len -= 2) {
+                int p = 1 << (h - len);
+                uint32_t irot = M::R1;
+                for (int s = 0; s < (1 << (len - 2)); s++) {
+                    for (int t = 0; t < p; t += B) {
+                        auto block = a + (s << (h - len + 2)) + t + c0;
+                        ntt_dit_radix4<L, MOD>(block, p, n, irot, R::iimag);
+                    }
+                    irot = M::mul(irot, R::irate3[__builtin_ctz(~s)]);
+                }
+            }
+        }
+    });
+}
+
+// a[0..N) in [0,2MOD) in any form. Forward: natural -> bitrev, inverse: bitrev -> natural
+template <bool inverse, uint32_t MOD>
+void ntt_montgomery_transform(uint32_t* a, int N) {
+    using R = ntt_montgomery_roots<MOD>;
+    fft_count_transform();
+    R::init();
+    int h = __builtin_ctz(N);
+    assert(N == (1 << h) && h <= R::rank2 && "Modulus cannot handle NTT this large");
+    ntt_montgomery_levels<inverse, MOD>(a, h, 0, 0);
+}
+
+// c[i] = M::mul(a[i], b[i]), vectorized like the transform
+template <uint32_t MOD>
+void ntt_montgomery_pointwise(uint32_t* c, const uint32_t* a, const uint32_t* b, int N) {
+    int i = 0;
+#ifdef __AVX2__
+    using L = ntt_lanes8<MOD>;
+    for (; i + 8 <= N; i += 8) {
+        L::store(c + i, L::mul(L::load(a + i), L::load(b + i)));
+    }
+#endif
+    for (; i < N; i++) {
+        c[i] = montgomery<MOD>::mul(a[i], b[i]);
+    }
+}
+
+// Plain inputs: transforms keep the plain scale, the product divides by R once,
+// and the final multiplication by R^2/N restores it.
+// Folds a modulo x^N-1 if it is longer than N
+template <uint32_t MOD>
+auto ntt_montgomery_forward(const vector<modnum<MOD>>& a, int N) {
+    int A = a.size();
+    vector<uint32_t> fa(N, 0);
+    for (int i = 0; i < min(A, N); i++) {
+        fa[i] = a[i].n;
+    }
+    for (int i = N; i < A; i++) {
+        fa[i & (N - 1)] = (a[i] + modnum<MOD>(fa[i & (N - 1)])).n;
+    }
+    ntt_montgomery_transform<0, MOD>(fa.data(), N);
+    return fa;
+}
+
+// Coefficients [L,R) of the inverse transform of fa
+template <uint32_t MOD>
+auto ntt_montgomery_inverse(vector<uint32_t>& fa, int L, int R) {
+    using M = montgomery<MOD>;
+    using T = modnum<MOD>;
+    int N = fa.size();
+    ntt_montgomery_transform<1, MOD>(fa.data(), N);
+
+    uint32_t scale = uint64_t(T(N).inv().n) * M::R2 % MOD;
+    vector<T> c(R - L);
+    for (int i = L; i < R; i++) {
+        c[i - L].n = M::fit(M::mul(fa[i], scale));
+    }
+    return c;
+}
+
+template <uint32_t MOD>
+auto ntt_montgomery_multiply(const vector<modnum<MOD>>& a, const vector<modnum<MOD>>& b) {
+    int A = a.size(), B = b.size();
+    int S = A + B - 1, N = 1 << next_two(S);
+    auto fa = ntt_montgomery_forward(a, N);
+    auto fb = ntt_montgomery_forward(b, N);
+    ntt_montgomery_pointwise<MOD>(fa.data(), fa.data(), fb.data(), N);
+    auto c = ntt_montgomery_inverse<MOD>(fa, 0, S);
+    trim_vector(c);
+    return c;
+}
+
 template <uint32_t MOD>
 auto ntt_multiply(const vector<modnum<MOD>>& a, const vector<modnum<MOD>>& b) {
     using T = modnum<MOD>;
@@ -275,6 +637,9 @@ auto ntt_multiply(const vector<modnum<MOD>>& a, const vector<modnum<MOD>>& b) {
     if (min(A, B) <= 5 || 1.0 * A * B <= 2.5 * N * s) {
         return naive_multiply(a, b);
     }
+    if constexpr (MOD % 2 == 1 && MOD < (1u << 30)) {
+        return ntt_montgomery_multiply(a, b);
+    }
 
     auto fb = fft_roots_cache<T>::get_scratch(N).second;
     vector<T> c(N);
@@ -291,41 +656,425 @@ auto ntt_multiply(const vector<modnum<MOD>>& a, const vector<modnum<MOD>>& b) {
     return c;
 }
 
+/**
+ * A fixed operand b kept transformed at size N >= n, for repeated products a*b with
+ * A+B-1 <= N that then cost one forward and one inverse transform instead of three.
+ * Two prepared operands of the same size multiply with a single inverse transform.
+ * The transform is computed by the first product that needs it, so preparing operands
+ * that end up in naive products is free (and a fresh one must not be shared by threads).
+ * Other products and moduli the Montgomery NTT can't handle use ntt_multiply(a, b).
+ */
+template <uint32_t MOD>
+struct ntt_prepared {
+    static constexpr bool transformable = MOD % 2 == 1 && MOD < (1u << 30);
+
+    int N = 0;
+    vector<modnum<MOD>> b;
+    mutable vector<uint32_t> fb;
+
+    ntt_prepared() = default;
+    ntt_prepared(vector<modnum<MOD>> v, int n) : N(1 << next_two(n)), b(move(v)) {
+        assert(int(b.size()) <= N);
+    }
+
+    int size() const { return b.size(); }
+
+    // Whether a*b for A coefficients runs on the transform, rather than in ntt_multiply
+    bool fits(int A) const {
+        int B = size(), S = A + B - 1, s = next_two(S);
+        return transformable && S <= N && min(A, B) > 5 &&
+               1.0 * A * B > 2.5 * (1 << s) * s;
+    }
+
+    const uint32_t* transformed() const {
+        if constexpr (transformable) {
+            if (fb.empty()) {
+                fb = ntt_montgomery_forward(b, N);
+            }
+        }
+        return fb.data();
+    }
+};
+
+template <uint32_t MOD>
+auto ntt_multiply(const vector<modnum<MOD>>& a, const ntt_prepared<MOD>& b) {
+    int A = a.size(), S = A + b.size() - 1;
+    if constexpr (ntt_prepared<MOD>::transformable) {
+        if (b.fits(A)) {
+            auto fa = ntt_montgomery_forward(a, b.N);
+            ntt_montgomery_pointwise<MOD>(fa.data(), fa.data(), b.transformed(), b.N);
+            auto c = ntt_montgomery_inverse<MOD>(fa, 0, S);
+            trim_vector(c);
+            return c;
+        }
+    }
+    return ntt_multiply(a, b.b);
+}
+
+template <uint32_t MOD>
+auto ntt_multiply(const ntt_prepared<MOD>& a, const ntt_prepared<MOD>& b) {
+    int S = a.size() + b.size() - 1;
+    if constexpr (ntt_prepared<MOD>::transformable) {
+        if (a.N == b.N && b.fits(a.size())) {
+            int N = a.N;
+            vector<uint32_t> fc(N);
+            ntt_montgomery_pointwise<MOD>(fc.data(), a.transformed(), b.transformed(), N);
+            auto c = ntt_montgomery_inverse<MOD>(fc, 0, S);
+            trim_vector(c);
+            return c;
+        }
+    }
+    return ntt_multiply(a.b, b);
+}
+
+// a*b modulo x^N-1 for a power of two N
+template <uint32_t MOD>
+auto ntt_cyclic_multiply(const vector<modnum<MOD>>& a, const vector<modnum<MOD>>& b,
+                         int N) {
+    int A = a.size(), B = b.size(), s = next_two(N);
+    assert(N == (1 << s));
+    if constexpr (ntt_prepared<MOD>::transformable) {
+        if (min(A, B) > 5 && 1.0 * A * B > 2.5 * N * s) {
+            auto fa = ntt_montgomery_forward(a, N);
+            auto fb = ntt_montgomery_forward(b, N);
+            ntt_montgomery_pointwise<MOD>(fa.data(), fa.data(), fb.data(), N);
+            return ntt_montgomery_inverse<MOD>(fa, 0, N);
+        }
+    }
+    auto ab = ntt_multiply(a, b);
+    vector<modnum<MOD>> c(N);
+    for (int i = 0, S = ab.size(); i < S; i++) {
+        c[i & (N - 1)] += ab[i];
+    }
+    return c;
+}
+
+// (a*b)[B-1,A) for A >= B, the coefficients where all of b overlaps a. Only the first
+// B-1 coefficients wrap around in a cyclic convolution of size >= A, so it takes one.
+template <uint32_t MOD>
+auto ntt_middle_product(const vector<modnum<MOD>>& a, const vector<modnum<MOD>>& b) {
+    int A = a.size(), B = b.size();
+    assert(0 < B && B <= A);
+    auto c = ntt_cyclic_multiply(a, b, 1 << next_two(A));
+    return vector<modnum<MOD>>(begin(c) + (B - 1), begin(c) + A);
+}
+
+template <uint32_t MOD>
+auto ntt_middle_product(const ntt_prepared<MOD>& a, const ntt_prepared<MOD>& b) {
+    int A = a.size(), B = b.size(), N = a.N, s = next_two(N);
+    assert(0 < B && B <= A);
+    if constexpr (ntt_prepared<MOD>::transformable) {
+        if (a.N == b.N && B > 5 && 1.0 * (A - B + 1) * B > 2.5 * N * s) {
+            vector<uint32_t> fc(N);
+            ntt_montgomery_pointwise<MOD>(fc.data(), a.transformed(), b.transformed(), N);
+            return ntt_montgomery_inverse<MOD>(fc, B - 1, A);
+        }
+    }
+    return ntt_middle_product(a.b, b.b);
+}
+
 } // namespace fft
 
-// FFT with complex numbers (for int, long, double) | 50,110,230ms for 250K,500K,1M
+// Real-input FFT over struct-of-arrays, for the FFT multiplications below
+namespace fft {
+
+/**
+ * Complex FFT of size M on separate arrays re[] and im[], so the butterflies of a block
+ * run over 4 doubles at a time with AVX, or over scalars otherwise (long double, ...).
+ * Like the Montgomery NTT, forward goes from natural to bit-reversed order with radix-4
+ * decimation in frequency, inverse goes back with radix-4 decimation in time, and the
+ * inverse does not divide by M.
+ *
+ * All twiddles come from one table tw[s] = exp(i*pi*r(s)), where r(s) is s bit-reversed
+ * as a binary fraction. It is the twiddle of block s at every level for every size, and
+ * also the twiddle w_2M^k of the frequency k sitting at position s after a forward
+ * transform of size M. It is computed with cos/sin directly and never by products.
+ *
+ * Real sequences x of length 2M are transformed as z[j] = x[2j] + i x[2j+1] of length M,
+ * and fft_real_unpack/fft_real_pack convert between Z and the spectrum of x, so a real
+ * product of size N costs 3 complex transforms of size N/2.
+ */
+template <typename D>
+struct fft_lanes1 {
+    using V = D;
+    static constexpr int W = 1;
+    static V load(const D* p) { return *p; }
+    static void store(D* p, V x) { *p = x; }
+    static V set1(D x) { return x; }
+};
+
+#ifdef __AVX__
+struct fft_lanes4 {
+    using V = __m256d;
+    static constexpr int W = 4;
+    static V load(const double* p) { return _mm256_loadu_pd(p); }
+    static void store(double* p, V x) { _mm256_storeu_pd(p, x); }
+    static V set1(double x) { return _mm256_set1_pd(x); }
+};
+#endif
+
+// Call fn(L{}) with the widest lanes L that fit in blocks of p elements
+template <typename D, typename Fn>
+void fft_lanes_dispatch([[maybe_unused]] int p, Fn&& fn) {
+#ifdef __AVX__
+    if constexpr (is_same_v<D, double>) {
+        if (p >= 4) {
+            return fn(fft_lanes4{});
+        }
+    }
+#endif
+    fn(fft_lanes1<D>{});
+}
+
+template <typename D>
+struct fft_soa_cache {
+    static inline vector<D> re = {1}, im = {0}, scratch;
+
+    static void reserve(int M) {
+        int K = re.size();
+        if (K < M) {
+            re.resize(M), im.resize(M);
+            for (int s = K; s < M; s++) {
+                D r = 0, bit = 0.5;
+                for (int x = s; x; x >>= 1, bit /= 2) {
+                    r += (x & 1) * bit;
+                }
+                re[s] = cos(TAU / 2 * r), im[s] = sin(TAU / 2 * r);
+            }
+        }
+    }
+
+    static auto get(int s) { return my_complex<D>(re[s], im[s]); }
+
+    static D* get_scratch(int N) {
+        if (int(scratch.size()) < N) {
+            scratch.resize(N);
+        }
+        return scratch.data();
+    }
+};
+
+template <typename L, typename D>
+struct fft_soa_block {
+    using V = typename L::V;
+    struct C {
+        V x, y;
+        friend C operator+(C a, C b) { return {a.x + b.x, a.y + b.y}; }
+        friend C operator-(C a, C b) { return {a.x - b.x, a.y - b.y}; }
+        friend C operator*(C a, C b) {
+            return {a.x * b.x - a.y * b.y, a.x * b.y + a.y * b.x};
+        }
+    };
+    D *re, *im;
+
+    C load(int i) const { return {L::load(re + i), L::load(im + i)}; }
+    void store(int i, C z) const { L::store(re + i, z.x), L::store(im + i, z.y); }
+    static C set1(my_complex<D> z) { return {L::set1(z.x), L::set1(z.y)}; }
+};
+
+template <typename L, typename D>
+void fft_dif_radix4(fft_soa_block<L, D> a, int p, my_complex<D> r1, my_complex<D> r2) {
+    using C = typename fft_soa_block<L, D>::C;
+    C w1 = a.set1(r1), w2 = a.set1(r2), w3 = a.set1(r1 * r2);
+    for (int i = 0; i < p; i += L::W) {
+        C a0 = a.load(i), a1 = a.load(i + p) * w1;
+        C a2 = a.load(i + 2 * p) * w2, a3 = a.load(i + 3 * p) * w3;
+        C s02 = a0 + a2, d02 = a0 - a2, s13 = a1 + a3, d = a1 - a3, d13{-d.y, d.x};
+        a.store(i, s02 + s13);
+        a.store(i + p, s02 - s13);
+        a.store(i + 2 * p, d02 + d13);
+        a.store(i + 3 * p, d02 - d13);
+    }
+}
+
+template <typename L, typename D>
+void fft_dif_radix2(fft_soa_block<L, D> a, int p, my_complex<D> r1) {
+    using C = typename fft_soa_block<L, D>::C;
+    C w1 = a.set1(r1);
+    for (int i = 0; i < p; i += L::W) {
+        C l = a.load(i), r = a.load(i + p) * w1;
+        a.store(i, l + r);
+        a.store(i + p, l - r);
+    }
+}
+
+template <typename L, typename D>
+void fft_dit_radix4(fft_soa_block<L, D> a, int p, my_complex<D> r1, my_complex<D> r2) {
+    using C = typename fft_soa_block<L, D>::C;
+    C w1 = a.set1(r1), w2 = a.set1(r2), w3 = a.set1(r1 * r2);
+    for (int i = 0; i < p; i += L::W) {
+        C a0 = a.load(i), a1 = a.load(i + p);
+        C a2 = a.load(i + 2 * p), a3 = a.load(i + 3 * p);
+        C s01 = a0 + a1, d01 = a0 - a1, s23 = a2 + a3, d = a2 - a3, d23{d.y, -d.x};
+        a.store(i, s01 + s23);
+        a.store(i + p, (d01 + d23) * w1);
+        a.store(i + 2 * p, (s01 - s23) * w2);
+        a.store(i + 3 * p, (d01 - d23) * w3);
+    }
+}
+
+template <typename L, typename D>
+void fft_dit_radix2(fft_soa_block<L, D> a, int p, my_complex<D> r1) {
+    using C = typename fft_soa_block<L, D>::C;
+    C w1 = a.set1(r1);
+    for (int i = 0; i < p; i += L::W) {
+        C l = a.load(i), r = a.load(i + p);
+        a.store(i, l + r);
+        a.store(i + p, (l - r) * w1);
+    }
+}
+
+template <bool inverse, typename D>
+void fft_soa_transform(D* re, D* im, int M) {
+    using R = fft_soa_cache<D>;
+    R::reserve(M);
+    int h = __builtin_ctz(M);
+    assert(M == (1 << h));
+
+    if constexpr (!inverse) {
+        for (int len = 0; len < h;) {
+            int radix4 = h - len >= 2, p = 1 << (h - len - 1 - radix4);
+            fft_lanes_dispatch<D>(p, [&](auto lanes) {
+                using L = decltype(lanes);
+                for (int s = 0, o = 0; s < (1 << len); s++, o += p << (1 + radix4)) {
+                    fft_soa_block<L, D> block{re + o, im + o};
+                    if (radix4) {
+                        fft_dif_radix4(block, p, R::get(2 * s), R::get(s));
+                    } else {
+                        fft_dif_radix2(block, p, R::get(s));
+                    }
+                }
+            });
+            len += 1 + radix4;
+        }
+    } else {
+        for (int len = h; len > 0;) {
+            int radix4 = len >= 2, p = 1 << (h - len);
+            fft_lanes_dispatch<D>(p, [&](auto lanes) {
+                using L = decltype(lanes);
+                for (int s = 0, o = 0; s < (1 << (len - 1 - radix4)); s++) {
+                    fft_soa_block<L, D> block{re + o, im + o};
+                    if (radix4) {
+                        fft_dit_radix4(block, p, conj(R::get(2 * s)), conj(R::get(s)));
+                    } else {
+                        fft_dit_radix2(block, p, conj(R::get(s)));
+                    }
+                    o += p << (1 + radix4);
+                }
+            });
+            len -= 1 + radix4;
+        }
+    }
+}
+
+// Forward transform of real x(0..n) zero-padded to 2M, packed into re[0..M), im[0..M)
+template <typename D, typename Fn>
+void fft_real_forward(D* re, D* im, int M, int n, Fn&& x) {
+    for (int j = 0; j < M; j++) {
+        re[j] = 2 * j < n ? D(x(2 * j)) : D(0);
+        im[j] = 2 * j + 1 < n ? D(x(2 * j + 1)) : D(0);
+    }
+    fft_soa_transform<0>(re, im, M);
+}
+
+// Position of frequency M-k after a forward transform of size M, given the position of k
+inline int fft_bitrev_partner(int p) {
+    return p <= 1 ? p : (3 << (31 - __builtin_clz(p))) - 1 - p;
+}
+
+// Spectrum (X[k], X[k+M]) of real x from the transformed z at positions p,q of k,M-k
+template <typename D>
+auto fft_real_unpack(const D* re, const D* im, int p, int q, my_complex<D> w) {
+    using C = my_complex<D>;
+    C z(re[p], im[p]), zq(re[q], -im[q]);
+    C e = (z + zq) * D(0.5), o = (z - zq) * C(0, -0.5);
+    return make_pair(e + w * o, e - w * o);
+}
+
+// Inverse of fft_real_unpack, writes f*z at position p given (X[k], X[k+M])
+template <typename D>
+void fft_real_pack(D* re, D* im, int p, my_complex<D> x0, my_complex<D> x1,
+                   my_complex<D> w, D f) {
+    auto e = (x0 + x1) * f, o = (x0 - x1) * conj(w) * f;
+    re[p] = e.x - o.y, im[p] = e.y + o.x;
+}
+
+/**
+ * The three real convolutions c0=a0*b0, c1=a0*b1+a1*b0, c2=a1*b1 for the splits
+ * (a0[i],a1[i]) = sa(i), (b0[i],b1[i]) = sb(i), with 7 complex transforms of size M.
+ * Calls out(i,c0[i],c1[i],c2[i]) for i in [0,S).
+ */
+template <typename D, typename SplitA, typename SplitB, typename Out>
+void fft_split_convolve(int A, int B, int S, SplitA&& sa, SplitB&& sb, Out&& out) {
+    int M = S > 1 ? 1 << (next_two(S) - 1) : 1;
+    D* buf = fft_soa_cache<D>::get_scratch(14 * M);
+    D *a0r = buf, *a0i = a0r + M, *a1r = a0i + M, *a1i = a1r + M;
+    D *b0r = a1i + M, *b0i = b0r + M, *b1r = b0i + M, *b1i = b1r + M;
+    D *c0r = b1i + M, *c0i = c0r + M, *c1r = c0i + M, *c1i = c1r + M;
+    D *c2r = c1i + M, *c2i = c2r + M;
+
+    fft_real_forward(a0r, a0i, M, A, [&](int i) { return sa(i).first; });
+    fft_real_forward(a1r, a1i, M, A, [&](int i) { return sa(i).second; });
+    fft_real_forward(b0r, b0i, M, B, [&](int i) { return sb(i).first; });
+    fft_real_forward(b1r, b1i, M, B, [&](int i) { return sb(i).second; });
+    D f = D(0.5) / M;
+    for (int p = 0; p < M; p++) {
+        int q = fft_bitrev_partner(p);
+        auto w = fft_soa_cache<D>::get(p);
+        auto [x0, x1] = fft_real_unpack(a0r, a0i, p, q, w);
+        auto [y0, y1] = fft_real_unpack(a1r, a1i, p, q, w);
+        auto [u0, u1] = fft_real_unpack(b0r, b0i, p, q, w);
+        auto [v0, v1] = fft_real_unpack(b1r, b1i, p, q, w);
+        fft_real_pack(c0r, c0i, p, x0 * u0, x1 * u1, w, f);
+        fft_real_pack(c1r, c1i, p, x0 * v0 + y0 * u0, x1 * v1 + y1 * u1, w, f);
+        fft_real_pack(c2r, c2i, p, y0 * v0, y1 * v1, w, f);
+    }
+    fft_soa_transform<1>(c0r, c0i, M);
+    fft_soa_transform<1>(c1r, c1i, M);
+    fft_soa_transform<1>(c2r, c2i, M);
+    for (int i = 0; i < S; i++) {
+        int j = i >> 1;
+        if (i & 1) {
+            out(i, c0i[j], c1i[j], c2i[j]);
+        } else {
+            out(i, c0r[j], c1r[j], c2r[j]);
+        }
+    }
+}
+
+} // namespace fft
+
+// FFT with complex numbers (for int, long, double) | 20,45,100ms for 250K,500K,1M
 namespace fft {
 
 template <typename C = default_complex, typename T>
 auto fft_multiply(const vector<T>& a, const vector<T>& b) {
+    using D = typename C::value_type;
     if (a.empty() || b.empty()) {
         return vector<T>();
     }
     int A = a.size(), B = b.size();
-    int S = A + B - 1, s = next_two(S), N = 1 << s;
+    int S = A + B - 1, s = next_two(S), N = 1 << s, M = N / 2;
     if (min(A, B) <= 5 || 1.0 * A * B <= 8.0 * N * s) {
         return naive_multiply(a, b);
     }
 
-    auto [fa, fb] = fft_roots_cache<C>::get_scratch(N);
-    for (int i = 0; i < min(A, B); i++) {
-        fa[i] = C(a[i], b[i]);
-    }
-    for (int i = B; i < A; i++) {
-        fa[i] = C(a[i], 0);
-    }
-    for (int i = A; i < B; i++) {
-        fa[i] = C(0, b[i]);
+    D* buf = fft_soa_cache<D>::get_scratch(6 * M);
+    D *ar = buf, *ai = ar + M, *br = ai + M, *bi = br + M, *cr = bi + M, *ci = cr + M;
+    fft_real_forward(ar, ai, M, A, [&](int i) { return a[i]; });
+    fft_real_forward(br, bi, M, B, [&](int i) { return b[i]; });
+    D f = D(0.5) / M;
+    for (int p = 0; p < M; p++) {
+        int q = fft_bitrev_partner(p);
+        auto w = fft_soa_cache<D>::get(p);
+        auto [x0, x1] = fft_real_unpack(ar, ai, p, q, w);
+        auto [y0, y1] = fft_real_unpack(br, bi, p, q, w);
+        fft_real_pack(cr, ci, p, x0 * y0, x1 * y1, w, f);
     }
-    fill_n(begin(fa) + max(A, B), N - max(A, B), C(0));
-    fft_transform<0, 0>(fa, N);
-    for (int i = 0, j = 0; i < N; i++, j = N - i) {
-        fb[i] = (fa[i] * fa[i] - conj(fa[j] * fa[j])) * C(0, -0.25);
-    }
-    fft_transform<1, 0>(fb, N);
+    fft_soa_transform<1>(cr, ci, M);
     vector<T> c(S);
     for (int i = 0; i < S; i++) {
-        c[i] = fft_round<T>(fb[i].real());
+        c[i] = fft_round<T>(i & 1 ? ci[i >> 1] : cr[i >> 1]);
     }
     trim_vector(c);
     return c;
@@ -333,7 +1082,7 @@ auto fft_multiply(const vector<T>& a, const vector<T>& b) {
 
 } // namespace fft
 
-// FFT-SPLIT (for large ints, longs, doubles) | 120,270,560ms for 250K,500K,1M
+// FFT-SPLIT (for large ints, longs, doubles) | 40,100,170ms for 250K,500K,1M
 namespace fft {
 
 template <typename T>
@@ -344,16 +1093,15 @@ auto maxabsolute(const vector<T>& a) {
     return maxabs;
 }
 
-template <typename T, typename C>
-void fft_split_lower_upper(T d, const vector<T>& a, vector<C>& comp) {
-    for (int i = 0, A = a.size(); i < A; i++) {
-        comp[i].imag(floor(a[i] / d));
-        comp[i].real(a[i] - comp[i].imag() * d);
-    }
+template <typename T>
+auto fft_split_lower_upper(T d, T v) {
+    T upper = floor(v / d);
+    return make_pair(v - upper * d, upper);
 }
 
 template <typename C = default_complex, typename T>
 auto fft_split_multiply(const vector<T>& a, const vector<T>& b) {
+    using D = typename C::value_type;
     if (a.empty() || b.empty()) {
         return vector<T>();
     }
@@ -364,52 +1112,32 @@ auto fft_split_multiply(const vector<T>& a, const vector<T>& b) {
     }
 
     T H = sqrt(max(maxabsolute(a), maxabsolute(b))), Q = H * H;
-    auto [fa, fb] = fft_roots_cache<C>::get_scratch(N);
-    fft_split_lower_upper(H, a, fa);
-    fft_split_lower_upper(H, b, fb);
-    fill_n(begin(fa) + A, N - A, C(0));
-    fill_n(begin(fb) + B, N - B, C(0));
-    fft_transform<0, 0>(fa, N);
-    fft_transform<0, 0>(fb, N);
-    vector<C> h0(N), h1(N);
-    for (int i = 0, j = 0; i < N; i++, j = N - i) {
-        auto f_small = (fa[i] + conj(fa[j])) * 0.5;
-        auto f_large = (fa[i] - conj(fa[j])) * C(0, -0.5);
-        auto g_small = (fb[i] + conj(fb[j])) * 0.5;
-        auto g_large = (fb[i] - conj(fb[j])) * C(0, -0.5);
-        h0[i] = f_small * g_small + C(0, 1) * f_large * g_large;
-        h1[i] = f_small * g_large + f_large * g_small;
-    }
-    fft_transform<1, 0>(h0, N);
-    fft_transform<1, 0>(h1, N);
-
     vector<T> c(S);
-    for (int i = 0; i < S; i++) {
-        T c0 = fft_round<T>(h0[i].real());
-        T c1 = fft_round<T>(h1[i].real());
-        T c2 = fft_round<T>(h0[i].imag());
-        c[i] = c0 + c1 * H + c2 * Q;
-    }
+    fft_split_convolve<D>(
+        A, B, S, [&](int i) { return fft_split_lower_upper(H, a[i]); },
+        [&](int i) { return fft_split_lower_upper(H, b[i]); },
+        [&](int i, D h0, D h1, D h2) {
+            c[i] = fft_round<T>(h0) + fft_round<T>(h1) * H + fft_round<T>(h2) * Q;
+        });
     trim_vector(c);
     return c;
 }
 
 } // namespace fft
 
-// NTT-SPLIT for modnums (2 ffts) | 110,250,520ms for 250K,500K,1M
+// NTT-SPLIT for modnums (7 half ffts) | 45,100,215ms for 250K,500K,1M
 namespace fft {
 
-template <uint32_t MOD, typename T = int, typename C>
-auto fft_split_lower_upper_mod(T d, const vector<modnum<MOD>>& a, vector<C>& comp) {
-    for (int i = 0, A = a.size(); i < A; i++) {
-        T y = T(a[i]), v = abs(y) <= abs(y - T(MOD)) ? y : y - T(MOD);
-        comp[i] = C(v % d, v / d);
-    }
+template <uint32_t MOD, typename T = int>
+auto fft_split_lower_upper_mod(T d, modnum<MOD> x) {
+    T y = T(x), v = abs(y) <= abs(y - T(MOD)) ? y : y - T(MOD);
+    return make_pair(v % d, v / d);
 }
 
 template <typename C = default_complex, uint32_t MOD>
 auto fft_multiply(const vector<modnum<MOD>>& a, const vector<modnum<MOD>>& b) {
     using T = modnum<MOD>;
+    using D = typename C::value_type;
     if (a.empty() || b.empty()) {
         return vector<T>();
     }
@@ -420,39 +1148,23 @@ auto fft_multiply(const vector<modnum<MOD>>& a, const vector<modnum<MOD>>& b) {
     }
 
     int H = sqrt(MOD) + 3, Q = H * H;
-    auto [fa, fb] = fft_roots_cache<C>::get_scratch(N);
-    fft_split_lower_upper_mod(H, a, fa);
-    fft_split_lower_upper_mod(H, b, fb);
-    fill_n(begin(fa) + A, N - A, C(0));
-    fill_n(begin(fb) + B, N - B, C(0));
-    fft_transform<0, 0>(fa, N);
-    fft_transform<0, 0>(fb, N);
-    vector<C> h0(N), h1(N);
-    for (int i = 0, j = 0; i < N; i++, j = N - i) {
-        auto f_small = (fa[i] + conj(fa[j])) * 0.5;
-        auto f_large = (fa[i] - conj(fa[j])) * C(0, -0.5);
-        auto g_small = (fb[i] + conj(fb[j])) * 0.5;
-        auto g_large = (fb[i] - conj(fb[j])) * C(0, -0.5);
-        h0[i] = f_small * g_small + C(0, 1) * f_large * g_large;
-        h1[i] = f_small * g_large + f_large * g_small;
-    }
-    fft_transform<1, 0>(h0, N);
-    fft_transform<1, 0>(h1, N);
-
     vector<T> c(S);
-    for (int i = 0; i < S; i++) {
-        T c0 = fft_round<int64_t>(h0[i].real()) % MOD;
-        T c1 = fft_round<int64_t>(h1[i].real()) % MOD;
-        T c2 = fft_round<int64_t>(h0[i].imag()) % MOD;
-        c[i] = c0 + c1 * H + c2 * Q;
-    }
+    fft_split_convolve<D>(
+        A, B, S, [&](int i) { return fft_split_lower_upper_mod(H, a[i]); },
+        [&](int i) { return fft_split_lower_upper_mod(H, b[i]); },
+        [&](int i, D h0, D h1, D h2) {
+            T c0 = fft_round<int64_t>(h0) % MOD;
+            T c1 = fft_round<int64_t>(h1) % MOD;
+            T c2 = fft_round<int64_t>(h2) % MOD;
+            c[i] = c0 + c1 * H + c2 * Q;
+        });
     trim_vector(c);
     return c;
 }
 
 } // namespace fft
 
-// NTT-SPLIT without modnums (2 ffts) | 110,250,520ms for 250K,500K,1M
+// NTT-SPLIT without modnums (7 half ffts) | 55,120,250ms for 250K,500K,1M
 namespace fft {
 
 template <typename T, typename O>
@@ -460,18 +1172,32 @@ T fitmod(T mod, O val) {
     return val < 0 ? (val + mod) : (val >= mod) ? (val - mod) : val;
 }
 
-template <typename Prom, typename T, typename C>
-void fft_split_lower_upper_mod(T mod, T d, const vector<T>& a, vector<C>& comp) {
-    for (int i = 0, A = a.size(); i < A; i++) {
-        T v = abs(a[i]) <= abs(a[i] - mod) ? a[i] : a[i] - mod;
-        comp[i] = C(v % d, v / d);
-    }
+template <typename T>
+auto fft_split_lower_upper_mod(T mod, T d, T x) {
+    T v = abs(x) <= abs(x - mod) ? x : x - mod;
+    return make_pair(v % d, v / d);
 }
 
 template <typename Prom = int64_t, typename C = default_complex, typename T>
 auto naive_multiply(T mod, const vector<T>& a, const vector<T>& b) {
     int A = a.size(), B = b.size(), S = A && B ? A + B - 1 : 0;
     vector<T> c(S);
+    if (2 <= mod && mod <= INT_MAX) { // barrett reductions of reduced operands
+        barrett br(mod);
+        vector<uint32_t> ra(A), rb(B), rc(S);
+        for (int i = 0; i < A; i++)
+            ra[i] = fitmod(mod, a[i] % mod);
+        for (int j = 0; j < B; j++)
+            rb[j] = fitmod(mod, b[j] % mod);
+        for (int i = 0; i < A && B; i++) {
+            for (int j = 0; j < B; j++) {
+                rc[i + j] = br.reduce(rc[i + j] + uint64_t(ra[i]) * rb[j]);
+            }
+        }
+        copy(begin(rc), end(rc), begin(c));
+        trim_vector(c);
+        return c;
+    }
     for (int i = 0; i < A && B; i++) {
         for (int j = 0; j < B; j++) {
             c[i + j] = (c[i + j] + Prom(a[i]) * Prom(b[j])) % mod;
@@ -488,6 +1214,7 @@ auto naive_multiply(T mod, const vector<T>& a, const vector<T>& b) {
 
 template <typename Prom = int64_t, typename C = default_complex, typename T>
 auto fft_multiply(T mod, const vector<T>& a, const vector<T>& b) {
+    using D = typename C::value_type;
     if (a.empty() || b.empty()) {
         return vector<T>();
     }
@@ -498,32 +1225,17 @@ auto fft_multiply(T mod, const vector<T>& a, const vector<T>& b) {
     }
 
     T H = sqrt(mod) + 3, Q = H * H;
-    auto [fa, fb] = fft_roots_cache<C>::get_scratch(N);
-    fft_split_lower_upper_mod<Prom>(mod, H, a, fa);
-    fft_split_lower_upper_mod<Prom>(mod, H, b, fb);
-    fill_n(begin(fa) + A, N - A, C(0));
-    fill_n(begin(fb) + B, N - B, C(0));
-    fft_transform<0, 0>(fa, N);
-    fft_transform<0, 0>(fb, N);
-    vector<C> h0(N), h1(N);
-    for (int i = 0, j = 0; i < N; i++, j = N - i) {
-        auto f_small = (fa[i] + conj(fa[j])) * 0.5;
-        auto f_large = (fa[i] - conj(fa[j])) * C(0, -0.5);
-        auto g_small = (fb[i] + conj(fb[j])) * 0.5;
-        auto g_large = (fb[i] - conj(fb[j])) * C(0, -0.5);
-        h0[i] = f_small * g_small + C(0, 1) * f_large * g_large;
-        h1[i] = f_small * g_large + f_large * g_small;
-    }
-    fft_transform<1, 0>(h0, N);
-    fft_transform<1, 0>(h1, N);
-
     vector<T> c(S);
-    for (int i = 0; i < S; i++) {
-        Prom c0 = fitmod(mod, fft_round<Prom>(h0[i].real()) % mod);
-        Prom c1 = fitmod(mod, fft_round<Prom>(h1[i].real()) % mod);
-        Prom c2 = fitmod(mod, fft_round<Prom>(h0[i].imag()) % mod);
-        c[i] = fitmod(mod, c0 + fitmod(mod, c1 * H % mod + fitmod(mod, c2 * Q % mod)));
-    }
+    fft_split_convolve<D>(
+        A, B, S, [&](int i) { return fft_split_lower_upper_mod(mod, H, a[i]); },
+        [&](int i) { return fft_split_lower_upper_mod(mod, H, b[i]); },
+        [&](int i, D h0, D h1, D h2) {
+            Prom c0 = fitmod(mod, fft_round<Prom>(h0) % mod);
+            Prom c1 = fitmod(mod, fft_round<Prom>(h1) % mod);
+            Prom c2 = fitmod(mod, fft_round<Prom>(h2) % mod);
+            Prom c12 = fitmod(mod, c1 * H % mod + fitmod(mod, c2 * Q % mod));
+            c[i] = fitmod(mod, c0 + c12);
+        });
     trim_vector(c);
     return c;
 }
@@ -154,39 +154,173 @@ auto chinese(const vector<int64_t>& b, const vector<int64_t>& primes) {
     return a;
 }
 
-auto phi(int64_t n) {
-    int64_t tot = 1;
-    if ((n & 1) == 0) {
-        n >>= 1;
-        while ((n & 1) == 0)
-            tot <<= 1, n >>= 1;
+/**
+ * Montgomery multiplication modulo an odd n < 2^64, with R = 2^64: x is kept as xR mod n
+ * so a product reduces with two 64-bit multiplies instead of a 128-bit division.
+ * Values in Montgomery form are canonical in [0,n), so they can be compared directly.
+ */
+struct montgomery64 {
+    using u64 = uint64_t;
+    using u128 = __uint128_t;
+    u64 n, ninv, r2; // ninv = n^-1 mod R, r2 = R² mod n
+
+    explicit montgomery64(u64 n) : n(n), ninv(n) {
+        assert(n & 1);
+        for (int i = 0; i < 5; i++) {
+            ninv *= 2 - n * ninv;
+        }
+        u64 r = -n % n;
+        r2 = u128(r) * r % n;
     }
-    for (int64_t p = 3; p * p <= n; p += 2) {
-        if (n % p == 0) {
-            tot *= p - 1;
-            n = n / p;
-            while (n % p == 0) {
-                tot *= p;
-                n = n / p;
+
+    u64 reduce(u128 t) const {
+        u64 hi = t >> 64, mn = (u128(u64(t) * ninv) * n) >> 64;
+        return hi >= mn ? hi - mn : hi - mn + n;
+    }
+    u64 to(u64 x) const { return reduce(u128(x % n) * r2); }
+    u64 from(u64 x) const { return reduce(x); }
+    u64 one() const { return to(1); }
+    u64 mul(u64 a, u64 b) const { return reduce(u128(a) * b); }
+    u64 add(u64 a, u64 b) const { return a >= n - b ? a - (n - b) : a + b; }
+    u64 pow(u64 a, u64 e) const {
+        u64 x = one();
+        for (; e > 0; e >>= 1, a = mul(a, a)) {
+            if (e & 1) {
+                x = mul(x, a);
             }
         }
+        return x;
     }
-    tot *= n > 1 ? n - 1 : 1;
-    return tot;
+};
+
+// Deterministic miller-rabin primality test for all 64-bit n. O(log n)
+bool miller_rabin(int64_t n) {
+    if (n < 64)
+        return n >= 0 && (0x28208a20a08a28acULL >> n & 1);
+    if (n % 2 == 0 || n % 3 == 0 || n % 5 == 0 || n % 7 == 0)
+        return false;
+    montgomery64 M(n);
+    int r = __builtin_ctzll(n - 1);
+    uint64_t d = (n - 1) >> r, one = M.one(), minus_one = n - one;
+
+    auto witness = [&](uint64_t base) {
+        if (base % n == 0)
+            return false;
+        auto x = M.pow(M.to(base), d);
+        if (x == one || x == minus_one)
+            return false;
+        for (int i = 0; i < r - 1 && x != minus_one; i++) {
+            x = M.mul(x, x);
+        }
+        return x != minus_one;
+    };
+    // {2,7,61} are witnesses for every composite below 4759123141, these 7 below 2^64
+    if (n < 4759123141) {
+        return !witness(2) && !witness(7) && !witness(61);
+    }
+    for (uint64_t base : {2, 325, 9375, 28178, 450775, 9780504, 1795265022}) {
+        if (witness(base))
+            return false;
+    }
+    return true;
 }
 
-auto factorize(int64_t n) {
-    map<int64_t, int> primes;
-    for (int64_t p = 2; p * p <= n; p++) {
+/**
+ * A nontrivial factor of an odd composite n, by Pollard's rho on x² + c with Brent's
+ * cycle finding in Montgomery form. The differences |x-y| are multiplied together and
+ * one gcd is taken every 128 steps, backtracking if that product hits 0 mod n.
+ * O(n^{1/4}) expected multiplications
+ */
+int64_t pollard_rho(int64_t n) {
+    montgomery64 M(n);
+    constexpr int BATCH = 128;
+    auto dist = [](uint64_t x, uint64_t y) { return x > y ? x - y : y - x; };
+    for (uint64_t c0 = 1;; c0++) {
+        uint64_t c = M.to(c0), x = 0, y = M.to(2), ys = 0, q = M.one(), g = 1;
+        auto f = [&](uint64_t v) { return M.add(M.mul(v, v), c); };
+        for (int64_t r = 1; g == 1; r <<= 1) {
+            x = y;
+            for (int64_t i = 0; i < r; i++) {
+                y = f(y);
+            }
+            for (int64_t k = 0; k < r && g == 1; k += BATCH) {
+                ys = y;
+                for (int64_t i = 0; i < min<int64_t>(BATCH, r - k); i++) {
+                    y = f(y), q = M.mul(q, dist(x, y));
+                }
+                g = std::gcd(q, uint64_t(n));
+            }
+        }
+        if (g == uint64_t(n)) {
+            do {
+                ys = f(ys), g = std::gcd(dist(x, ys), uint64_t(n));
+            } while (g == 1);
+        }
+        if (g != uint64_t(n)) {
+            return g;
+        }
+    }
+}
+
+// Append the prime factors of n to out, with repetition and unsorted
+void prime_factors(int64_t n, vector<int64_t>& out) {
+    if (n <= 1) {
+        return;
+    }
+    for (int p : {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47}) {
         while (n % p == 0) {
-            n /= p;
-            primes[p]++;
+            n /= p, out.push_back(p);
         }
     }
-    if (n > 1) {
-        primes[n]++;
+    auto rec = [&](auto& self, int64_t m) -> void {
+        if (m == 1) {
+            return;
+        } else if (miller_rabin(m)) {
+            out.push_back(m);
+        } else {
+            int64_t d = pollard_rho(m);
+            self(self, d), self(self, m / d);
+        }
+    };
+    rec(rec, n);
+}
+
+// Sorted prime factorization of n as (p,e) pairs. O(n^{1/4}) expected
+auto factorize_list(int64_t n, vector<int64_t>& buf) {
+    buf.clear(), prime_factors(n, buf);
+    sort(begin(buf), end(buf));
+    vector<pair<int64_t, int>> factors;
+    for (int64_t p : buf) {
+        if (factors.empty() || factors.back().first != p) {
+            factors.emplace_back(p, 0);
+        }
+        factors.back().second++;
     }
-    return primes;
+    return factors;
+}
+
+auto factorize(int64_t n) {
+    vector<int64_t> buf;
+    auto list = factorize_list(n, buf);
+    return map<int64_t, int>(begin(list), end(list));
+}
+
+// Factorize every number of ns, reusing one scratch buffer. O(n^{1/4}) expected each
+auto factorize_batch(const vector<int64_t>& ns) {
+    vector<vector<pair<int64_t, int>>> factors(ns.size());
+    vector<int64_t> buf;
+    for (int i = 0, N = ns.size(); i < N; i++) {
+        factors[i] = factorize_list(ns[i], buf);
+    }
+    return factors;
+}
+
+auto phi(int64_t n) {
+    int64_t tot = n;
+    for (auto [p, e] : factorize(n)) {
+        tot = tot / p * (p - 1);
+    }
+    return tot;
 }
 
 auto get_divisors(const map<int64_t, int>& factors, bool one, bool self) {
@@ -209,8 +343,12 @@ auto get_divisors(const map<int64_t, int>& factors, bool one, bool self) {
     return divs;
 }
 
-// Compute first primitive root modulo prime p. Complexity: O(sqrt(p)) worst-case
-int primitive_root_prime(int p) {
+auto get_divisors(int64_t n, bool one, bool self) {
+    return get_divisors(factorize(n), one, self);
+}
+
+// Compute first primitive root modulo prime p. Complexity: O(p^{1/4}) to factor p-1
+int64_t primitive_root_prime(int64_t p) {
     if (p == 2 || p == 3)
         return p - 1;
     if (p == 167772161 || p == 469762049 || p == 998244353)
@@ -219,27 +357,12 @@ int primitive_root_prime(int p) {
         return 5;
     assert(p % 2 == 1);
 
-    int divs[20] = {2};
-    int cnt = 1;
-    int x = (p - 1) / 2; // phi(p)
-    while (x % 2 == 0) {
-        x /= 2;
-    }
-    for (int i = 3; i * i <= x; i += 2) {
-        if (x % i == 0) {
-            divs[cnt++] = i;
-            do {
-                x /= i;
-            } while (x % i == 0);
-        }
-    }
-    if (x > 1) {
-        divs[cnt++] = x;
-    }
-    for (int g = 2;; g++) {
+    auto factors = factorize(p - 1);
+    montgomery64 M(p);
+    for (int64_t g = 2;; g++) {
         bool ok = true;
-        for (int i = 0; i < cnt; i++) {
-            if (modpow(g, (p - 1) / divs[i], p) == 1) {
+        for (auto [q, e] : factors) {
+            if (M.pow(M.to(g), (p - 1) / q) == M.one()) {
                 ok = false;
                 break;
             }
@@ -275,29 +398,3 @@ bool is_quadratic_residue(int64_t a, int64_t p) {
     a = a % p, a = a >= 0 ? a : a + p;
     return a != 0 && modpow(a, (p - 1) / 2, p) == 1;
 }
-
-// Fast miller-rabin test for compositeness of n. O(log n)
-bool miller_rabin(int64_t n) {
-    if (n < 5)
-        return n == 2 || n == 3;
-    if (n % 2 == 0)
-        return false;
-    int r = __builtin_ctzll(n - 1);
-    int64_t d = n >> r;
-
-    for (int witness : {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37}) {
-        if (witness > n)
-            break;
-        if (witness == n)
-            return true;
-        auto x = modpow(int64_t(witness), d, n);
-        if (x == 1 || x == n - 1)
-            continue;
-        for (int i = 0; i < r - 1 && x != n - 1; i++) {
-            x = __int128_t(x) * __int128_t(x) % n;
-        }
-        if (x != n - 1)
-            return false;
-    }
-    return true;
-}
@@ -3,10 +3,10 @@
 #include <bits/stdc++.h>
 using namespace std;
 
-template <uint32_t mod>
+template <uint32_t m>
 struct modnum {
     // change these if you need another size of integers
-    static constexpr inline uint32_t MOD = mod;
+    static constexpr inline uint32_t MOD = m;
     using u32 = uint32_t;
     using u64 = uint64_t;
     using i32 = int32_t;
@@ -15,6 +15,8 @@ struct modnum {
 
     u32 n;
 
+    static constexpr u32 mod() { return MOD; }
+
     constexpr modnum() : n(0) {}
     constexpr modnum(u64 v) : n(v >= MOD ? v % MOD : v) {}
     constexpr modnum(u32 v) : n(v >= MOD ? v % MOD : v) {}
@@ -83,21 +85,88 @@ struct hash<modnum<MOD>> {
 
 } // namespace std
 
+/**
+ * Montgomery form arithmetic modulo an odd MOD < 2^30 with R=2^32, for transform kernels.
+ * Values are kept lazily reduced in [0,2MOD): the sum of two values fits in 32 bits, and
+ * mul(a,b) for a,b in [0,2MOD) lands back in [0,2MOD) without a division.
+ * mul(a,b) computes a*b/R, so mul(to(a),to(b)) = to(a*b), and mul(to(a),b) = a*b for
+ * plain b, which lets plain inputs go through a transform with Montgomery twiddles.
+ */
+template <uint32_t mod>
+struct montgomery {
+    using u32 = uint32_t;
+    using u64 = uint64_t;
+    static constexpr u32 MOD = mod, MOD2 = 2 * mod;
+    static_assert(MOD % 2 == 1 && MOD < (1u << 30));
+
+    static constexpr u32 inverse() { // MOD^-1 mod R by Newton iteration
+        u32 x = MOD;
+        for (int i = 0; i < 4; i++)
+            x *= 2 - MOD * x;
+        return x;
+    }
+    static constexpr u32 INV = inverse();
+    static constexpr u32 R1 = (u64(1) << 32) % MOD;
+    static constexpr u32 R2 = u64(R1) * R1 % MOD;
+    static_assert(INV * MOD == 1);
+
+    static constexpr u32 reduce(u64 x) { // x < MOD*R, returns x/R in [0,2MOD)
+        u32 q = u32(x) * INV;
+        return u32(x >> 32) + MOD - u32((u64(q) * MOD) >> 32);
+    }
+    static constexpr u32 mul(u32 a, u32 b) { return reduce(u64(a) * b); }
+    static constexpr u32 shrink(u32 x) { return x >= MOD2 ? x - MOD2 : x; }
+    static constexpr u32 fit(u32 x) { return x >= MOD ? x - MOD : x; }
+    static constexpr u32 to(u32 x) { return mul(x, R2); }
+    static constexpr u32 from(u32 x) { return fit(reduce(x)); }
+    static constexpr u32 normal(u32 x) { return fit(shrink(x)); }
+};
+
+/**
+ * Barrett reduction modulo a runtime 2 <= m < 2^31, with im = ceil(2^64/m). For any
+ * 64-bit z the estimate (z·im)>>64 is floor(z/m) or one more, so z mod m costs a high
+ * multiply and a correction instead of a division.
+ */
+struct barrett {
+    using u32 = uint32_t;
+    using u64 = uint64_t;
+    u32 m = 0;
+    u64 im = 0;
+
+    barrett() = default;
+    explicit barrett(u32 m) : m(m), im(~u64(0) / m + 1) {
+        assert(2 <= m && m < (1u << 31));
+    }
+
+    u32 reduce(u64 z) const {
+        u64 x = (__uint128_t(z) * im) >> 64, y = x * m;
+        return z - y + (z < y ? m : 0);
+    }
+    u32 mul(u32 a, u32 b) const { return reduce(u64(a) * b); }
+};
+
+// Runtime modulus counterpart of modnum, set the modulus with dmodnum::set_mod(m)
 struct dmodnum {
-    // change these if you need another size of integers
-    static inline uint32_t MOD = 0;
     using u32 = uint32_t;
     using u64 = uint64_t;
     using i32 = int32_t;
     using i64 = int64_t;
 
+  private:
+    static inline u32 MOD = 0;
+    static inline barrett BR;
+
+  public:
     u32 n;
 
+    static void set_mod(u32 m) { MOD = m, BR = barrett(m); }
+    static u32 mod() { return MOD; }
+
     dmodnum() : n(0) {}
-    dmodnum(u64 v) : n(v >= MOD ? v % MOD : v) {}
-    dmodnum(u32 v) : n(v >= MOD ? v % MOD : v) {}
-    dmodnum(i64 v) : dmodnum(v >= 0 ? u64(v) : u64(MOD + v % int(MOD))) {}
-    dmodnum(i32 v) : dmodnum(v >= 0 ? u32(v) : u32(MOD + v % int(MOD))) {}
+    dmodnum(u64 v) : n(v >= MOD ? BR.reduce(v) : v) {}
+    dmodnum(u32 v) : n(v >= MOD ? BR.reduce(v) : v) {}
+    dmodnum(i64 v) : dmodnum(v >= 0 ? u64(v) : u64(MOD - BR.reduce(-u64(v)))) {}
+    dmodnum(i32 v) : dmodnum(v >= 0 ? u64(v) : u64(MOD - BR.reduce(-u64(v)))) {}
     explicit operator i32() const { return n; }
     explicit operator u32() const { return n; }
     explicit operator bool() const { return n != 0; }
@@ -134,7 +203,7 @@ struct dmodnum {
     dmodnum &operator--() { return n = fit(MOD + n - 1), *this; }
     dmodnum &operator+=(dmodnum v) { return n = fit(n + v.n), *this; }
     dmodnum &operator-=(dmodnum v) { return n = fit(MOD + n - v.n), *this; }
-    dmodnum &operator*=(dmodnum v) { return n = (u64(n) * v.n) % MOD, *this; }
+    dmodnum &operator*=(dmodnum v) { return n = BR.mul(n, v.n), *this; }
     dmodnum &operator/=(dmodnum v) { return *this *= v.inv(); }
 
     friend dmodnum operator+(dmodnum lhs, dmodnum rhs) { return lhs += rhs; }
@@ -151,3 +220,32 @@ struct dmodnum {
         return in >> n, v = dmodnum(n), in;
     }
 };
+
+/**
+ * c[i] = a[i]·b[i] mod m over arrays, for a[i],b[i] < m < 2^30. The quotient is taken in
+ * double precision, where it is off by at most one, and the remainder in wrapping 32-bit
+ * arithmetic, so the loop has no 64-bit products and vectorizes (8 lanes with AVX2).
+ */
+inline void mul_mod(uint32_t m, uint32_t* c, const uint32_t* a, const uint32_t* b,
+                    int n) {
+    assert(m < (1u << 30));
+    double inv = 1.0 / m;
+    for (int i = 0; i < n; i++) {
+        int32_t q = double(int32_t(a[i])) * double(int32_t(b[i])) * inv;
+        int32_t r = a[i] * b[i] - uint32_t(q) * m;
+        r += r < 0 ? int32_t(m) : 0;
+        r -= r >= int32_t(m) ? int32_t(m) : 0;
+        c[i] = r;
+    }
+}
+
+// c[i] = a[i]·b[i] for modnum or dmodnum
+template <typename Num>
+void mul_mod(vector<Num>& c, const vector<Num>& a, const vector<Num>& b) {
+    static_assert(sizeof(Num) == sizeof(uint32_t));
+    assert(a.size() == b.size());
+    c.resize(a.size());
+    mul_mod(Num::mod(), reinterpret_cast<uint32_t*>(c.data()),
+            reinterpret_cast<const uint32_t*>(a.data()),
+            reinterpret_cast<const uint32_t*>(b.data()), a.size());
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "numeric/fft.hpp"        // ntt_montgomery_levels, ntt_montgomery_columns, ...
+#include "parallel/fork_join.hpp" // thread_pool, parallel_for, parallel_invoke
+
+/**
+ * Multithreaded NTT multiplication for large inputs (10^6 and up) over the thread_pool.
+ * The number of threads is the size of the pool, with one thread or small inputs these
+ * fall back to the sequential code in fft.hpp.
+ *
+ * A transform of size 2^h is split six-step style without transposes: the first l levels
+ * run over groups of columns of a seen as 2^l rows of length 2^(h-l), then the remaining
+ * levels run on each row independently (the inverse does rows first). Rows are 64KB, and
+ * column groups are narrow, so every job works in cache.
+ *
+ * ntt_multiply(pool, a, b) multiplies modnums modulo an NTT prime < 2^30.
+ * ntt_multiply(pool, mod, a, b) multiplies modulo any mod < 2^31 with three NTT primes
+ * in parallel and Garner's CRT, exactly, as long as min(A,B)*(mod-1)^2 < 5.9e25.
+ */
+namespace fft {
+
+constexpr int ntt_parallel_row_log = 14;
+constexpr int ntt_parallel_min_size = 1 << 15;
+
+template <bool inverse, uint32_t MOD>
+void ntt_montgomery_transform(thread_pool& pool, uint32_t* a, int N) {
+    using R = ntt_montgomery_roots<MOD>;
+    R::init();
+    int h = __builtin_ctz(N);
+    assert(N == (1 << h) && h <= R::rank2 && "Modulus cannot handle NTT this large");
+    int l = max(0, h - ntt_parallel_row_log);
+    l += l & 1;
+    if (l == 0 || pool.pool_size() == 1) {
+        return ntt_montgomery_levels<inverse, MOD>(a, h, 0, 0);
+    }
+
+    int B = 1 << (h - l), W = 64;
+    auto columns = [&]() {
+        parallel_for(
+            pool, 0, B / W,
+            [&](int64_t c) {
+                ntt_montgomery_columns<inverse, MOD>(a, h, l, c * W, (c + 1) * W);
+            },
+            1);
+    };
+    auto rows = [&]() {
+        parallel_for(
+            pool, 0, 1 << l,
+            [&](int64_t r) {
+                ntt_montgomery_levels<inverse, MOD>(a + r * B, h, l, r);
+            },
+            1);
+    };
+    if constexpr (!inverse) {
+        columns(), rows();
+    } else {
+        rows(), columns();
+    }
+}
+
+// c[0,S) = a*b mod MOD in plain form, for plain inputs fa(i) in [0,MOD) and fb(i)
+template <uint32_t MOD, typename Fa, typename Fb>
+auto ntt_parallel_convolve(thread_pool& pool, int A, const Fa& fa, int B, const Fb& fb) {
+    using M = montgomery<MOD>;
+    int S = A + B - 1, N = 1 << next_two(S);
+    unique_ptr<uint32_t[]> x(new uint32_t[N]), y(new uint32_t[N]);
+
+    parallel_blocks(pool, 0, N, [&](int64_t l, int64_t r) {
+        for (int i = l; i < r; i++) {
+            x[i] = i < A ? fa(i) : 0;
+            y[i] = i < B ? fb(i) : 0;
+        }
+    });
+    parallel_invoke(
+        pool, [&]() { ntt_montgomery_transform<0, MOD>(pool, x.get(), N); },
+        [&]() { ntt_montgomery_transform<0, MOD>(pool, y.get(), N); });
+    parallel_blocks(pool, 0, N, [&](int64_t l, int64_t r) {
+        ntt_montgomery_pointwise<MOD>(x.get() + l, x.get() + l, y.get() + l, r - l);
+    });
+    ntt_montgomery_transform<1, MOD>(pool, x.get(), N);
+
+    uint32_t scale = uint64_t(modnum<MOD>(N).inv().n) * M::R2 % MOD;
+    vector<uint32_t> c(S);
+    parallel_blocks(pool, 0, S, [&](int64_t l, int64_t r) {
+        for (int i = l; i < r; i++) {
+            c[i] = M::fit(M::mul(x[i], scale));
+        }
+    });
+    return c;
+}
+
+template <uint32_t MOD>
+auto ntt_multiply(thread_pool& pool, const vector<modnum<MOD>>& a,
+                  const vector<modnum<MOD>>& b) {
+    using T = modnum<MOD>;
+    int A = a.size(), B = b.size();
+    if (pool.pool_size() == 1 || min(A, B) <= 5 || A + B - 1 < ntt_parallel_min_size) {
+        return ntt_multiply(a, b);
+    }
+    static_assert(MOD % 2 == 1 && MOD < (1u << 30));
+
+    auto c = ntt_parallel_convolve<MOD>(
+        pool, A, [&](int i) { return a[i].n; }, B, [&](int i) { return b[i].n; });
+    vector<T> res(begin(c), end(c));
+    trim_vector(res);
+    return res;
+}
+
+template <typename T>
+auto ntt_multiply(thread_pool& pool, T mod, const vector<T>& a, const vector<T>& b) {
+    constexpr uint32_t P0 = 754974721, P1 = 167772161, P2 = 469762049;
+    if (a.empty() || b.empty()) {
+        return vector<T>();
+    }
+    int A = a.size(), B = b.size();
+    int S = A + B - 1, s = next_two(S), N = 1 << s;
+    if (1.0 * A * B <= 8.0 * N * s) {
+        return naive_multiply(mod, a, b);
+    }
+    assert(1.0L * min(A, B) * (mod - 1) * (mod - 1) < 1.0L * P0 * P1 * P2);
+
+    vector<uint32_t> r0, r1, r2;
+    auto residues = [&](auto prime, vector<uint32_t>& r) {
+        constexpr uint32_t P = decltype(prime)::value;
+        auto fit = [&](T x) { // x mod mod, then mod P. mod + mod may overflow T
+            int64_t y = x % mod;
+            return uint32_t((y < 0 ? y + mod : y) % P);
+        };
+        auto fa = [&](int i) { return fit(a[i]); };
+        auto fb = [&](int i) { return fit(b[i]); };
+        r = ntt_parallel_convolve<P>(pool, A, fa, B, fb);
+    };
+    parallel_invoke(
+        pool, [&]() { residues(integral_constant<uint32_t, P0>{}, r0); },
+        [&]() {
+            parallel_invoke(
+                pool, [&]() { residues(integral_constant<uint32_t, P1>{}, r1); },
+                [&]() { residues(integral_constant<uint32_t, P2>{}, r2); });
+        });
+
+    // Garner: x = r0 + P0*t1 + P0*P1*t2, then reduce mod
+    static const auto inv0 = modnum<P1>(P0).inv();
+    static const auto inv01 = modnum<P2>(uint64_t(P0) * P1).inv();
+    const uint64_t m = mod, p0 = P0 % m, p01 = uint64_t(P0) * P1 % m;
+    vector<T> c(S);
+    parallel_blocks(pool, 0, S, [&](int64_t l, int64_t r) {
+        for (int i = l; i < r; i++) {
+            auto t1 = (modnum<P1>(r1[i]) - modnum<P1>(r0[i])) * inv0;
+            auto t2 = (modnum<P2>(r2[i]) - modnum<P2>(r0[i]) -
+                       modnum<P2>(uint64_t(P0) * t1.n)) *
+                      inv01;
+            c[i] = (r0[i] % m + p0 * t1.n % m + p01 * t2.n % m) % m;
+        }
+    });
+    trim_vector(c);
+    return c;
+}
+
+} // namespace fft
@@ -26,6 +26,22 @@ TTT auto convolve(const vector<T>& a, const vector<T>& b) {
     return fft::ntt_multiply(a, b);
 }
 
+// Operand u kept transformed for many products of size up to n, see fft::ntt_prepared
+TTT using prepared = fft::ntt_prepared<T::MOD>;
+TTT auto prepare(vector<T> u, int n) { return prepared<T>(move(u), n); }
+TTT auto convolve(const vector<T>& a, const prepared<T>& b) {
+    return fft::ntt_multiply(a, b);
+}
+
+// (a*b)[size(b)-1, size(a)), one cyclic convolution of size size(a)
+TTT auto middle_product(const vector<T>& a, const vector<T>& b) {
+    return fft::ntt_middle_product(a, b);
+}
+template <uint32_t MOD>
+auto middle_product(const fft::ntt_prepared<MOD>& a, const fft::ntt_prepared<MOD>& b) {
+    return fft::ntt_middle_product(a, b);
+}
+
 // Utility stuff, then elementary operations, then FFT and power series operations
 
 TTT int size(const vector<T>& u) { return u.size(); }
@@ -86,6 +102,11 @@ TTT auto operator/(vector<T> u, T value) { return u /= value, u; }
 TTT auto operator+(vector<T> u, const vector<T>& v) { return u += v, u; }
 TTT auto operator-(vector<T> u, const vector<T>& v) { return u -= v, u; }
 TTT auto operator*(const vector<T>& u, const vector<T>& v) { return convolve(u, v); }
+TTT auto operator*(const vector<T>& u, const prepared<T>& v) { return convolve(u, v); }
+template <uint32_t MOD>
+auto operator*(const fft::ntt_prepared<MOD>& u, const fft::ntt_prepared<MOD>& v) {
+    return fft::ntt_multiply(u, v);
+}
 
 TTT auto& pointwise_inplace(vector<T>& u, const vector<T>& o) {
     grow(u, size(o));
@@ -285,7 +306,7 @@ TTT auto operator/(vector<T> u, vector<T> v) {
         return vector<T>();
     } else {
         int n = size(u) - size(v) + 1;
-        reverse(u), reverse(v);
+        reverse(u), reverse(v), shrink(u, n);
         auto q = u * inverse(v, n);
         shrink(q, n), reverse(q), trim(q);
         return q;
@@ -293,7 +314,28 @@ TTT auto operator/(vector<T> u, vector<T> v) {
 }
 
 // Compute remainder u%v as proper polynomial division. O(n log n)
-TTT auto operator%(vector<T> u, vector<T> v) { return u -= v * (u / v), trim(u), u; }
+TTT auto operator%(vector<T> u, vector<T> v) {
+    trim(u), trim(v);
+    int B = size(v), N = 1 << fft::next_two(B);
+    if (size(u) < B) {
+        return u;
+    }
+    // v*(u/v) matches u from B-1 up, so its low B-1 terms are u folded mod x^N-1 minus
+    // the product taken mod x^N-1, a cyclic convolution of size N instead of size(u)
+    auto c = fft::ntt_cyclic_multiply(v, u / v, N);
+    for (int i = N; i < size(u); i++) {
+        u[i & (N - 1)] += u[i];
+    }
+    resize(u, B - 1);
+    for (int i = 0; i < B - 1; i++) {
+        u[i] -= c[i];
+    }
+    return trim(u), u;
+}
+
+// Remainder u%v with v prepared. The cyclic product above is smaller than size(u), so
+// this takes the polynomial back rather than reusing the transform
+TTT auto operator%(vector<T> u, const prepared<T>& v) { return move(u) % v.b; }
 
 TTT auto& operator/=(vector<T>& u, vector<T> v) { return u = u / move(v), u; }
 TTT auto& operator%=(vector<T>& u, vector<T> v) { return u = u % move(v), u; }
@@ -365,7 +407,12 @@ TTT auto kitamasa(const vector<T>& x, const vector<T>& rec, int64_t k) {
         fft::fft_doubling_inplace(Q, N);
     }
     ifft(P), ifft(Q);
-    return ret + (P * inverse(Q))[k];
+    // only the k-th coefficient of P/Q is needed, no product
+    auto R = inverse(Q, k + 1);
+    for (int i = 0; i <= k && i < size(P); i++) {
+        ret += P[i] * R[k - i];
+    }
+    return ret;
 }
 
 // Composition p(q(x)), naively quadratic, complexity O(n² log n)
@@ -413,11 +460,16 @@ TTT auto sqrt_composition(const vector<T>& p, vector<T> q, int n = -1) {
         }
     }
 
-    vector<T> ans(n), big = {1};
+    // big and small[d] are each transformed once for both products they are part of
+    auto step = prepare(small[d], 2 * n - 1);
+    vector<T> ans(n);
+    prepared<T> big = prepare(vector<T>{1}, 2 * n - 1);
     for (int i = 0; i < k; i++) {
         fi[i] = shrunk(fi[i] * big, n);
         ans += fi[i];
-        big = shrunk(big * small[d], n);
+        if (i + 1 < k) {
+            big = prepare(shrunk(big * step, n), 2 * n - 1);
+        }
     }
     return ans;
 }
@@ -577,18 +629,15 @@ namespace polymath {
 
 constexpr int MULTIEVAL_THRESHOLD = 300;
 
-TTT auto multieval(const vector<T>& p, const vector<T>& x) {
-    // Source: https://github.com/Aeren1564/Algorithms
-    int S = size(x);
-    if (size(p) <= MULTIEVAL_THRESHOLD || size(x) <= MULTIEVAL_THRESHOLD) {
-        vector<T> ans(S);
-        for (int i = 0; i < S; i++) {
-            ans[i] = eval(p, x[i]);
-        }
-        return ans;
-    }
+constexpr int SUBPRODUCT_LEAF = 32;
 
+// Subproduct tree of (x-x[i]): node u over [l,r) has children u+1 over [l,m) and v over
+// [m,r). Children are also kept prepared at their parent's size, which fits both the
+// product that builds the parent and the products with the children in the descents.
+TTT auto subproduct_tree(const vector<T>& x) {
+    int S = size(x);
     vector<vector<T>> st(2 * S);
+    vector<prepared<T>> pt(2 * S);
 
     y_combinator([&](auto self, int u, int l, int r) -> void {
         if (r - l == 1) {
@@ -596,26 +645,61 @@ TTT auto multieval(const vector<T>& p, const vector<T>& x) {
         } else {
             int m = l + ((r - l) >> 1), v = u + ((m - l) << 1);
             self(u + 1, l, m), self(v, m, r);
-            st[u] = st[u + 1] * st[v];
+            pt[u + 1] = prepare(st[u + 1], r - l + 1);
+            pt[v] = prepare(st[v], r - l + 1);
+            st[u] = pt[u + 1] * pt[v];
         }
     })(0, 0, S);
 
-    vector<T> ans(S);
-
-    y_combinator([&](auto self, int u, int l, int r, vector<T> f) -> void {
-        f %= st[u];
-        if (size(f) <= MULTIEVAL_THRESHOLD) {
+    return make_pair(move(st), move(pt));
+}
+
+// ans[i] = p(x[i]) by transposed multiplication (Tellegen). For Q_u(t) = t^|u| st[u](1/t)
+// node u carries g_u[k] = sum_j p[j+k] [t^j] 1/Q_u for k < |u|. A child gets the middle
+// product of g_u with its sibling's st, and a leaf block recovers p mod st[u] from g_u.
+TTT void subproduct_descent(const vector<T>& x, const vector<vector<T>>& st,
+                            const vector<prepared<T>>& pt, const vector<T>& p,
+                            vector<T>& ans) {
+    int S = size(x), n = size(p);
+    auto c = inverse(reversed(st[0]), n);
+    auto g0 = middle_product(resized(p, n + S - 1), reverse(c));
+
+    y_combinator([&](auto self, int u, int l, int r, vector<T> g) -> void {
+        int L = r - l;
+        if (L <= SUBPRODUCT_LEAF) {
+            vector<T> f(L);
+            for (int e = 0; e < L; e++) {
+                for (int k = e; k < L; k++) {
+                    f[e] += g[k] * st[u][e + L - k];
+                }
+            }
             for (int i = l; i < r; i++) {
                 ans[i] = eval(f, x[i]);
             }
-        } else if (r - l == 1) {
-            ans[l] = f[0];
         } else {
             int m = l + ((r - l) >> 1), v = u + ((m - l) << 1);
-            self(u + 1, l, m, f), self(v, m, r, move(f));
+            auto pg = prepare(move(g), L + 1);
+            self(u + 1, l, m, middle_product(pg, pt[v]));
+            self(v, m, r, middle_product(pg, pt[u + 1]));
         }
-    })(0, 0, S, p);
+    })(0, 0, S, move(g0));
+}
 
+TTT auto multieval(const vector<T>& p, const vector<T>& x) {
+    int S = size(x);
+    if (size(p) <= MULTIEVAL_THRESHOLD || size(x) <= MULTIEVAL_THRESHOLD) {
+        vector<T> ans(S);
+        for (int i = 0; i < S; i++) {
+            ans[i] = eval(p, x[i]);
+        }
+        return ans;
+    }
+
+    vector<vector<T>> st;
+    vector<prepared<T>> pt;
+    tie(st, pt) = subproduct_tree(x);
+    vector<T> ans(S);
+    subproduct_descent(x, st, pt, p, ans);
     return ans;
 }
 
@@ -627,33 +711,11 @@ TTT auto interpolate(const vector<T>& x, const vector<T>& y) {
         return vector<T>();
     }
 
-    vector<vector<T>> st(2 * S);
-
-    y_combinator([&](auto self, int u, int l, int r) -> void {
-        if (r - l == 1) {
-            st[u] = {-x[l], 1};
-        } else {
-            int m = l + ((r - l) >> 1), v = u + ((m - l) << 1);
-            self(u + 1, l, m), self(v, m, r);
-            st[u] = st[u + 1] * st[v];
-        }
-    })(0, 0, S);
-
+    vector<vector<T>> st;
+    vector<prepared<T>> pt;
+    tie(st, pt) = subproduct_tree(x);
     vector<T> val(S);
-
-    y_combinator([&](auto self, int u, int l, int r, vector<T> f) -> void {
-        f %= st[u];
-        if (size(f) <= MULTIEVAL_THRESHOLD) {
-            for (int i = l; i < r; i++) {
-                val[i] = eval(f, x[i]);
-            }
-        } else if (r - l == 1) {
-            val[l] = f[0];
-        } else {
-            int m = l + ((r - l) >> 1), v = u + ((m - l) << 1);
-            self(u + 1, l, m, f), self(v, m, r, move(f));
-        }
-    })(0, 0, S, derivative(st[0]));
+    subproduct_descent(x, st, pt, derivative(st[0]), val);
 
     for (int i = 0; i < S; i++) {
         val[i] = y[i] / val[i];
@@ -664,7 +726,7 @@ TTT auto interpolate(const vector<T>& x, const vector<T>& y) {
             return vector<T>{val[l]};
         } else {
             int m = l + ((r - l) >> 1), v = u + ((m - l) << 1);
-            return self(u + 1, l, m) * st[v] + self(v, m, r) * st[u + 1];
+            return self(u + 1, l, m) * pt[v] + self(v, m, r) * pt[u + 1];
         }
     })(0, 0, S);
 }
@@ -757,12 +819,12 @@ TTT auto sample_shift(vector<T> p, T delta, int m) {
             continue;
         }
         T d = 1;
-        for (auto l = n + m + i, r = 2 * n + m + i; l < r; l >>= 1, r >>= 1) {
-            if (l & 1) {
-                d *= seg[l++];
+        for (auto lo = n + m + i, hi = 2 * n + m + i; lo < hi; lo >>= 1, hi >>= 1) {
+            if (lo & 1) {
+                d *= seg[lo++];
             }
-            if (r & 1) {
-                d *= seg[--r];
+            if (hi & 1) {
+                d *= seg[--hi];
             }
         }
         res[i] = qr[n - 1 + i] * d;
@@ -0,0 +1,222 @@
+#pragma once
+
+#include "numeric/sieves.hpp" // classic_sieve
+#include "numeric/int128.hpp" // int128_t
+
+inline int64_t isqrt(int64_t x) {
+    int64_t r = sqrtl(x);
+    while (r * r > x)
+        r--;
+    while ((r + 1) * (r + 1) <= x)
+        r++;
+    return r;
+}
+
+/**
+ * Values of a function on the O(√x) distinct quotients floor(x/i), the state of the
+ * Lucy_Hedgehog and Min_25 DPs. A quotient v<=√x is stored at lo[v] and v>√x at hi[x/v].
+ */
+template <typename T>
+struct quotient_table {
+    int64_t x, r;
+    vector<T> lo, hi;
+
+    explicit quotient_table(int64_t x)
+        : x(x), r(isqrt(x)), lo(r + 1), hi(x / (r + 1) + 1) {}
+
+    T& operator[](int64_t v) { return v <= r ? lo[v] : hi[x / v]; }
+    const T& operator[](int64_t v) const { return v <= r ? lo[v] : hi[x / v]; }
+};
+
+/**
+ * Lucy_Hedgehog DP: Σ_{p<=v} f(p) over primes for every quotient v of x, for a completely
+ * multiplicative f given by f(n) and F(v) = Σ_{2<=n<=v} f(n). Starting from F, each prime
+ * p<=√x removes the sums over the numbers whose least prime factor is p:
+ *   S(v) -= f(p)·(S(v/p) - S(p-1))   for v >= p²
+ * T can be an integer type or a modnum. Requires primes[] up to √x. O(x^{3/4}/log x)
+ */
+template <typename T, typename Fn, typename Prefix>
+auto lucy_prime_sums(int64_t x, const vector<int>& primes, const Fn& f, const Prefix& F) {
+    assert(x >= 1);
+    quotient_table<T> S(x);
+    int64_t r = S.r, L = S.hi.size() - 1;
+    for (int64_t v = 1; v <= r; v++) {
+        S.lo[v] = F(v);
+    }
+    for (int64_t i = 1; i <= L; i++) {
+        S.hi[i] = F(x / i);
+    }
+    for (int64_t p : primes) {
+        if (p * p > x) {
+            break;
+        }
+        T fp = f(p), base = S.lo[p - 1];
+        for (int64_t i = 1, I = min(L, x / (p * p)); i <= I; i++) {
+            int64_t d = i * p;
+            S.hi[i] -= fp * ((d <= L ? S.hi[d] : S.lo[x / d]) - base);
+        }
+        for (int64_t v = r; v >= p * p; v--) {
+            S.lo[v] -= fp * (S.lo[v / p] - base);
+        }
+    }
+    return S;
+}
+
+/**
+ * π(x) by the Lucy_Hedgehog DP with a Fenwick tree over the small quotients.
+ * The quotients v>y, for y ~ x^{2/3}, are kept in a table of x/y entries as in
+ * lucy_prime_sums, while [2,y] is sieved for real in a bitset with a Fenwick tree of
+ * popcounts over its 64-bit words, so S(v) for v<=y is a prefix count of the numbers not
+ * yet crossed off. Each prime first updates the large table, then crosses off its
+ * multiples; the first primes cross off so many that the Fenwick tree is rebuilt instead.
+ * O(x^{2/3} log^{1/3} x) time and O(x^{2/3}) bits, π(10^13) uses ~40MB.
+ */
+int64_t prime_pi(int64_t x, const vector<int>& primes) {
+    if (x < 2) {
+        return 0;
+    }
+    int64_t r = isqrt(x);
+    int64_t y = 0.3 * pow(double(x), 2.0 / 3); // tuned at x=10^10..10^13
+    y = clamp<int64_t>(y, r, min(x, int64_t(1) << 32));
+    int64_t L = x / (y + 1), W = (y >> 6) + 1;
+
+    vector<uint64_t> bits(W, ~0ULL);
+    bits[0] &= ~3ULL, bits[W - 1] &= ~0ULL >> (63 - (y & 63));
+    vector<int64_t> fen(W + 1); // [2,y] can hold more than 2^31 survivors
+    auto rebuild = [&]() {
+        for (int64_t w = 1; w <= W; w++) {
+            fen[w] = __builtin_popcountll(bits[w - 1]);
+        }
+        for (int64_t w = 1; w <= W; w++) {
+            if (int64_t u = w + (w & -w); u <= W) {
+                fen[u] += fen[w];
+            }
+        }
+    };
+    auto count = [&](int64_t v) { // survivors in [2,v]
+        int64_t w = v >> 6;
+        int64_t c = __builtin_popcountll(bits[w] & (~0ULL >> (63 - (v & 63))));
+        for (; w > 0; w -= w & -w) {
+            c += fen[w];
+        }
+        return c;
+    };
+    auto cross_off = [&](int64_t n) {
+        if (bits[n >> 6] >> (n & 63) & 1) {
+            bits[n >> 6] &= ~(1ULL << (n & 63));
+            for (int64_t w = (n >> 6) + 1; w <= W; w += w & -w) {
+                fen[w]--;
+            }
+        }
+    };
+    rebuild();
+
+    vector<int64_t> large(L + 1);
+    for (int64_t i = 1; i <= L; i++) {
+        large[i] = x / i - 1;
+    }
+    // crossing off p's multiples one at a time costs ~(y/p)·log W, a rebuild costs W
+    int64_t dense = 64 * (64 - __builtin_clzll(W));
+    for (int64_t j = 0, P = primes.size(); j < P; j++) {
+        int64_t p = primes[j];
+        if (p * p > x) {
+            break;
+        }
+        for (int64_t i = 1, I = min(L, x / (p * p)); i <= I; i++) {
+            int64_t d = i * p;
+            large[i] -= (d <= L ? large[d] : count(x / d)) - j;
+        }
+        if (p * p > y) {
+            continue;
+        } else if (p < dense) {
+            for (int64_t n = p * p; n <= y; n += p) {
+                bits[n >> 6] &= ~(1ULL << (n & 63));
+            }
+            rebuild();
+        } else {
+            for (int64_t n = p * p; n <= y; n += p) {
+                cross_off(n);
+            }
+        }
+    }
+    return L >= 1 ? large[1] : count(x);
+}
+
+int64_t prime_pi(int64_t x) { return prime_pi(x, classic_sieve(isqrt(x))); }
+
+// Σ_{p<=x} p over primes. O(x^{3/4}/log x)
+int128_t prime_sum(int64_t x) {
+    if (x < 2) {
+        return 0;
+    }
+    auto S = lucy_prime_sums<int128_t>(
+        x, classic_sieve(isqrt(x)), [](int64_t p) { return int128_t(p); },
+        [](int64_t v) { return int128_t(v) * (v + 1) / 2 - 1; });
+    return S[x];
+}
+
+/**
+ * Min_25 sieve: Σ_{n<=x} f(n) for a multiplicative f, given g[v] = Σ_{p<=v} f(p) on the
+ * quotients of x (from lucy_prime_sums, or a combination of several tables when f(p) is
+ * a polynomial in p) and f(p,e,p^e) = f(p^e) like multiplicative_range_sieve.
+ * Recurses over the numbers whose prime factors below √x are spelled out:
+ *   S(v,j) = Σ_{1<n<=v, lpf(n)>=p_j} f(n)
+ *          = g[v] - g[p_{j-1}] + Σ_{k>=j, p_k²<=v} Σ_{e>=1, p_k^{e+1}<=v}
+ *                                 f(p_k^e)·S(v/p_k^e, k+1) + f(p_k^{e+1})
+ * Requires primes[] up to √x. ~O(x^{3/4}/log x) for x up to ~10^13
+ */
+template <typename T, typename Fn>
+T min25_sieve(const quotient_table<T>& g, const vector<int>& primes, const Fn& f) {
+    int64_t x = g.x;
+    int P = upper_bound(begin(primes), end(primes), g.r) - begin(primes);
+    auto S = [&](auto& self, int64_t v, int j) -> T {
+        T ans = g[v] - (j ? g.lo[primes[j - 1]] : T(0));
+        for (int k = j; k < P && int64_t(primes[k]) * primes[k] <= v; k++) {
+            int64_t p = primes[k], pe = p;
+            for (int e = 1; pe <= v / p; e++, pe *= p) {
+                ans += f(p, e, pe) * self(self, v / pe, k + 1) + f(p, e + 1, pe * p);
+            }
+        }
+        return ans;
+    };
+    return x >= 1 ? S(S, x, 0) + T(1) : T(0);
+}
+
+// Σ_{n<=x} phi(n)
+int128_t phi_prefix_sum(int64_t x) {
+    if (x < 1) {
+        return 0;
+    }
+    auto primes = classic_sieve(isqrt(x));
+    auto g = lucy_prime_sums<int128_t>(
+        x, primes, [](int64_t p) { return int128_t(p); },
+        [](int64_t v) { return int128_t(v) * (v + 1) / 2 - 1; });
+    auto c = lucy_prime_sums<int128_t>(
+        x, primes, [](int64_t) { return int128_t(1); }, [](int64_t v) { return v - 1; });
+    for (int64_t v = 0; v <= g.r; v++) {
+        g.lo[v] -= c.lo[v];
+    }
+    for (int64_t i = 0; i < int64_t(g.hi.size()); i++) {
+        g.hi[i] -= c.hi[i];
+    }
+    return min25_sieve(g, primes, [](int64_t p, int, int64_t pe) {
+        return int128_t(pe - pe / p);
+    });
+}
+
+// Mertens function Σ_{n<=x} mu(n)
+int64_t mertens(int64_t x) {
+    if (x < 1) {
+        return 0;
+    }
+    auto primes = classic_sieve(isqrt(x));
+    auto g = lucy_prime_sums<int64_t>(
+        x, primes, [](int64_t) { return 1; }, [](int64_t v) { return v - 1; });
+    for (auto& v : g.lo)
+        v = -v;
+    for (auto& v : g.hi)
+        v = -v;
+    return min25_sieve(g, primes, [](int64_t, int e, int64_t) -> int64_t {
+        return e == 1 ? -1 : 0;
+    });
+}
@@ -1,7 +1,7 @@
 #pragma once
 
-#include <bits/stdc++.h>
-using namespace std;
+#include "parallel/fork_join.hpp" // thread_pool, parallel_for, parallel_reduce
+#include "numeric/modnum.hpp"     // barrett
 
 // Compute all primes p<=N. This allows querying primes or number of primes in a range
 // [L,R] at most N*N. O(N log log N)
@@ -122,51 +122,266 @@ auto modinv_sieve(int N, int mod) {
     N = min(N, mod - 1);
     inv.resize(N + 1);
     inv[1] = 1;
+    barrett br(mod);
 
     for (int n = 2; n <= N; n++) {
-        inv[n] = mod - (mod / n) * inv[mod % n] % mod;
+        inv[n] = mod - br.mul(mod / n, inv[mod % n]);
     }
 
     return inv;
 }
 
-// Count primes in the range [L,R], both inclusive. Requires sieving first, such that
-// primes[] contains all primes at least up to sqrt(R). O(√R + K log log K) where K=R-L
-int count_primes(int64_t L, int64_t R, const vector<int>& primes) {
-    assert(1 <= L && L <= R);
-    vector<bool> isprime(R - L + 1, true);
+/**
+ * Segmented mod-30 wheel sieve, bit-packed: byte b holds the numbers 30b+{1,7,11,...,29}
+ * coprime to 30, so a 128KB segment covers ~3.9M numbers and stays in L2. Each sieving
+ * prime p>5 crosses off 8 progressions, one per wheel residue r of the cofactor k≡r, each
+ * a fixed bit with a stride of p bytes. Only the segment and 8 offsets per sieving prime
+ * are kept, so ranges up to ~10^12 and beyond need O(√R) memory.
+ *
+ * wheel_sieve_bytes(L, R, B0, B1, primes, fn) sieves the bytes [B0,B1) with the numbers
+ * outside [L,R] (and 1) cleared, and calls fn(B, seg, len) on each segment of bytes
+ * [B,B+len). The thread_pool overloads of count_primes/get_primes split the bytes into
+ * contiguous chunks, each sieved independently.
+ */
+constexpr int wheel30_residues[8] = {1, 7, 11, 13, 17, 19, 23, 29};
+constexpr int8_t wheel30_bit[30] = {-1, 0,  -1, -1, -1, -1, -1, 1,  -1, -1,
+                                    -1, 2,  -1, 3,  -1, -1, -1, 4,  -1, 5,
+                                    -1, -1, -1, 6,  -1, -1, -1, -1, -1, 7};
 
+// Beyond ~7*10^10 most sieving primes are larger than a segment and only skip over it,
+// so segments grow from 128KB to 512KB to amortize that
+inline int wheel30_segment_size(int64_t R) { return R < (1LL << 36) ? 1 << 17 : 1 << 19; }
+
+template <typename Fn>
+void wheel_sieve_bytes(int64_t L, int64_t R, int64_t B0, int64_t B1,
+                       const vector<int>& primes, const Fn& fn) {
+    vector<int64_t> ps, next; // next[8i+j]: offset of the next byte to cross off
+    vector<uint8_t> mask;
     for (int64_t p : primes) {
-        if (p * p > R)
+        if (p * p > R) {
             break;
-        int64_t k = max((L + p - 1) / p, p);
-        for (int64_t n = k * p; n <= R; n += p)
-            isprime[n - L] = false;
+        } else if (p > 5) {
+            int64_t k0 = max(p, (30 * B0 + p - 1) / p);
+            ps.push_back(p);
+            for (int r : wheel30_residues) {
+                int64_t k = k0 + ((r - k0) % 30 + 30) % 30;
+                next.push_back(p * k / 30 - B0);
+                mask.push_back(~(1 << wheel30_bit[p * r % 30]));
+            }
+        }
     }
-    isprime[0] = isprime[0] & (L > 1);
 
-    return count(begin(isprime), end(isprime), true);
+    int S = wheel30_segment_size(R);
+    vector<uint8_t> seg(S);
+    for (int64_t B = B0; B < B1; B += S) {
+        int len = min<int64_t>(S, B1 - B);
+        memset(seg.data(), 0xff, len);
+        for (int i = 0, P = ps.size(); i < P; i++) {
+            int64_t p = ps[i];
+            for (int j = 8 * i; j < 8 * i + 8; j++) {
+                int64_t o = next[j];
+                for (uint8_t m = mask[j]; o < len; o += p) {
+                    seg[o] &= m;
+                }
+                next[j] = o - len;
+            }
+        }
+        int64_t bl = L / 30 - B, br = R / 30 - B; // bytes holding L and R
+        for (int j = 0; j < 8; j++) {
+            if (0 <= bl && bl < len && 30 * (B + bl) + wheel30_residues[j] < L)
+                seg[bl] &= ~(1 << j);
+            if (0 <= br && br < len && 30 * (B + br) + wheel30_residues[j] > R)
+                seg[br] &= ~(1 << j);
+        }
+        if (B == 0) {
+            seg[0] &= ~1;
+        }
+        fn(B, seg.data(), len);
+    }
+}
+
+inline int64_t wheel_sieve_popcount(const uint8_t* seg, int len) {
+    int64_t cnt = 0;
+    int i = 0;
+    for (uint64_t w; i + 8 <= len; i += 8) {
+        memcpy(&w, seg + i, 8), cnt += __builtin_popcountll(w);
+    }
+    while (i < len) {
+        cnt += __builtin_popcount(seg[i++]);
+    }
+    return cnt;
+}
+
+inline void wheel_sieve_collect(int64_t B, const uint8_t* seg, int len,
+                                vector<int64_t>& out) {
+    for (int i = 0; i < len; i++) {
+        for (unsigned bits = seg[i]; bits; bits &= bits - 1) {
+            out.push_back(30 * (B + i) + wheel30_residues[__builtin_ctz(bits)]);
+        }
+    }
+}
+
+inline int wheel_small_primes(int64_t L, int64_t R) {
+    return (L <= 2 && 2 <= R) + (L <= 3 && 3 <= R) + (L <= 5 && 5 <= R);
+}
+
+// Count primes in the range [L,R], both inclusive. Requires sieving first, such that
+// primes[] contains all primes at least up to sqrt(R). O(√R + K log log K) where K=R-L
+int64_t count_primes(int64_t L, int64_t R, const vector<int>& primes) {
+    assert(1 <= L && L <= R);
+    int64_t cnt = wheel_small_primes(L, R);
+    wheel_sieve_bytes(L, R, L / 30, R / 30 + 1, primes,
+                      [&](int64_t, const uint8_t* seg, int len) {
+                          cnt += wheel_sieve_popcount(seg, len);
+                      });
+    return cnt;
 }
 
 // Get primes in the range [L,R], both inclusive. Requires sieving first, such that
 // primes[] contains all primes at least up to sqrt(R). O(√R + K log log K) where K=R-L
 auto get_primes(int64_t L, int64_t R, const vector<int>& primes) {
     assert(1 <= L && L <= R);
-    vector<bool> isprime(R - L + 1, true);
+    vector<int64_t> new_primes;
+    for (int p : {2, 3, 5}) {
+        if (L <= p && p <= R) {
+            new_primes.push_back(p);
+        }
+    }
+    wheel_sieve_bytes(L, R, L / 30, R / 30 + 1, primes,
+                      [&](int64_t B, const uint8_t* seg, int len) {
+                          wheel_sieve_collect(B, seg, len, new_primes);
+                      });
+    return new_primes;
+}
 
+// Chunks of bytes of the wheel for the parallel sieves, each sieves >= 8 segments
+inline auto wheel_sieve_chunks(const thread_pool& pool, int64_t L, int64_t R) {
+    int64_t B0 = L / 30, B1 = R / 30 + 1;
+    int64_t S = wheel30_segment_size(R);
+    int64_t chunk = max<int64_t>(8 * S, (B1 - B0) / (4 * pool.pool_size()));
+    return make_tuple(B0, B1, chunk, (B1 - B0 + chunk - 1) / chunk);
+}
+
+int64_t count_primes(thread_pool& pool, int64_t L, int64_t R, const vector<int>& primes) {
+    assert(1 <= L && L <= R);
+    auto [B0, B1, chunk, K] = wheel_sieve_chunks(pool, L, R);
+    auto count_chunks = [&, B0 = B0, B1 = B1, chunk = chunk](int64_t a, int64_t b) {
+        int64_t cnt = 0;
+        wheel_sieve_bytes(L, R, B0 + a * chunk, min(B1, B0 + b * chunk), primes,
+                          [&](int64_t, const uint8_t* seg, int len) {
+                              cnt += wheel_sieve_popcount(seg, len);
+                          });
+        return cnt;
+    };
+    return wheel_small_primes(L, R) +
+           parallel_reduce(pool, 0, K, int64_t(0), count_chunks, plus<int64_t>(), 1);
+}
+
+auto get_primes(thread_pool& pool, int64_t L, int64_t R, const vector<int>& primes) {
+    assert(1 <= L && L <= R);
+    auto [B0, B1, chunk, K] = wheel_sieve_chunks(pool, L, R);
+    vector<vector<int64_t>> found(K);
+    parallel_for(
+        pool, 0, K,
+        [&, B0 = B0, B1 = B1, chunk = chunk](int64_t k) {
+            wheel_sieve_bytes(L, R, B0 + k * chunk, min(B1, B0 + (k + 1) * chunk), primes,
+                              [&](int64_t B, const uint8_t* seg, int len) {
+                                  wheel_sieve_collect(B, seg, len, found[k]);
+                              });
+        },
+        1);
+    vector<int64_t> new_primes;
+    for (int p : {2, 3, 5}) {
+        if (L <= p && p <= R) {
+            new_primes.push_back(p);
+        }
+    }
+    for (auto& v : found) {
+        new_primes.insert(end(new_primes), begin(v), end(v));
+    }
+    return new_primes;
+}
+
+/**
+ * Segmented sieve of a multiplicative function over [L,R], with f(p,e,p^e) = f(p^e).
+ * Blocks of 2^16 numbers keep the unfactored part of each n and the product so far, each
+ * prime p<=√R divides out its power from its multiples, and what remains above 1 is a
+ * prime > √R. Requires primes[] up to sqrt(R). O(√R·K/2^16 + K log log K) where K=R-L
+ */
+constexpr int multiplicative_block = 1 << 16;
+
+template <typename T, typename Fn>
+void multiplicative_sieve_block(int64_t L, int64_t R, const vector<int>& primes,
+                                const Fn& f, T* out) {
+    int K = R - L + 1;
+    vector<int64_t> rem(K);
+    iota(begin(rem), end(rem), L);
+    fill(out, out + K, T(1));
     for (int64_t p : primes) {
-        if (p * p > R)
+        if (p * p > R) {
             break;
-        int64_t k = max((L + p - 1) / p, p);
-        for (int64_t n = k * p; n <= R; n += p)
-            isprime[n - L] = false;
+        }
+        for (int64_t i = (L + p - 1) / p * p - L; i < K; i += p) {
+            int e = 0;
+            int64_t pe = 1;
+            do {
+                rem[i] /= p, e++, pe *= p;
+            } while (rem[i] % p == 0);
+            out[i] *= f(p, e, pe);
+        }
     }
+    for (int i = 0; i < K; i++) {
+        if (rem[i] > 1) {
+            out[i] *= f(rem[i], 1, rem[i]);
+        }
+    }
+}
 
-    vector<int64_t> new_primes;
-    for (int64_t n = L; n <= R; n++)
-        if (isprime[n - L])
-            new_primes.push_back(n);
-    return new_primes;
+template <typename T, typename Fn>
+auto multiplicative_range_sieve(int64_t L, int64_t R, const vector<int>& primes,
+                                const Fn& f) {
+    assert(1 <= L && L <= R);
+    vector<T> out(R - L + 1);
+    for (int64_t l = L; l <= R; l += multiplicative_block) {
+        int64_t r = min(R, l + multiplicative_block - 1);
+        multiplicative_sieve_block<T>(l, r, primes, f, out.data() + (l - L));
+    }
+    return out;
+}
+
+template <typename T, typename Fn>
+auto multiplicative_range_sieve(thread_pool& pool, int64_t L, int64_t R,
+                                const vector<int>& primes, const Fn& f) {
+    assert(1 <= L && L <= R);
+    vector<T> out(R - L + 1);
+    int64_t K = (R - L) / multiplicative_block + 1;
+    parallel_for(
+        pool, 0, K,
+        [&](int64_t k) {
+            int64_t l = L + k * multiplicative_block;
+            int64_t r = min(R, l + multiplicative_block - 1);
+            multiplicative_sieve_block<T>(l, r, primes, f, out.data() + (l - L));
+        },
+        1);
+    return out;
+}
+
+// phi(n) of all n in [L,R]
+auto range_phi_sieve(int64_t L, int64_t R, const vector<int>& primes) {
+    return multiplicative_range_sieve<int64_t>(
+        L, R, primes, [](int64_t p, int, int64_t pe) { return pe - pe / p; });
+}
+
+// mu(n) of all n in [L,R]
+auto range_mobius_sieve(int64_t L, int64_t R, const vector<int>& primes) {
+    return multiplicative_range_sieve<int8_t>(
+        L, R, primes, [](int64_t, int e, int64_t) { return e == 1 ? -1 : 0; });
+}
+
+// Number of divisors of all n in [L,R]
+auto range_num_divisors_sieve(int64_t L, int64_t R, const vector<int>& primes) {
+    return multiplicative_range_sieve<int>(L, R, primes,
+                                           [](int64_t, int e, int64_t) { return e + 1; });
 }
 
 // Get all primes that divide at least one number in the range [L,R]. Requires sieving
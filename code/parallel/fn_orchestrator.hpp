@@ -2,7 +2,7 @@
 
 #include "struct/integer_lists.hpp"          // linked_lists
 #include "parallel/priority_thread_pool.hpp" // priority_thread_pool
-#include "parallel/spinlock.hpp"             // concurrent_queue
+#include "parallel/mpmc_queue.hpp"           // mpmc_queue
 
 /**
  * An orchestrator is like classic unix make.
@@ -44,8 +44,8 @@
  *
  * In this implementation, the main thread is greedy and will search for runnable jobs
  * until the memory requirements of the dependency tracking exceed 2N + T^2 integers,
- * where T is the number of threads. Also, the concurrent queue makes it so that no real
- * synchronization is needed between the runners and the main thread.
+ * where T is the number of threads. Also, the lock-free done queue makes it so that no
+ * real synchronization is needed between the runners and the main thread.
  * If the jobs don't run too quickly, this requires O(N + T^2) memory and at any point
  * guarantees at least O(N^1/2) of the pending jobs have their dependencies completely
  * determined. Also, the nodes are processed by priority, which is their number of
@@ -79,7 +79,7 @@ struct fn_orchestrator {
         vector<vector<int>> dependents(N);
         linked_lists open(1, N); // 1 list only
         priority_thread_pool<int> pool(nthreads);
-        concurrent_queue<int> done(N);
+        mpmc_queue<int> done(N);
         unsigned long heavy = 0;
         const unsigned long maxmem = 1L * nthreads * nthreads + 2L * N;
 
@@ -94,8 +94,7 @@ struct fn_orchestrator {
                 auto needed = max(1ul, (heavy - maxmem) / N);
                 pool.wait_for(needed);
             }
-            while (!done.empty()) {
-                int u = done.pop();
+            for (int u; done.try_pop(u);) {
                 for (int w : dependents[u]) {
                     if (--cnt[w] == 0) {
                         int priority = dependents[w].size();
@@ -124,8 +123,7 @@ struct fn_orchestrator {
 
         while (heavy > 0) {
             pool.wait_for(1);
-            while (!done.empty()) {
-                int u = done.pop();
+            for (int u; done.try_pop(u);) {
                 for (int w : dependents[u]) {
                     if (--cnt[w] == 0) {
                         int priority = dependents[w].size();
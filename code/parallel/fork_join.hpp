@@ -0,0 +1,323 @@
+#pragma once
+
+#include "parallel/thread_pool.hpp" // thread_pool
+#include "algo/sort.hpp"            // radix_sort_idx, radix_sort_buf, ...
+
+/**
+ * Fork-join data-parallel primitives over the work-stealing thread_pool.
+ *
+ * Ranges [L,R) are split recursively in halves until they are at most grain long, the
+ * left half runs on the calling thread and the right half is submitted to the pool. The
+ * caller then helps run pending jobs until the right half is done, so these may be nested
+ * freely inside jobs. If grain is not given it is picked so there are ~8 blocks/thread.
+ *
+ * The split points depend only on L, R and grain, never on scheduling, so reductions and
+ * scans combine in a fixed tree order and floating point results are reproducible for a
+ * fixed grain.
+ */
+inline namespace parallel_fork_join {
+
+inline int64_t default_grain(const thread_pool& pool, int64_t N) {
+    return max<int64_t>(1, N / (8 * pool.pool_size()));
+}
+
+// Run f() and g() in parallel, return when both are done
+template <typename F, typename G>
+void parallel_invoke(thread_pool& pool, F&& f, G&& g) {
+    atomic<bool> done = false;
+    pool.submit([&]() { g(), done.store(true, memory_order_release); });
+    f();
+    pool.help_until([&]() { return done.load(memory_order_acquire); });
+}
+
+// Call fn(l,r) over disjoint blocks [l,r) of [L,R) of length at most grain
+template <typename Fn>
+void parallel_blocks(thread_pool& pool, int64_t L, int64_t R, const Fn& fn,
+                     int64_t grain = 0) {
+    grain = grain > 0 ? grain : default_grain(pool, R - L);
+    auto recurse = [&](auto& self, int64_t l, int64_t r) -> void {
+        if (r - l <= grain) {
+            if (l < r)
+                fn(l, r);
+            return;
+        }
+        int64_t m = l + (r - l) / 2;
+        parallel_invoke(
+            pool, [&]() { self(self, l, m); }, [&]() { self(self, m, r); });
+    };
+    recurse(recurse, L, R);
+}
+
+// Call fn(i) for every i in [L,R)
+template <typename Fn>
+void parallel_for(thread_pool& pool, int64_t L, int64_t R, const Fn& fn,
+                  int64_t grain = 0) {
+    parallel_blocks(
+        pool, L, R,
+        [&](int64_t l, int64_t r) {
+            for (int64_t i = l; i < r; i++) {
+                fn(i);
+            }
+        },
+        grain);
+}
+
+/**
+ * Reduce map(l,r) over blocks [l,r) of [L,R) with the associative combine(a,b).
+ * Blocks are combined in a balanced tree whose shape depends only on L, R and grain.
+ * Returns combine(init, reduction), or init if the range is empty.
+ */
+template <typename T, typename Map, typename Combine>
+T parallel_reduce(thread_pool& pool, int64_t L, int64_t R, T init, const Map& map,
+                  const Combine& combine, int64_t grain = 0) {
+    grain = grain > 0 ? grain : default_grain(pool, R - L);
+    auto recurse = [&](auto& self, int64_t l, int64_t r) -> T {
+        if (r - l <= grain) {
+            return map(l, r);
+        }
+        int64_t m = l + (r - l) / 2;
+        optional<T> a, b;
+        parallel_invoke(
+            pool, [&]() { a = self(self, l, m); }, [&]() { b = self(self, m, r); });
+        return combine(move(*a), move(*b));
+    };
+    return L < R ? combine(move(init), recurse(recurse, L, R)) : init;
+}
+
+/**
+ * Inclusive scan out[i] = init op a[0] op ... op a[i] with the associative op.
+ * Two passes over fixed blocks of length grain: block totals in parallel, a sequential
+ * scan over the totals, then each block is scanned from its offset in parallel.
+ * out may alias first.
+ */
+template <typename I, typename O, typename T, typename BinOp>
+void parallel_scan(thread_pool& pool, I first, I last, O out, T init, const BinOp& op,
+                   int64_t grain = 0) {
+    int64_t N = last - first;
+    grain = grain > 0 ? grain : default_grain(pool, N);
+    int64_t K = (N + grain - 1) / grain;
+    vector<optional<T>> sums(K);
+
+    parallel_for(
+        pool, 0, K,
+        [&](int64_t k) {
+            int64_t l = k * grain, r = min(N, l + grain);
+            T sum = first[l];
+            for (int64_t i = l + 1; i < r; i++) {
+                sum = op(move(sum), first[i]);
+            }
+            sums[k] = move(sum);
+        },
+        1);
+
+    for (int64_t k = 0; k < K; k++) {
+        auto next = op(init, *sums[k]);
+        sums[k] = move(init), init = move(next);
+    }
+
+    parallel_for(
+        pool, 0, K,
+        [&](int64_t k) {
+            int64_t l = k * grain, r = min(N, l + grain);
+            T sum = move(*sums[k]);
+            for (int64_t i = l; i < r; i++) {
+                sum = op(move(sum), first[i]);
+                out[i] = sum;
+            }
+        },
+        1);
+}
+
+/**
+ * Stable parallel mergesort. Halves are sorted in parallel, then merged by a parallel
+ * merge that splits the larger run at its median and the smaller run by binary search.
+ */
+template <typename I, typename Compare = less<>>
+void parallel_sort(thread_pool& pool, I first, I last, const Compare& comp = Compare(),
+                   int64_t grain = 0) {
+    using T = typename iterator_traits<I>::value_type;
+    int64_t N = last - first;
+    grain = max<int64_t>(grain > 0 ? grain : default_grain(pool, N), 64);
+    vector<T> buf(N);
+
+    // merge a[0,n) with b[0,m) into out, elements of a go first on ties
+    auto merge = [&](auto& self, auto a, int64_t n, auto b, int64_t m, auto out) -> void {
+        if (n + m <= grain) {
+            std::merge(make_move_iterator(a), make_move_iterator(a + n),
+                       make_move_iterator(b), make_move_iterator(b + m), out, comp);
+            return;
+        }
+        if (n >= m) {
+            int64_t i = n / 2;
+            int64_t j = lower_bound(b, b + m, a[i], comp) - b;
+            out[i + j] = move(a[i]);
+            auto c = a + i + 1, d = b + j, o = out + i + j + 1;
+            parallel_invoke(
+                pool, [&]() { self(self, a, i, b, j, out); },
+                [&]() { self(self, c, n - i - 1, d, m - j, o); });
+        } else {
+            int64_t j = m / 2;
+            int64_t i = upper_bound(a, a + n, b[j], comp) - a;
+            out[i + j] = move(b[j]);
+            auto c = a + i, d = b + j + 1, o = out + i + j + 1;
+            parallel_invoke(
+                pool, [&]() { self(self, a, i, b, j, out); },
+                [&]() { self(self, c, n - i, d, m - j - 1, o); });
+        }
+    };
+
+    // sort [l,r), leaving the result in first[l,r) if home else buf[l,r)
+    auto sort = [&](auto& self, int64_t l, int64_t r, bool home) -> void {
+        if (r - l <= grain) {
+            std::stable_sort(first + l, first + r, comp);
+            if (!home) {
+                std::move(first + l, first + r, buf.begin() + l);
+            }
+            return;
+        }
+        int64_t m = l + (r - l) / 2;
+        parallel_invoke(
+            pool, [&]() { self(self, l, m, !home); }, [&]() { self(self, m, r, !home); });
+        if (home) {
+            auto src = buf.begin();
+            merge(merge, src + l, m - l, src + m, r - m, first + l);
+        } else {
+            merge(merge, first + l, m - l, first + m, r - m, buf.begin() + l);
+        }
+    };
+
+    sort(sort, 0, N, true);
+}
+
+template <typename T>
+auto parallel_max(thread_pool& pool, const vector<T>& v, int64_t grain) {
+    return parallel_reduce(
+        pool, 0, v.size(), v[0],
+        [&](int64_t l, int64_t r) { return *max_element(begin(v) + l, begin(v) + r); },
+        [](T a, T b) { return max(a, b); }, grain);
+}
+
+/**
+ * Parallel radix sorts built on algo/sort.hpp.
+ * The most significant digit pass runs in parallel over blocks of the input: each block
+ * counts its digits, block offsets are assigned in order, each block scatters. Then the
+ * P buckets are independent and are each sorted by the sequential msb recursion.
+ */
+template <int B = 6, typename T>
+void parallel_msb_radix_sort_idx(thread_pool& pool, vector<int>& idx,
+                                 const vector<T>& dist, int64_t grain = 0) {
+    constexpr int P = 1 << B, mask = P - 1;
+    int N = dist.size(), maxd = 0;
+    idx.resize(N);
+    if (N == 0)
+        return;
+
+    grain = grain > 0 ? grain : max<int64_t>(default_grain(pool, N), 4096);
+    auto max = parallel_max(pool, dist, grain);
+    while (max > 0)
+        maxd++, max >>= B;
+    if (maxd == 0)
+        return iota(begin(idx), end(idx), 0);
+
+    const int s = B * (maxd - 1), K = (N + grain - 1) / grain;
+    vector<array<int, P>> cnt(K);
+    parallel_for(
+        pool, 0, K,
+        [&](int k) {
+            int l = k * grain, r = min<int64_t>(N, l + grain);
+            cnt[k].fill(0);
+            for (int n = l; n < r; n++) {
+                cnt[k][(dist[n] >> s) & mask]++;
+            }
+        },
+        1);
+
+    array<int, P + 1> start{};
+    for (int i = 0, sum = 0; i < P; i++) {
+        start[i] = sum;
+        for (int k = 0; k < K; k++) {
+            sum += cnt[k][i], cnt[k][i] = sum - cnt[k][i];
+        }
+    }
+    start[P] = N;
+
+    parallel_for(
+        pool, 0, K,
+        [&](int k) {
+            int l = k * grain, r = min<int64_t>(N, l + grain);
+            for (int n = l; n < r; n++) {
+                idx[cnt[k][(dist[n] >> s) & mask]++] = n;
+            }
+        },
+        1);
+
+    vector<int> buf(N);
+    parallel_for(
+        pool, 0, P,
+        [&](int i) {
+            int len = start[i + 1] - start[i];
+            msb_radix_sort_idx_recurse<B>(idx.data() + start[i], buf.data() + start[i],
+                                          len, 1, maxd, dist);
+        },
+        1);
+}
+
+template <int B = 6, typename T>
+void parallel_msb_radix_sort(thread_pool& pool, vector<T>& v, int64_t grain = 0) {
+    constexpr int P = 1 << B, mask = P - 1;
+    int N = v.size(), maxd = 0;
+    if (N <= 30)
+        return sort(begin(v), end(v));
+
+    grain = grain > 0 ? grain : max<int64_t>(default_grain(pool, N), 4096);
+    auto max = parallel_max(pool, v, grain);
+    while (max > 0)
+        maxd++, max >>= B;
+    if (maxd == 0)
+        return;
+
+    const int s = B * (maxd - 1), K = (N + grain - 1) / grain;
+    vector<array<int, P>> cnt(K);
+    unique_ptr<T[]> buf(new T[N]);
+    parallel_for(
+        pool, 0, K,
+        [&](int k) {
+            int l = k * grain, r = min<int64_t>(N, l + grain);
+            cnt[k].fill(0);
+            for (int n = l; n < r; n++) {
+                cnt[k][(v[n] >> s) & mask]++;
+                buf[n] = v[n];
+            }
+        },
+        1);
+
+    array<int, P + 1> start{};
+    for (int i = 0, sum = 0; i < P; i++) {
+        start[i] = sum;
+        for (int k = 0; k < K; k++) {
+            sum += cnt[k][i], cnt[k][i] = sum - cnt[k][i];
+        }
+    }
+    start[P] = N;
+
+    parallel_for(
+        pool, 0, K,
+        [&](int k) {
+            int l = k * grain, r = min<int64_t>(N, l + grain);
+            for (int n = l; n < r; n++) {
+                v[cnt[k][(buf[n] >> s) & mask]++] = buf[n];
+            }
+        },
+        1);
+
+    parallel_for(
+        pool, 0, P,
+        [&](int i) {
+            int len = start[i + 1] - start[i];
+            msb_radix_sort_recurse<B>(v.data() + start[i], buf.get() + start[i], len, 1,
+                                      maxd);
+        },
+        1);
+}
+
+} // namespace parallel_fork_join
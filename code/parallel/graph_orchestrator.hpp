@@ -1,7 +1,7 @@
 #pragma once
 
 #include "parallel/priority_thread_pool.hpp" // priority_thread_pool
-#include "parallel/spinlock.hpp"             // concurrent_queue
+#include "parallel/mpmc_queue.hpp"           // mpmc_queue
 
 /**
  * Check fn_orchestrator.hpp for an explanation of what an orchestrator does
@@ -9,11 +9,26 @@
  * The second orchestrator version uses an explicit graph. The amount of work done in
  * the the main thread is O(E) locks/unlocks, where E is the number of edges in the
  * graph. Cycles are allowed to exist: nodes in cycles are simply ignored.
+ *
+ * Ready jobs are started by priority. If job cost estimates are given with set_costs()
+ * the priority of u is its bottom level, the cost of the longest path starting at u
+ * (HLFET / critical path list scheduling), so long chains start early. Ties, and all
+ * jobs if no costs are given, are broken by number of dependents.
+ *
+ * Every concurrent_make() records the start/end time and thread of each job, which can
+ * be exported with chrome_trace() and loaded in chrome://tracing or Perfetto.
  */
 struct graph_orchestrator {
+    struct job_trace {
+        int64_t start = -1, end = -1; // nanoseconds since the start of concurrent_make
+        int thread = -1;              // [0...nthreads)
+    };
+
   private:
-    int N, E;
+    int N, E, nthreads = 0;
     vector<int> adj, off, deps;
+    vector<double> cost;
+    vector<job_trace> traces;
 
     auto toposort() const {
         vector<int> cnt(N, 0), dfs;
@@ -46,6 +61,25 @@ struct graph_orchestrator {
 
     bool verify() const { return int(toposort().size()) == N; }
 
+    void set_costs(vector<double> job_costs) {
+        assert(int(job_costs.size()) == N);
+        cost = move(job_costs);
+    }
+
+    // Cost of the longest path starting at each node (its bottom level), 0 without costs
+    auto bottom_levels() const {
+        vector<double> level(N, 0);
+        auto order = toposort();
+        for (int i = int(order.size()) - 1; i >= 0; i--) {
+            int u = order[i];
+            for (int j = off[u]; j < off[u + 1]; j++) {
+                level[u] = max(level[u], level[adj[j]]);
+            }
+            level[u] += cost.empty() ? 0 : cost[u];
+        }
+        return level;
+    }
+
     template <typename Fn>
     void sequential_make(const Fn& job) {
         for (int u : toposort())
@@ -53,30 +87,94 @@ struct graph_orchestrator {
     }
 
     template <typename Fn>
-    void concurrent_make(const Fn& job, int nthreads) {
+    void concurrent_make(const Fn& job, int threads) {
+        using priority_t = pair<double, int>;
         vector<int> cnt(N, 0);
-        priority_thread_pool<int> pool(nthreads);
-        concurrent_queue<int> done(N);
+        priority_thread_pool<priority_t> pool(threads);
+        mpmc_queue<int> done(N);
+        vector<thread::id> ids(N);
         int seen = 0;
 
-        auto runner = [&job, &done](int u) { job(u), done.push(u); };
+        auto level = bottom_levels();
+        auto priority = [&](int u) { return priority_t(level[u], off[u + 1] - off[u]); };
+
+        nthreads = threads;
+        traces.assign(N, job_trace());
+        auto epoch = chrono::steady_clock::now();
+        auto since = [epoch]() {
+            auto elapsed = chrono::steady_clock::now() - epoch;
+            return chrono::duration_cast<chrono::nanoseconds>(elapsed).count();
+        };
+
+        auto runner = [&](int u) {
+            traces[u].start = since();
+            job(u);
+            traces[u].end = since();
+            ids[u] = this_thread::get_id();
+            done.push(u);
+        };
 
         for (int u = 0; u < N; u++)
             if (deps[u] == 0)
-                pool.submit(off[u + 1] - off[u], runner, u), seen++;
+                pool.submit(priority(u), runner, u), seen++;
 
         while (seen < N) {
             pool.wait_for(1);
-            while (!done.empty()) {
-                int u = done.pop();
+            for (int u; done.try_pop(u);) {
                 for (int i = off[u]; i < off[u + 1]; i++) {
                     int v = adj[i];
                     if (++cnt[v] == deps[v])
-                        pool.submit(off[v + 1] - off[v], runner, v), seen++;
+                        pool.submit(priority(v), runner, v), seen++;
                 }
             }
         }
 
         pool.finish();
+
+        map<thread::id, int> thread_index;
+        for (int u = 0; u < N; u++) {
+            if (traces[u].end >= 0) {
+                auto [it, _] = thread_index.emplace(ids[u], thread_index.size());
+                traces[u].thread = it->second;
+            }
+        }
+    }
+
+    // Traces of the last concurrent_make(), jobs that did not run have thread=-1
+    const auto& trace() const { return traces; }
+
+    int64_t makespan() const {
+        int64_t end = 0;
+        for (const auto& t : traces)
+            end = max(end, t.end);
+        return end;
+    }
+
+    // Fraction of the makespan that the threads of the last concurrent_make() were busy
+    double utilization() const {
+        int64_t busy = 0;
+        for (const auto& t : traces)
+            busy += t.thread >= 0 ? t.end - t.start : 0;
+        return makespan() > 0 ? 1.0 * busy / (1.0 * nthreads * makespan()) : 0.0;
+    }
+
+    // Chrome trace event format, one complete event per job, times in microseconds
+    string chrome_trace() const {
+        string s = "{\"traceEvents\":[";
+        bool first = true;
+        for (int u = 0; u < N; u++) {
+            if (const auto& t = traces[u]; t.thread >= 0) {
+                s += first ? "\n" : ",\n";
+                s += "{\"name\":\"" + to_string(u) + "\",\"ph\":\"X\",\"pid\":0";
+                s += ",\"tid\":" + to_string(t.thread);
+                s += ",\"ts\":" + to_string(t.start / 1e3);
+                s += ",\"dur\":" + to_string((t.end - t.start) / 1e3);
+                if (!cost.empty()) {
+                    s += ",\"args\":{\"cost\":" + to_string(cost[u]) + "}";
+                }
+                s += "}", first = false;
+            }
+        }
+        return s + "\n]}\n";
     }
 };
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <bits/stdc++.h>
+using namespace std;
+
+/**
+ * Lock-free bounded multi-producer multi-consumer queue (Vyukov).
+ * The capacity is rounded up to a power of two and the ring wraps around, so memory is
+ * bounded by the number of items in flight rather than the number ever pushed.
+ *
+ * Each cell carries a sequence number: cell i is writable by the producer that claimed
+ * position p when seq=p, and readable by the consumer that claimed p when seq=p+1. A
+ * claim is a single CAS on head (producers) or tail (consumers), which live on separate
+ * cache lines.
+ *
+ * try_push/try_pop never block and fail if the queue is full/empty.
+ * push/pop spin until they succeed, yielding every N failed attempts.
+ */
+template <typename T, unsigned N = 16>
+struct mpmc_queue {
+  private:
+    struct cell_t {
+        atomic<size_t> seq;
+        T data;
+    };
+
+    unique_ptr<cell_t[]> buf;
+    size_t mask;
+    alignas(64) atomic<size_t> head = 0; // next position to push
+    alignas(64) atomic<size_t> tail = 0; // next position to pop
+
+    static size_t ceil_pow2(size_t n) {
+        size_t c = 2;
+        while (c < n)
+            c <<= 1;
+        return c;
+    }
+
+  public:
+    explicit mpmc_queue(size_t capacity)
+        : buf(new cell_t[ceil_pow2(capacity)]), mask(ceil_pow2(capacity) - 1) {
+        for (size_t i = 0; i <= mask; i++) {
+            buf[i].seq.store(i, memory_order_relaxed);
+        }
+    }
+    mpmc_queue(const mpmc_queue&) = delete;
+    mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+    size_t capacity() const { return mask + 1; }
+
+    // Approximate under contention
+    size_t size() const {
+        size_t t = tail.load(memory_order_relaxed), h = head.load(memory_order_relaxed);
+        return h > t ? h - t : 0;
+    }
+    bool empty() const { return size() == 0; }
+
+    template <typename U>
+    bool try_push(U&& val) {
+        size_t pos = head.load(memory_order_relaxed);
+        while (true) {
+            cell_t& cell = buf[pos & mask];
+            size_t seq = cell.seq.load(memory_order_acquire);
+            auto dif = intptr_t(seq) - intptr_t(pos);
+            if (dif == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                    cell.data = forward<U>(val);
+                    cell.seq.store(pos + 1, memory_order_release);
+                    return true;
+                }
+            } else if (dif < 0) {
+                return false;
+            } else {
+                pos = head.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    bool try_pop(T& val) {
+        size_t pos = tail.load(memory_order_relaxed);
+        while (true) {
+            cell_t& cell = buf[pos & mask];
+            size_t seq = cell.seq.load(memory_order_acquire);
+            auto dif = intptr_t(seq) - intptr_t(pos + 1);
+            if (dif == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                    val = move(cell.data);
+                    cell.seq.store(pos + mask + 1, memory_order_release);
+                    return true;
+                }
+            } else if (dif < 0) {
+                return false;
+            } else {
+                pos = tail.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    template <typename U>
+    void push(U&& val) {
+        for (unsigned count = 0; !try_push(forward<U>(val));) {
+            if (++count == N) {
+                this_thread::yield();
+                count = 0;
+            }
+        }
+    }
+
+    T pop() {
+        T val;
+        for (unsigned count = 0; !try_pop(val);) {
+            if (++count == N) {
+                this_thread::yield();
+                count = 0;
+            }
+        }
+        return val;
+    }
+};
@@ -5,8 +5,9 @@ using namespace std;
 
 /**
  * Thread pool that can be used by multiple threads; jobs processed in FIFO order.
+ * Every job goes through a single mutex-guarded queue, so only coarse jobs scale well.
  */
-struct thread_pool {
+struct fifo_thread_pool {
   private:
     using job_t = function<void()>;
     using queue_t = queue<job_t, list<job_t>>;
@@ -49,14 +50,14 @@ struct thread_pool {
     }
 
   public:
-    explicit thread_pool(int nthreads) {
+    explicit fifo_thread_pool(int nthreads) {
         assert(nthreads > 0);
         threads.reserve(nthreads);
         for (int id = 0; id < nthreads; id++)
             init_thread();
     }
 
-    ~thread_pool() noexcept { cancel(); }
+    ~fifo_thread_pool() noexcept { cancel(); }
 
     /**
      * Submit a job to be run.
@@ -165,3 +166,370 @@ struct thread_pool {
     inline int pool_size() const noexcept { return threads.size(); }
     inline bool empty() const noexcept { return pending() == 0; }
 };
+
+/**
+ * Chase-Lev work-stealing deque of trivially copyable items (job pointers).
+ * The owner thread pushes and pops at the bottom (LIFO), any thread steals from the top.
+ * The ring grows on demand, and retired rings are kept alive until destruction because a
+ * concurrent thief may still be reading from them.
+ * Follows Le, Pop, Cohen, Nardelli: Correct and Efficient Work-Stealing for Weak Memory.
+ */
+template <typename T>
+struct work_stealing_deque {
+    static_assert(is_trivially_copyable_v<T>);
+
+  private:
+    struct ring {
+        int64_t mask;
+        unique_ptr<atomic<T>[]> buf;
+        explicit ring(int64_t cap) : mask(cap - 1), buf(new atomic<T>[cap]) {}
+        int64_t capacity() const { return mask + 1; }
+        T get(int64_t i) const { return buf[i & mask].load(memory_order_relaxed); }
+        void put(int64_t i, T x) { buf[i & mask].store(x, memory_order_relaxed); }
+    };
+
+    alignas(64) atomic<int64_t> top;
+    alignas(64) atomic<int64_t> bottom;
+    atomic<ring*> arr;
+    vector<unique_ptr<ring>> rings; // owner only
+
+    ring* grow(ring* a, int64_t b, int64_t t) {
+        auto bigger = make_unique<ring>(2 * a->capacity());
+        for (int64_t i = t; i < b; i++)
+            bigger->put(i, a->get(i));
+        rings.push_back(move(bigger));
+        arr.store(rings.back().get(), memory_order_release);
+        return rings.back().get();
+    }
+
+  public:
+    explicit work_stealing_deque(int64_t cap = 256) : top(0), bottom(0) {
+        assert(cap > 0 && (cap & (cap - 1)) == 0);
+        rings.push_back(make_unique<ring>(cap));
+        arr.store(rings.back().get(), memory_order_relaxed);
+    }
+    work_stealing_deque(const work_stealing_deque&) = delete;
+    work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+    // Approximate, may be stale by the time it is returned
+    int64_t size() const {
+        int64_t b = bottom.load(memory_order_relaxed), t = top.load(memory_order_relaxed);
+        return max<int64_t>(0, b - t);
+    }
+    bool empty() const { return size() == 0; }
+
+    // Owner only
+    void push(T x) {
+        int64_t b = bottom.load(memory_order_relaxed);
+        int64_t t = top.load(memory_order_acquire);
+        ring* a = arr.load(memory_order_relaxed);
+        if (b - t > a->capacity() - 1) {
+            a = grow(a, b, t);
+        }
+        a->put(b, x);
+        atomic_thread_fence(memory_order_release);
+        bottom.store(b + 1, memory_order_relaxed);
+    }
+
+    // Owner only
+    bool pop(T& x) {
+        int64_t b = bottom.load(memory_order_relaxed) - 1;
+        ring* a = arr.load(memory_order_relaxed);
+        bottom.store(b, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        int64_t t = top.load(memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, memory_order_relaxed);
+            return false;
+        }
+        x = a->get(b);
+        if (t == b) {
+            bool won = top.compare_exchange_strong(t, t + 1, memory_order_seq_cst,
+                                                   memory_order_relaxed);
+            bottom.store(b + 1, memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // Any thread
+    bool steal(T& x) {
+        int64_t t = top.load(memory_order_acquire);
+        atomic_thread_fence(memory_order_seq_cst);
+        int64_t b = bottom.load(memory_order_acquire);
+        if (t >= b) {
+            return false;
+        }
+        ring* a = arr.load(memory_order_acquire);
+        x = a->get(t);
+        return top.compare_exchange_strong(t, t + 1, memory_order_seq_cst,
+                                           memory_order_relaxed);
+    }
+};
+
+/**
+ * Work-stealing thread pool that can be used by multiple threads; no ordering guarantees.
+ * Each worker owns a Chase-Lev deque: jobs submitted from inside a job are pushed to and
+ * popped from the bottom of the running worker's deque (LIFO), idle workers steal from
+ * the top of a random victim's deque. Jobs submitted from outside the pool go to one of
+ * a few sharded inboxes which workers drain in FIFO order.
+ * Same interface as fifo_thread_pool. Do not wait() from inside a job.
+ */
+struct thread_pool {
+  private:
+    using job_t = function<void()>;
+    enum pool_status : uint8_t { ready, cancelled, invalid };
+
+    struct alignas(64) worker_t {
+        work_stealing_deque<job_t*> deque;
+        uint64_t seed;
+    };
+    struct alignas(64) inbox_t {
+        mutex mtx;
+        deque<job_t*> jobs;
+    };
+    struct context_t {
+        const thread_pool* pool = nullptr;
+        int id = -1;
+    };
+
+    vector<thread> threads;
+    unique_ptr<worker_t[]> workers;
+    unique_ptr<inbox_t[]> inboxes;
+    int W, S;
+    mutable mutex mtx;
+    condition_variable cv, cv_user;
+    atomic<pool_status> state = ready;
+    atomic<int> unfinished = 0, queued = 0, sleeping = 0, waiting = 0;
+
+    static auto& context() {
+        static thread_local context_t ctx;
+        return ctx;
+    }
+    static size_t thread_hash() {
+        static thread_local size_t h = hash<thread::id>{}(this_thread::get_id());
+        return h;
+    }
+    static uint64_t xorshift(uint64_t& x) {
+        x ^= x << 13, x ^= x >> 7, x ^= x << 17;
+        return x;
+    }
+
+    bool take_inbox(int start, job_t*& job) {
+        for (int i = 0; i < S; i++) {
+            auto& inbox = inboxes[(start + i) % S];
+            lock_guard guard(inbox.mtx);
+            if (!inbox.jobs.empty()) {
+                job = inbox.jobs.front();
+                inbox.jobs.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool find_job(int id, job_t*& job) { // id=-1 for threads outside the pool
+        if (id >= 0 && workers[id].deque.pop(job)) {
+            return queued--, true;
+        }
+        if (queued.load() <= 0) {
+            return false;
+        }
+        if (take_inbox(id >= 0 ? id % S : thread_hash() % S, job)) {
+            return queued--, true;
+        }
+        static thread_local uint64_t outside_seed = thread_hash() | 1;
+        uint64_t& seed = id >= 0 ? workers[id].seed : outside_seed;
+        for (int attempt = 0; attempt < 2 * W; attempt++) {
+            int v = xorshift(seed) % W;
+            if (v != id && workers[v].deque.steal(job)) {
+                return queued--, true;
+            }
+        }
+        return false;
+    }
+
+    void run_job(job_t* job) {
+        (*job)();
+        delete job;
+        unfinished--;
+        if (waiting.load() > 0) {
+            lock_guard guard(mtx);
+            cv_user.notify_all();
+        }
+    }
+
+    void init_thread(int id) {
+        threads.emplace_back([this, id]() {
+            context() = {this, id};
+            job_t* job;
+            while (state.load() == ready) {
+                if (find_job(id, job)) {
+                    run_job(job);
+                    continue;
+                }
+                bool found = false;
+                for (int spin = 0; spin < 32 && !found; spin++) {
+                    this_thread::yield();
+                    found = find_job(id, job);
+                }
+                if (found) {
+                    run_job(job);
+                    continue;
+                }
+                unique_lock guard(mtx);
+                sleeping++;
+                cv.wait(guard, [this]() { return queued > 0 || state != ready; });
+                sleeping--;
+            }
+            context() = {};
+        });
+    }
+
+    int drain() {
+        int cnt = 0;
+        job_t* job;
+        for (int id = 0; id < W; id++) {
+            while (workers[id].deque.pop(job)) {
+                delete job, cnt++;
+            }
+        }
+        while (take_inbox(0, job)) {
+            delete job, cnt++;
+        }
+        return cnt;
+    }
+
+  public:
+    explicit thread_pool(int nthreads)
+        : workers(new worker_t[nthreads]), inboxes(new inbox_t[nthreads]), W(nthreads),
+          S(nthreads) {
+        assert(nthreads > 0);
+        threads.reserve(nthreads);
+        for (int id = 0; id < nthreads; id++) {
+            workers[id].seed = 0x9e3779b97f4a7c15 * (id + 1);
+        }
+        for (int id = 0; id < nthreads; id++)
+            init_thread(id);
+    }
+
+    ~thread_pool() noexcept { cancel(); }
+
+    /**
+     * Submit a job to be run.
+     * The function must be callable with the provided arguments.
+     * Be careful of argument scope.
+     * Jobs may submit more jobs while the pool is being cancelled; those are dropped.
+     */
+    template <typename Fn, typename... Args>
+    void submit(Fn&& fn, Args&&... args) {
+        assert(state.load() != invalid);
+        auto job = new job_t(bind(forward<Fn>(fn), forward<Args>(args)...));
+        unfinished++;
+        if (auto& ctx = context(); ctx.pool == this) {
+            workers[ctx.id].deque.push(job);
+        } else {
+            auto& inbox = inboxes[thread_hash() % S];
+            lock_guard guard(inbox.mtx);
+            inbox.jobs.push_back(job);
+        }
+        queued++;
+        if (sleeping.load() > 0) {
+            lock_guard guard(mtx);
+            cv.notify_one();
+        }
+    }
+
+    /**
+     * Block until all jobs have been executed.
+     * Afterwards the pool is empty and valid, and more jobs can be added still.
+     */
+    void wait() {
+        unique_lock guard(mtx);
+        waiting++;
+        cv_user.wait(guard, [this]() { return unfinished.load() == 0; });
+        waiting--;
+    }
+
+    /**
+     * Blocks until k more jobs have finished running.
+     * Afterwards the pool is valid, and more jobs can be added still.
+     */
+    void wait_for(int k) {
+        unique_lock guard(mtx);
+        k = max(0, unfinished.load() - k);
+        waiting++;
+        cv_user.wait(guard, [this, k]() { return unfinished.load() <= k; });
+        waiting--;
+    }
+
+    /**
+     * Blocks until there are only k jobs running or pending.
+     * If there are already <=k jobs running or pending, wait for 1 job to finish.
+     * Afterwards the pool is valid, and more jobs can be added still.
+     */
+    void wait_until(int k) {
+        unique_lock guard(mtx);
+        if (unfinished.load() == 0)
+            return;
+
+        k = max(0, min(unfinished.load() - 1, k));
+        waiting++;
+        cv_user.wait(guard, [this, k]() { return unfinished.load() <= k; });
+        waiting--;
+    }
+
+    /**
+     * Run pending jobs on the calling thread until done() holds.
+     * Unlike wait() this may be called from inside a job, to wait for jobs it submitted.
+     */
+    template <typename Pred>
+    void help_until(Pred&& done) {
+        auto& ctx = context();
+        int id = ctx.pool == this ? ctx.id : -1;
+        job_t* job;
+        while (!done()) {
+            if (find_job(id, job)) {
+                run_job(job);
+            } else {
+                this_thread::yield();
+            }
+        }
+    }
+
+    /**
+     * Block until all jobs have been executed and join with all threads.
+     * Afterwards, the pool is empty and invalid.
+     */
+    void finish() noexcept {
+        if (state.load() == invalid)
+            return;
+        wait();
+        cancel();
+    }
+
+    /**
+     * Block until all running jobs have been executed and join with all threads.
+     * Jobs pending in the job queues are not executed.
+     * Afterwards, the pool is empty and invalid.
+     */
+    void cancel() noexcept {
+        unique_lock guard(mtx);
+        if (state.load() == invalid)
+            return;
+
+        state = cancelled;
+        cv.notify_all();
+        guard.unlock();
+        for (thread& worker : threads)
+            assert(worker.joinable()), worker.join();
+
+        int dropped = drain();
+        queued -= dropped, unfinished -= dropped;
+        state = invalid;
+    }
+
+    inline int pending() const noexcept { return unfinished.load(); }
+    inline int pool_size() const noexcept { return threads.size(); }
+    inline bool empty() const noexcept { return pending() == 0; }
+};
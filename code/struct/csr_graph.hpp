@@ -0,0 +1,130 @@
+#pragma once
+
+#include <bits/stdc++.h>
+using namespace std;
+
+using edges_t = vector<array<int, 2>>;
+
+/**
+ * Static graph in compressed sparse row form. The out-arcs of u are the positions
+ * [off[u], off[u+1]) of to[] and cost[], and cost[] is empty for unweighted graphs.
+ * The whole graph is two or three allocations instead of one per vertex, an arc is 4
+ * bytes plus its cost, and the arcs of a vertex are contiguous in memory.
+ * Arcs keep their input order within each vertex, so an algorithm visits neighbours in
+ * the same order as on the vector<vector<...>> adjacency lists built from the same edges.
+ * Indices are 32-bit, so E < 2^31 arcs (an undirected edge is two arcs).
+ *
+ * Usage:
+ *   csr_graph<> g(V, edges);                            // directed, unweighted
+ *   csr_graph<long> h(V, edges, weights, true);         // undirected, weighted
+ *   for (int v : g[u]) ...                              // neighbours of u
+ *   for (int i = h.off[u]; i < h.off[u + 1]; i++) ...   // arcs u->h.to[i], h.cost[i]
+ */
+template <typename Cost = int>
+struct csr_graph {
+    int V = 0, E = 0;
+    vector<int> off, to;
+    vector<Cost> cost;
+
+    struct neighbours {
+        const int *first, *last;
+        const int* begin() const { return first; }
+        const int* end() const { return last; }
+        int size() const { return last - first; }
+    };
+
+    csr_graph() = default;
+    csr_graph(int V, const edges_t& g, bool undirected = false) {
+        assign(V, g, {}, undirected);
+    }
+    csr_graph(int V, const edges_t& g, const vector<Cost>& w, bool undirected = false) {
+        assign(V, g, w, undirected);
+    }
+    explicit csr_graph(const vector<vector<int>>& adj) {
+        int N = adj.size();
+        off.assign(N + 1, 0);
+        for (int u = 0; u < N; u++) {
+            off[u + 1] = off[u] + adj[u].size();
+        }
+        V = N, E = off[N], to.resize(E);
+        for (int u = 0; u < N; u++) {
+            copy(begin(adj[u]), end(adj[u]), begin(to) + off[u]);
+        }
+    }
+    explicit csr_graph(const vector<vector<pair<int, Cost>>>& adj) {
+        int N = adj.size();
+        off.assign(N + 1, 0);
+        for (int u = 0; u < N; u++) {
+            off[u + 1] = off[u] + adj[u].size();
+        }
+        V = N, E = off[N], to.resize(E), cost.resize(E);
+        for (int u = 0; u < N; u++) {
+            for (int i = off[u], j = 0; i < off[u + 1]; i++, j++) {
+                tie(to[i], cost[i]) = adj[u][j];
+            }
+        }
+    }
+
+    // w is empty for an unweighted graph. Edge j of an undirected g is arcs u->v and v->u
+    void assign(int N, const edges_t& g, const vector<Cost>& w, bool undirected = false) {
+        int M = g.size();
+        assert(w.empty() || int(w.size()) == M);
+        cost.resize(w.empty() ? 0 : (1 + undirected) * M);
+        if (undirected) {
+            build(N, 2 * M, [&](int a) { return g[a >> 1][a & 1]; }, [&](int a, int k) {
+                to[k] = g[a >> 1][~a & 1];
+                if (!w.empty()) {
+                    cost[k] = w[a >> 1];
+                }
+            });
+        } else {
+            build(N, M, [&](int a) { return g[a][0]; }, [&](int a, int k) {
+                to[k] = g[a][1];
+                if (!w.empty()) {
+                    cost[k] = w[a];
+                }
+            });
+        }
+    }
+
+    // Counting sort of arcs [0,A) by tail(a), stable in a. place(a, k) fills slot k
+    template <typename Tail, typename Place>
+    void build(int N, int A, Tail&& tail, Place&& place) {
+        V = N, E = A;
+        off.assign(N + 2, 0), to.resize(A);
+        for (int a = 0; a < A; a++) {
+            assert(0 <= tail(a) && tail(a) < N);
+            off[tail(a) + 2]++;
+        }
+        for (int u = 2; u <= N; u++) {
+            off[u] += off[u - 1];
+        }
+        for (int a = 0; a < A; a++) {
+            place(a, off[tail(a) + 1]++);
+        }
+        off.pop_back();
+    }
+
+    // Every arc flipped, costs kept. The new arcs of a vertex are sorted by their head
+    csr_graph reversed() const {
+        vector<int> tail(E);
+        for (int u = 0; u < V; u++) {
+            fill(begin(tail) + off[u], begin(tail) + off[u + 1], u);
+        }
+        csr_graph rev;
+        rev.cost.resize(cost.size());
+        rev.build(V, E, [&](int a) { return to[a]; }, [&](int a, int k) {
+            rev.to[k] = tail[a];
+            if (!cost.empty()) {
+                rev.cost[k] = cost[a];
+            }
+        });
+        return rev;
+    }
+
+    int size() const { return V; }
+    int degree(int u) const { return off[u + 1] - off[u]; }
+    neighbours operator[](int u) const {
+        return {to.data() + off[u], to.data() + off[u + 1]};
+    }
+};
@@ -2,12 +2,13 @@
 
 #include "splay.hpp"
 
-template <typename Node>
-struct SegSplay : basic_splay<SegSplay<Node>> {
+template <typename Node, typename Alloc = global_allocator>
+struct SegSplay : basic_splay<SegSplay<Node, Alloc>, Alloc> {
+    using Splay = SegSplay<Node, Alloc>;
     int64_t key;
     Node self, sum;
 
-    explicit SegSplay(int64_t key, Node data) : key(key), self(data), sum(sum) {}
+    explicit SegSplay(int64_t key, Node data) : key(key), self(data), sum(data) {}
 
     static auto get_key(const Splay* x) { return x->key; }
     static Node get_sum(const Splay* x) { return x ? x->sum : Node(); }
@@ -38,14 +39,15 @@ struct SegSplay : basic_splay<SegSplay<Node>> {
 };
 
 // Aggregate should be commutative and computable from only plain values
-template <typename Node>
+// The splay nodes are allocated through Alloc, see node_allocator.hpp
+template <typename Node, typename Alloc = global_allocator>
 struct dynamic_2dsegtree {
-    using Splay = SegSplay<Node>;
+    using Splay = SegSplay<Node, Alloc>;
     int R, C;
     vector<Splay*> root;
     vector<array<int, 2>> kids;
 
-    explicit dynamic_2dsegtree(int R, int C) : R(R), C(C) {}
+    explicit dynamic_2dsegtree(int R, int C) : R(R), C(C) { build_sparse(); } // 0 is null
 
     int build_sparse() {
         int u = root.size();
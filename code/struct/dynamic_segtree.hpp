@@ -203,6 +203,49 @@ struct dynamic_segtree {
         return run_meld(u, v, L, R, zero);
     }
 
+    // Mark-and-compact: keep only the nodes reachable from the given roots (rewritten in
+    // place, they may repeat), renumbered in dfs preorder so each path from a root goes
+    // forward in memory. Invalidates every other node index and empties the freelist.
+    // Returns the number of live nodes. O(#nodes)
+    int compact(vector<int>& roots) {
+        int N = num_nodes();
+        vector<int> remap(N, -1), order, stack;
+        for (int s : roots) {
+            stack.push_back(s);
+            while (!stack.empty()) {
+                int u = stack.back();
+                stack.pop_back();
+                if (remap[u] == -1) {
+                    remap[u] = order.size(), order.push_back(u);
+                    for (int k : {1, 0}) {
+                        if (int v = kids[u][k]; v != -1 && remap[v] == -1) {
+                            stack.push_back(v);
+                        }
+                    }
+                }
+            }
+        }
+
+        int S = order.size();
+        vector<Node> new_node;
+        vector<array<int, 2>> new_kids(S);
+        vector<int> new_lazy(S);
+        new_node.reserve(S);
+        for (int i = 0; i < S; i++) {
+            int u = order[i];
+            auto [a, b] = kids[u];
+            new_node.push_back(move(node[u]));
+            new_kids[i] = {a == -1 ? -1 : remap[a], b == -1 ? -1 : remap[b]};
+            new_lazy[i] = lazy[u];
+        }
+        swap(node, new_node), swap(kids, new_kids), swap(lazy, new_lazy);
+        freelist = vector<int>();
+        for (int& u : roots) {
+            u = remap[u];
+        }
+        return S;
+    }
+
   private:
     static Node combine(const Node& x, const Node& y) {
         Node ans;
@@ -210,6 +210,85 @@ struct pairing_int_heap {
     }
 };
 
+/**
+ * Monotone radix heap over the integers [0...N) with decrease-key, for unsigned integer
+ * keys read from a container like less_container (e.g. dijkstra's dist).
+ * The keys pushed or improved must not go below the key of the last pop, which holds for
+ * dijkstra with non-negative costs. u sits in bucket bit_width(key[u] ^ last) so bucket 0
+ * holds the keys equal to last. When it runs out, pop finds the first nonempty bucket,
+ * takes its minimum as the new last and spreads it into lower buckets. An element only
+ * moves down, so pop is O(log C) amortized for keys up to C and push/improve are O(1).
+ */
+template <typename Container>
+struct radix_int_heap {
+    static constexpr int B = 65;
+    const Container* key = nullptr;
+    uint64_t last = 0;
+    int S = 0;
+    array<vector<int>, B> bucket;
+    vector<int> where, pos, scratch; // where[u]=-1 if u is not in the heap
+
+    explicit radix_int_heap(int N, const Container& key)
+        : key(&key), where(N, -1), pos(N) {}
+
+    bool empty() const { return S == 0; }
+    size_t size() const { return S; }
+    bool contains(int u) const { return where[u] != -1; }
+    int top() { return settle(), bucket[0].back(); }
+
+    void push(int u) { assert(!contains(u)), insert(u), S++; }
+    int pop() {
+        settle();
+        int u = bucket[0].back();
+        bucket[0].pop_back(), where[u] = -1, S--;
+        return u;
+    }
+    void improve(int u) { assert(contains(u)), remove(u), insert(u); }
+    void push_or_improve(int u) { contains(u) ? improve(u) : push(u); }
+    void clear() {
+        for (auto& b : bucket) {
+            for (int u : b) {
+                where[u] = -1;
+            }
+            b.clear();
+        }
+        S = 0, last = 0;
+    }
+
+  private:
+    uint64_t get(int u) const { return (*key)[u]; }
+    void insert(int u) {
+        uint64_t k = get(u);
+        assert(k >= last);
+        int b = k == last ? 0 : 64 - __builtin_clzll(k ^ last);
+        where[u] = b, pos[u] = bucket[b].size(), bucket[b].push_back(u);
+    }
+    void remove(int u) {
+        auto& b = bucket[where[u]];
+        int w = b.back();
+        b[pos[u]] = w, pos[w] = pos[u], b.pop_back();
+    }
+    void settle() {
+        assert(!empty());
+        if (!bucket[0].empty()) {
+            return;
+        }
+        int b = 1;
+        while (bucket[b].empty()) {
+            b++;
+        }
+        last = get(bucket[b][0]);
+        for (int u : bucket[b]) {
+            last = min(last, get(u));
+        }
+        swap(scratch, bucket[b]);
+        for (int u : scratch) {
+            insert(u);
+        }
+        scratch.clear();
+    }
+};
+
 // Collection of R mergeable pairing heaps over the unique integers [0...N)
 // By default min-heaps, but you'll usually need a custom compare.
 template <typename Compare = less<>>
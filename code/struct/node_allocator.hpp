@@ -0,0 +1,168 @@
+#pragma once
+
+#include <bits/stdc++.h>
+using namespace std;
+
+/**
+ * Allocation policies for the nodes of pointer-based trees (treap, splay, slopy, ...).
+ * A node adopts a policy through the template argument of its CRTP base, which then
+ * defines class-specific operator new/delete, so `new Node(...)` and `delete node` in the
+ * tree code go through the policy unchanged. The base also stores kids/parent as
+ * Alloc::link<Node>, which is Node* for every policy except index_allocator.
+ *
+ *   global_allocator: ::operator new/delete, the default.
+ *   arena_allocator:  bump allocation from large chunks, delete is a no-op. All nodes of
+ *                     a type are freed at once with arena_allocator::release<Node>().
+ *   pool_allocator:   bump allocation plus a freelist, so deleted nodes are reused.
+ *                     release<Node>() frees every node at once too.
+ *   index_allocator:  pool over one contiguous block, links are 32-bit indices into it.
+ *                     Halves the size of the links, capacity is fixed by reserve<Node>(n)
+ *                     (default 1<<22 nodes on first use) and overflow throws bad_alloc.
+ *                     reserve<Node>(n) drops every node, like release<Node>().
+ *
+ * Usage:
+ *   struct MyTreap : basic_treap<MyTreap, pool_allocator> { ... };
+ *   ... insert/erase as usual ...
+ *   pool_allocator::release<MyTreap>(); // drop every MyTreap node, don't call delete_all
+ */
+struct global_allocator {
+    template <typename T>
+    using link = T*;
+
+    template <typename T>
+    static void* allocate() { return ::operator new(sizeof(T)); }
+    template <typename T>
+    static void deallocate(void* p) { ::operator delete(p); }
+};
+
+// Per-type chunked storage shared by arena_allocator and pool_allocator
+template <typename T>
+struct node_arena {
+    static constexpr int CHUNK = 1 << 14; // nodes per chunk
+    union slot {
+        slot* next;
+        alignas(T) unsigned char data[sizeof(T)];
+    };
+
+    static inline vector<unique_ptr<slot[]>> chunks;
+    static inline int used = CHUNK; // slots used in the last chunk
+    static inline slot* freelist = nullptr;
+
+    static void* bump() {
+        if (used == CHUNK) {
+            chunks.emplace_back(new slot[CHUNK]), used = 0;
+        }
+        return &chunks.back()[used++];
+    }
+    static void* pop() {
+        if (freelist) {
+            slot* s = freelist;
+            freelist = s->next;
+            return s;
+        }
+        return bump();
+    }
+    static void push(void* p) {
+        if (slot* s = static_cast<slot*>(p)) {
+            s->next = freelist, freelist = s;
+        }
+    }
+    static void release() { chunks.clear(), used = CHUNK, freelist = nullptr; }
+};
+
+struct arena_allocator {
+    template <typename T>
+    using link = T*;
+
+    template <typename T>
+    static void* allocate() { return node_arena<T>::bump(); }
+    template <typename T>
+    static void deallocate(void*) {}
+    template <typename T>
+    static void release() { node_arena<T>::release(); }
+};
+
+struct pool_allocator {
+    template <typename T>
+    using link = T*;
+
+    template <typename T>
+    static void* allocate() { return node_arena<T>::pop(); }
+    template <typename T>
+    static void deallocate(void* p) { node_arena<T>::push(p); }
+    template <typename T>
+    static void release() { node_arena<T>::release(); }
+};
+
+// Contiguous per-type storage addressed by 32-bit indices, index 0 is the null link
+template <typename T>
+struct node_slab {
+    static constexpr uint32_t DEFAULT_CAPACITY = 1 << 22;
+    union slot {
+        uint32_t next;
+        alignas(T) unsigned char data[sizeof(T)];
+    };
+
+    static inline unique_ptr<slot[]> data;
+    static inline uint32_t capacity = 0, used = 1, freelist = 0;
+
+    // Drops every node, like release()
+    static void reserve(uint32_t n) {
+        data.reset(new slot[n + 1]), capacity = n + 1, used = 1, freelist = 0;
+    }
+    static T* at(uint32_t i) { return reinterpret_cast<T*>(&data[i]); }
+    static uint32_t index(const T* p) {
+        return reinterpret_cast<const slot*>(p) - data.get();
+    }
+
+    static void* pop() {
+        if (freelist) {
+            uint32_t i = freelist;
+            freelist = data[i].next;
+            return &data[i];
+        }
+        if (capacity == 0) {
+            reserve(DEFAULT_CAPACITY);
+        }
+        if (used == capacity) {
+            throw bad_alloc();
+        }
+        return &data[used++];
+    }
+    static void push(void* p) {
+        if (p) {
+            uint32_t i = static_cast<slot*>(p) - data.get();
+            data[i].next = freelist, freelist = i;
+        }
+    }
+    static void release() { data.reset(), capacity = 0, used = 1, freelist = 0; }
+};
+
+// 32-bit handle that converts to and from T*, so tree code can keep using pointers
+template <typename T>
+struct index_link {
+    uint32_t i = 0;
+
+    index_link() = default;
+    index_link(nullptr_t) {}
+    index_link(T* p) : i(p ? node_slab<T>::index(p) : 0) {}
+
+    operator T*() const { return i ? node_slab<T>::at(i) : nullptr; }
+    T* operator->() const { return node_slab<T>::at(i); }
+    T& operator*() const { return *node_slab<T>::at(i); }
+};
+
+struct index_allocator {
+    template <typename T>
+    using link = index_link<T>;
+
+    template <typename T>
+    static void* allocate() { return node_slab<T>::pop(); }
+    template <typename T>
+    static void deallocate(void* p) { node_slab<T>::push(p); }
+    template <typename T>
+    static void release() { node_slab<T>::release(); }
+    template <typename T>
+    static void reserve(uint32_t n) { node_slab<T>::reserve(n); }
+};
+
@@ -215,6 +215,72 @@ struct persistent_segtree {
         return add_root(run_meld(roots[v1], roots[v2], L, R, roots[zero]));
     }
 
+    // Drop a version, its nodes are reclaimed by the next compact(). Indices are kept
+    void retire(int version) {
+        assert(0 <= version && version < versions() && roots[version] != -1);
+        roots[version] = -1;
+    }
+
+    bool is_live(int version) const { return roots[version] != -1; }
+
+    // Mark-and-compact: keep only the nodes reachable from live versions or from the node
+    // handles given (rewritten in place), renumbered in dfs preorder so each path from a
+    // root goes forward in memory. Invalidates every other node index. Returns the number
+    // of live nodes; call it when num_nodes() grows well past that, e.g. twice. O(#nodes)
+    int compact(vector<int>& handles) {
+        int N = num_nodes();
+        vector<int> remap(N, -1), order, stack;
+        auto mark = [&](int s) {
+            stack.push_back(s);
+            while (!stack.empty()) {
+                int u = stack.back();
+                stack.pop_back();
+                if (remap[u] == -1) {
+                    remap[u] = order.size(), order.push_back(u);
+                    for (int k : {1, 0}) {
+                        if (int v = kids[u][k]; v != -1 && remap[v] == -1) {
+                            stack.push_back(v);
+                        }
+                    }
+                }
+            }
+        };
+        for (int u : roots) {
+            if (u != -1) {
+                mark(u);
+            }
+        }
+        for (int u : handles) {
+            mark(u);
+        }
+
+        int S = order.size();
+        vector<Node> new_node;
+        vector<array<int, 2>> new_kids(S);
+        vector<int8_t> new_lazy(S);
+        new_node.reserve(S);
+        for (int i = 0; i < S; i++) {
+            int u = order[i];
+            auto [a, b] = kids[u];
+            new_node.push_back(move(node[u]));
+            new_kids[i] = {a == -1 ? -1 : remap[a], b == -1 ? -1 : remap[b]};
+            new_lazy[i] = lazy[u];
+        }
+        swap(node, new_node), swap(kids, new_kids), swap(lazy, new_lazy);
+        for (int& u : roots) {
+            u = u == -1 ? -1 : remap[u];
+        }
+        for (int& u : handles) {
+            u = remap[u];
+        }
+        return S;
+    }
+
+    int compact() {
+        vector<int> handles;
+        return compact(handles);
+    }
+
   private:
     static Node combine(const Node& x, const Node& y) {
         Node ans;
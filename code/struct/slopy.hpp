@@ -5,7 +5,9 @@
 // Splay tree that represents the branches of a bounded convex piecewise linear function
 // with integer slopes, dangling on an implicit vertex. Supports pointwise addition and
 // minplus convolution (small to large), inversion and evaluation in O(log n)
-struct Branch : basic_splay<Branch> {
+// Branches are allocated through branch_allocator, see node_allocator.hpp
+using branch_allocator = global_allocator; // set to pool_allocator to recycle branches
+struct Branch : basic_splay<Branch, branch_allocator> {
     using V = int64_t;
     static constexpr bool SAFE = true; // set to true to allow merging
     int size = 1, flip = 0;
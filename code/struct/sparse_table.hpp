@@ -60,6 +60,61 @@ struct min_rmq_index {
     }
 };
 
+/**
+ * Range minimum queries for ranges [a,b) in O(1) time with linear memory.
+ * Positions are split in blocks of 32. Each position i keeps a 32-bit mask of the
+ * monotonic stack of its block prefix, so the minimum of [l,i] within a block is the
+ * lowest stack bit at or after l. A min_rmq over the block minima covers the middle.
+ * Memory: N*(sizeof(T)+4) + (N/32)log(N/32)*sizeof(T), about 1.5x the input for int.
+ */
+template <typename T>
+struct block_min_rmq {
+    static constexpr int B = 32;
+    vector<T> v;
+    vector<uint32_t> mask;
+    min_rmq<T> blocks;
+
+    block_min_rmq() = default;
+    explicit block_min_rmq(const vector<T>& v) : v(v), mask(v.size()) {
+        int N = v.size();
+        vector<T> mins((N + B - 1) / B);
+        for (int s = 0; s < N; s += B) {
+            uint32_t stack = 0;
+            for (int i = s, e = min(N, s + B); i < e; i++) {
+                while (stack && !(v[s + 31 - __builtin_clz(stack)] < v[i])) {
+                    stack ^= 1u << (31 - __builtin_clz(stack));
+                }
+                mask[i] = stack |= 1u << (i - s);
+            }
+            mins[s / B] = v[s + __builtin_ctz(stack)];
+        }
+        blocks = min_rmq<T>(mins);
+    }
+
+    // query range [a,b)
+    T query(int a, int b) const {
+        // assert(a < b);
+        int x = a / B, y = (b - 1) / B;
+        if (x == y) {
+            return in_block(a, b - 1);
+        }
+        const auto& l = in_block(a, x * B + B - 1);
+        const auto& r = in_block(y * B, b - 1);
+        T ans = l < r ? l : r;
+        if (x + 1 < y) {
+            const auto& m = blocks.query(x + 1, y);
+            ans = m < ans ? m : ans;
+        }
+        return ans;
+    }
+
+  private:
+    // minimum of [l,r] within the same block
+    const T& in_block(int l, int r) const {
+        return v[l + __builtin_ctz(mask[r] >> (l % B))];
+    }
+};
+
 /**
  * Idempotent queries for ranges [a,b) in O(1) time
  * Memory: O(N log(N))
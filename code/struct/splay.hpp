@@ -1,16 +1,23 @@
 #pragma once
 
-#include <bits/stdc++.h>
-using namespace std;
+#include "node_allocator.hpp"
 
 // A splay tree with key operations (get_key()), order statistics (get_size()), lazy
 // propagation/aggregation, prev/next/parent pointers, but no persistency.
 // Most functions take a splay tree root parameter by reference as first argument, then
 // the remaining arguments should pertain to that tree
-template <typename Splay>
+// Nodes are allocated through Alloc, see node_allocator.hpp
+template <typename Splay, typename Alloc = global_allocator>
 struct basic_splay {
-    Splay* parent = nullptr;
-    Splay* kids[2] = {};
+    using link = typename Alloc::template link<Splay>;
+    link parent = nullptr;
+    link kids[2] = {};
+
+    static void* operator new(size_t size) {
+        assert(size == sizeof(Splay));
+        return Alloc::template allocate<Splay>();
+    }
+    static void operator delete(void* p) { Alloc::template deallocate<Splay>(p); }
 
   protected:
     basic_splay() = default;
@@ -100,7 +107,7 @@ struct basic_splay {
         while (u->parent && u->parent->parent) {
             u->parent->parent->pushdown(), u->parent->pushdown(), u->pushdown();
             bool zigzig = u->is_right() == u->parent->is_right();
-            rotate(zigzig ? u->parent : u), rotate(u);
+            rotate(zigzig ? static_cast<Splay*>(u->parent) : u), rotate(u);
         }
         if (u->parent) {
             u->parent->pushdown(), u->pushdown(), rotate(u);
@@ -112,7 +119,7 @@ struct basic_splay {
   public:
     Splay* clone() const {
         Splay* node = new Splay(*self());
-        node = node->parent = node->kids[0] = node->kids[1] = nullptr;
+        node->parent = node->kids[0] = node->kids[1] = nullptr;
         return node;
     }
 
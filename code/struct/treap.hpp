@@ -1,20 +1,27 @@
 #pragma once
 
-#include <bits/stdc++.h>
-using namespace std;
+#include "node_allocator.hpp"
 
 // A treap with key operations (get_key()), order statistics (get_size()) and
 // lazy propagation/aggregation, but no persistency, prev, next or parent pointers.
 // Note that you should only call treap operations like join/split on treap roots!
-template <typename Treap>
+// Nodes are allocated through Alloc, see node_allocator.hpp
+template <typename Treap, typename Alloc = global_allocator>
 struct basic_treap {
     using uniform_priod = uniform_int_distribution<uint32_t>;
+    using link = typename Alloc::template link<Treap>;
     static inline mt19937 rng = mt19937(random_device{}());
     static inline uniform_priod priod = uniform_priod(0, UINT32_MAX);
 
-    Treap* kids[2] = {};
+    link kids[2] = {};
     uint32_t priority = priod(rng);
 
+    static void* operator new(size_t size) {
+        assert(size == sizeof(Treap));
+        return Alloc::template allocate<Treap>();
+    }
+    static void operator delete(void* p) { Alloc::template deallocate<Treap>(p); }
+
   protected:
     basic_treap() : priority(priod(rng)) {}
 
@@ -80,7 +87,7 @@ struct basic_treap {
         }
     }
 
-    friend Treap* push_front(Treap*& root, Treap* item) {
+    friend Treap* push_front(Treap* root, Treap* item) {
         if (!root) {
             return item;
         }
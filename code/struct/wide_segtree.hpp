@@ -0,0 +1,341 @@
+#pragma once
+
+#include <bits/stdc++.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+using namespace std;
+
+/**
+ * Lane operations on one cache line of B = 64/sizeof(T) values, the nodes of the wide
+ * segment trees below. The generic version is scalar, int32_t and int64_t use AVX2.
+ */
+template <typename T>
+struct wide_lanes {
+    static constexpr int B = 64 / sizeof(T);
+    static_assert(B >= 2 && (B & (B - 1)) == 0);
+
+    // x[k] += delta for k >= j
+    static void add_suffix(T* x, int j, T delta) {
+        for (int k = j; k < B; k++) {
+            x[k] += delta;
+        }
+    }
+
+    // number of lanes with x[k] < v
+    static int count_less(const T* x, T v) {
+        int c = 0;
+        for (int k = 0; k < B; k++) {
+            c += x[k] < v;
+        }
+        return c;
+    }
+
+    // aggregate of x[k] over lanes k in [a,b), with identity id
+    template <bool MAX>
+    static T reduce(const T* x, int a, int b, T id) {
+        for (int k = a; k < b; k++) {
+            id = MAX ? max(id, x[k]) : min(id, x[k]);
+        }
+        return id;
+    }
+};
+
+#ifdef __AVX2__
+template <typename T>
+struct wide_lanes_avx2 {
+    using V = __m256i;
+    static constexpr int B = 64 / sizeof(T), W = 32 / sizeof(T);
+
+    // masks[j] has all bits set in lanes k >= j
+    static inline const auto masks = [] {
+        array<array<T, B>, B + 1> m = {};
+        for (int j = 0; j <= B; j++) {
+            for (int k = j; k < B; k++) {
+                m[j][k] = T(-1);
+            }
+        }
+        return m;
+    }();
+
+    static V load(const T* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+    static void store(T* p, V x) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x);
+    }
+    static V set1(T x) {
+        if constexpr (sizeof(T) == 4) {
+            return _mm256_set1_epi32(x);
+        } else {
+            return _mm256_set1_epi64x(x);
+        }
+    }
+    static V add(V a, V b) {
+        if constexpr (sizeof(T) == 4) {
+            return _mm256_add_epi32(a, b);
+        } else {
+            return _mm256_add_epi64(a, b);
+        }
+    }
+    static V cmpgt(V a, V b) {
+        if constexpr (sizeof(T) == 4) {
+            return _mm256_cmpgt_epi32(a, b);
+        } else {
+            return _mm256_cmpgt_epi64(a, b);
+        }
+    }
+
+    static void add_suffix(T* x, int j, T delta) {
+        V d = set1(delta);
+        store(x, add(load(x), _mm256_and_si256(d, load(&masks[j][0]))));
+        store(x + W, add(load(x + W), _mm256_and_si256(d, load(&masks[j][W]))));
+    }
+
+    static int count_less(const T* x, T v) {
+        V y = set1(v);
+        uint32_t lo = _mm256_movemask_epi8(cmpgt(y, load(x)));
+        uint32_t hi = _mm256_movemask_epi8(cmpgt(y, load(x + W)));
+        return (__builtin_popcount(lo) + __builtin_popcount(hi)) / sizeof(T);
+    }
+
+    template <bool MAX>
+    static T reduce(const T* x, int a, int b, T id) {
+        // blend the lanes outside [a,b) with id, then a pairwise tree reduction
+        auto pick = [](V u, V v) { return MAX ? cmpgt(u, v) : cmpgt(v, u); };
+        auto best = [&](V u, V v) { return _mm256_blendv_epi8(v, u, pick(u, v)); };
+        V e = set1(id);
+        V m0 = _mm256_andnot_si256(load(&masks[b][0]), load(&masks[a][0]));
+        V m1 = _mm256_andnot_si256(load(&masks[b][W]), load(&masks[a][W]));
+        V u = best(_mm256_blendv_epi8(e, load(x), m0),
+                   _mm256_blendv_epi8(e, load(x + W), m1));
+        u = best(u, _mm256_permute2x128_si256(u, u, 1));
+        u = best(u, _mm256_shuffle_epi32(u, 0b01001110));
+        if constexpr (sizeof(T) == 4) {
+            u = best(u, _mm256_shuffle_epi32(u, 0b10110001));
+        }
+        if constexpr (sizeof(T) == 4) {
+            return _mm256_extract_epi32(u, 0);
+        } else {
+            return _mm256_extract_epi64(u, 0);
+        }
+    }
+};
+
+template <>
+struct wide_lanes<int32_t> : wide_lanes_avx2<int32_t> {};
+template <>
+struct wide_lanes<int64_t> : wide_lanes_avx2<int64_t> {};
+#endif
+
+/**
+ * Static-shape B-ary segment tree for prefix sums (S-tree), B = 64/sizeof(T) so that a
+ * node is one cache line: 16-ary for 32-bit values and 8-ary for 64-bit values.
+ * Level h stores, for each position p of that level, the sum of the preceding siblings of
+ * p within its parent, so prefix(r) is one load per level and update_point is a masked
+ * suffix add per level. prefix_lower_bound descends with a vector compare per level.
+ * Point update and queries touch log_B(N) cache lines.
+ */
+template <typename T>
+struct sum_wide_segtree {
+    using lanes = wide_lanes<T>;
+    static constexpr int B = lanes::B, LOGB = __builtin_ctz(B);
+    struct alignas(64) block {
+        T lane[B] = {};
+    };
+
+    int n = 0;
+    vector<int> offset; // first block of each level, leaves first
+    vector<block> tree;
+
+    sum_wide_segtree() = default;
+    explicit sum_wide_segtree(int N) { assign(N); }
+    template <typename A>
+    sum_wide_segtree(int N, const vector<A>& arr, int s = 0) {
+        assign(N, arr, s);
+    }
+
+    void assign(int N) {
+        n = N, offset.clear();
+        int blocks = 0;
+        for (int64_t span = 1; span <= n; span *= B) { // level covering spans of size B^h
+            offset.push_back(blocks);
+            blocks += (n / span >> LOGB) + 1;
+        }
+        if (offset.empty()) {
+            offset.push_back(0), blocks = 1;
+        }
+        tree.assign(blocks, block());
+    }
+
+    template <typename A>
+    void assign(int N, const vector<A>& arr, int s = 0) {
+        assert(int(arr.size()) >= N + s);
+        assign(N);
+        vector<T> sums(arr.begin() + s, arr.begin() + s + N), next;
+        for (int h = 0, H = offset.size(); h < H; h++) {
+            int S = sums.size();
+            next.assign((S + B - 1) >> LOGB, T());
+            for (int k = 0; k < int(next.size()); k++) {
+                auto& x = tree[offset[h] + k].lane;
+                for (int j = 0, p = k << LOGB; j < B; j++, p++) {
+                    x[j] = next[k]; // exclusive prefix within the block
+                    next[k] += p < S ? sums[p] : T();
+                }
+            }
+            swap(sums, next);
+        }
+    }
+
+    // Add delta to position i
+    void update_point(int i, T delta) {
+        assert(0 <= i && i < n);
+        for (int h = 0, H = offset.size(); h < H; h++, i >>= LOGB) {
+            auto& x = tree[offset[h] + (i >> LOGB)].lane;
+            lanes::add_suffix(x, (i & (B - 1)) + 1, delta);
+        }
+    }
+
+    // Sum of [0,r)
+    T prefix(int r) const {
+        assert(0 <= r && r <= n);
+        T sum = T();
+        for (int h = 0, H = offset.size(); h < H; h++, r >>= LOGB) {
+            sum += tree[offset[h] + (r >> LOGB)].lane[r & (B - 1)];
+        }
+        return sum;
+    }
+
+    T query_point(int i) const { return prefix(i + 1) - prefix(i); }
+    T query_range(int l, int r) const {
+        assert(0 <= l && l <= r && r <= n);
+        return prefix(r) - prefix(l);
+    }
+    T query_all() const { return prefix(n); }
+
+    // For nonnegative values: smallest i such that prefix(i+1) >= x, or N.
+    // Returns {i, prefix(i)} like segtree::prefix_binary_search with bs(v) := x <= v.
+    pair<int, T> prefix_lower_bound(T x) const {
+        if (!(T() < x)) {
+            return {0, T()};
+        }
+        T total = query_all();
+        if (total < x) {
+            return {n, total};
+        }
+        int p = 0;
+        T sum = T();
+        for (int h = int(offset.size()) - 1; h >= 0; h--) {
+            const auto& lane = tree[offset[h] + p].lane;
+            int j = lanes::count_less(lane, x - sum) - 1; // last lane with prefix < x
+            sum += lane[j], p = p << LOGB | j;
+        }
+        return {p, sum};
+    }
+};
+
+/**
+ * Static-shape B-ary segment tree for range min (MAX=false) or max (MAX=true).
+ * Level 0 stores the values, level h+1 stores the aggregate of each block of level h.
+ * Queries reduce at most two partial blocks per level with vector blends.
+ */
+template <typename T, bool MAX>
+struct extremum_wide_segtree {
+    using lanes = wide_lanes<T>;
+    static constexpr int B = lanes::B, LOGB = __builtin_ctz(B);
+    static constexpr T ID = MAX ? numeric_limits<T>::lowest() : numeric_limits<T>::max();
+    struct alignas(64) block {
+        T lane[B];
+        block() { fill(lane, lane + B, ID); }
+    };
+
+    int n = 0;
+    vector<int> offset; // first block of each level, leaves first
+    vector<block> tree;
+
+    extremum_wide_segtree() = default;
+    explicit extremum_wide_segtree(int N) { assign(N); }
+    template <typename A>
+    extremum_wide_segtree(int N, const vector<A>& arr, int s = 0) {
+        assign(N, arr, s);
+    }
+
+    void assign(int N) {
+        n = N, offset.clear();
+        int blocks = 0, S = max(n, 1);
+        do {
+            offset.push_back(blocks);
+            S = (S + B - 1) >> LOGB, blocks += S;
+        } while (S > 1);
+        tree.assign(blocks, block());
+    }
+
+    template <typename A>
+    void assign(int N, const vector<A>& arr, int s = 0) {
+        assert(int(arr.size()) >= N + s);
+        assign(N);
+        for (int i = 0; i < N; i++) {
+            tree[i >> LOGB].lane[i & (B - 1)] = arr[i + s];
+        }
+        for (int h = 1, H = offset.size(); h < H; h++) {
+            for (int k = offset[h - 1]; k < offset[h]; k++) {
+                int p = k - offset[h - 1];
+                tree[offset[h] + (p >> LOGB)].lane[p & (B - 1)] = reduce(k, 0, B);
+            }
+        }
+    }
+
+    // Set position i to v
+    void update_point(int i, T v) {
+        assert(0 <= i && i < n);
+        tree[i >> LOGB].lane[i & (B - 1)] = v;
+        for (int h = 1, H = offset.size(); h < H; h++) {
+            int k = offset[h - 1] + (i >> LOGB);
+            i >>= LOGB;
+            T x = reduce(k, 0, B);
+            T& y = tree[offset[h] + (i >> LOGB)].lane[i & (B - 1)];
+            if (x == y) {
+                break;
+            }
+            y = x;
+        }
+    }
+
+    T query_point(int i) const {
+        assert(0 <= i && i < n);
+        return tree[i >> LOGB].lane[i & (B - 1)];
+    }
+
+    // Aggregate of [l,r), ID if empty
+    T query_range(int l, int r) const {
+        assert(0 <= l && l <= r && r <= n);
+        T ans = ID;
+        for (int h = 0; l < r; h++) {
+            int L = l >> LOGB, R = (r - 1) >> LOGB;
+            if (L == R) {
+                return combine(ans, reduce(offset[h] + L, l & (B - 1), r - (L << LOGB)));
+            }
+            if (l & (B - 1)) {
+                ans = combine(ans, reduce(offset[h] + L, l & (B - 1), B)), L++;
+            }
+            if (r & (B - 1)) {
+                ans = combine(ans, reduce(offset[h] + R, 0, r & (B - 1))), R--;
+            }
+            l = L, r = R + 1;
+        }
+        return ans;
+    }
+
+    T query_all() const { return query_range(0, n); }
+
+  private:
+    static T combine(T a, T b) { return MAX ? max(a, b) : min(a, b); }
+    T reduce(int k, int a, int b) const {
+        return lanes::template reduce<MAX>(tree[k].lane, a, b, ID);
+    }
+};
+
+template <typename T>
+using min_wide_segtree = extremum_wide_segtree<T, false>;
+template <typename T>
+using max_wide_segtree = extremum_wide_segtree<T, true>;
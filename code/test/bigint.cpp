@@ -31,6 +31,16 @@ array<int, m> random_ints(intd& dist) {
     return arr;
 }
 
+bigint random_limbs(int n, double neg_p = 0.0) {
+    bigint u;
+    u.nums.resize(n);
+    for (int i = 0; i < n; i++)
+        u.nums[i] = i + 1 < n ? distv(mt) : distvp(mt);
+    if (n > 0 && boold(neg_p)(mt))
+        u.flip();
+    return u;
+}
+
 template <int m>
 array<bigint, m> random_bigints(array<int, m> ns, int base = 10, double neg_p = 0.0) {
     array<bigint, m> arr;
@@ -370,6 +380,91 @@ void stress_test_div_imperfect() {
     }
 }
 
+void stress_test_mul_tiers() {
+    LOOP_FOR_DURATION_TRACKED (stress_runtime, now) {
+        print_time(now, stress_runtime, "stress test mul tiers");
+        int n = rand_unif<int>(1, cointoss(0.5) ? 300 : 5000);
+        int m = cointoss(0.5) ? n : rand_unif<int>(1, 5000);
+        auto a = random_limbs(n, 0.3), b = random_limbs(m, 0.3);
+
+        auto c = mul_schoolbook(a, b);
+        assert(c == mul_karatsuba(a, b));
+        assert(c == mul_toom3(a, b));
+        assert(c == mul_ntt(a, b));
+        assert(c == a * b);
+    }
+}
+
+void stress_test_div_newton() {
+    LOOP_FOR_DURATION_TRACKED (stress_runtime, now) {
+        print_time(now, stress_runtime, "stress test div newton");
+        int m = rand_unif<int>(2, 3000), n = rand_unif<int>(2, 3000);
+        auto a = random_limbs(max(n, m) + rand_unif<int>(0, 3000), 0.3);
+        auto b = random_limbs(n, 0.3);
+        if (cointoss(0.3)) {
+            a = b * random_limbs(m) + random_limbs(rand_unif<int>(0, n)); // near q*b
+        }
+
+        bigint q = a, p = a;
+        bigint r = div_newton(q, b);
+        bigint s = div_vec(p, b);
+        assert(q == p && r == s);
+        assert(q * b + r == a && magnitude_cmp(r, b));
+    }
+}
+
+void stress_test_conversion() {
+    intd digitsd(2000, 30000);
+
+    LOOP_FOR_DURATION_TRACKED (stress_runtime, now) {
+        print_time(now, stress_runtime, "stress test conversion");
+
+        for (int b : {2, 3, 7, 10}) {
+            auto s = random_numeric_string(digitsd(mt), b, 0.3);
+            bigint u(s, b);
+            assert(to_string(u, b) == trim_numeric_string(s));
+            assert(bigint(msbits(u), 2) == u);
+        }
+    }
+}
+
+void speed_test_mul_tiers() {
+    static vector<int> Ls = {4, 6, 8, 10, 12, 14, 16, 18, 20};
+    map<pair<string, int>, string> table;
+
+    auto bench = [&](int L, const string& name, auto&& fn) {
+        int n = 1 << L;
+        auto a = random_limbs(n), b = random_limbs(n);
+        START_ACC(mul);
+        LOOP_FOR_DURATION_OR_RUNS_TRACKED (300ms, now, 10000, runs) {
+            print_time(now, 300ms, "speed test {} limbs=2^{}", name, L);
+            START(mul);
+            auto c = fn(a, b);
+            ADD_TIME(mul);
+        }
+        table[{name, n}] = FORMAT_EACH(mul, runs);
+    };
+
+    for (int L : Ls) {
+        if (L <= 14)
+            bench(L, "schoolbook", [](auto& a, auto& b) { return mul_schoolbook(a, b); });
+        if (L <= 18)
+            bench(L, "karatsuba", [](auto& a, auto& b) { return mul_karatsuba(a, b); });
+        bench(L, "toom3", [](auto& a, auto& b) { return mul_toom3(a, b); });
+        bench(L, "ntt", [](auto& a, auto& b) { return mul_ntt(a, b); });
+        bench(L, "mul", [](auto& a, auto& b) { return a * b; });
+        if (L <= 14)
+            bench(L, "div_vec", [](auto a, auto& b) { return div_vec(a *= b, b); });
+        bench(L, "div", [](auto a, auto& b) { return div_mod(a *= b, b); });
+        bench(L, "to_string", [](auto& a, auto&) { return to_string(a); });
+        auto s = to_string(random_limbs(1 << L));
+        bench(L, "parse", [&](auto&, auto&) { return bigint(s); });
+    }
+
+    // div: (a*b)/b with 2n/n limbs; parse: from the digits of the number in to_string
+    print_time_table(table, "Bigint tiers (cols=limbs)");
+}
+
 void speed_test_pairwise_mul(int max_scale = 16) {
     const int RUNS = max_scale;
     const auto runtime = 30000ms / RUNS;
@@ -408,6 +503,7 @@ int main() {
     RUN_SHORT(unit_test_sqrt());
 
     RUN_BLOCK(speed_test_pairwise_mul());
+    RUN_BLOCK(speed_test_mul_tiers());
 
     RUN_SHORT(stress_test_sqrt());
     RUN_SHORT(stress_test_to_string());
@@ -421,5 +517,8 @@ int main() {
     RUN_SHORT(stress_test_mul_distributive());
     RUN_SHORT(stress_test_div_perfect());
     RUN_SHORT(stress_test_div_imperfect());
+    RUN_SHORT(stress_test_mul_tiers());
+    RUN_SHORT(stress_test_div_newton());
+    RUN_SHORT(stress_test_conversion());
     return 0;
 }
@@ -0,0 +1,296 @@
+#include "test_utils.hpp"
+#include "flow/cost_scaling.hpp"
+#include "flow/network_simplex.hpp"
+#include "flow/mincost_flow.hpp"
+#include "lib/graph_generator.hpp"
+#include "lib/flow.hpp"
+
+// DIMACS min format: p min V E, n u supply, a u v lower upper cost, 1-indexed nodes
+struct dimacs_min {
+    int V = 0;
+    edges_t g;
+    vector<long> lower, upper, cost, supply;
+    optional<long> answer; // from an "ans" line, if the file has one
+};
+
+auto read_dimacs_min(const string& filename) {
+    ifstream in(filename);
+    assert(in.is_open());
+    dimacs_min net;
+    for (string line; getline(in, line);) {
+        istringstream ss(line);
+        string kind;
+        ss >> kind;
+        if (kind == "p") {
+            string min;
+            int E;
+            ss >> min >> net.V >> E;
+            net.supply.assign(net.V, 0);
+        } else if (kind == "n") {
+            int u;
+            ss >> u, ss >> net.supply[u - 1];
+        } else if (kind == "a") {
+            int u, v;
+            long lower, upper, cost;
+            ss >> u >> v >> lower >> upper >> cost;
+            net.g.push_back({u - 1, v - 1});
+            net.lower.push_back(lower), net.upper.push_back(upper);
+            net.cost.push_back(cost);
+        } else if (kind == "ans") {
+            ss >> net.answer.emplace();
+        }
+    }
+    return net;
+}
+
+// The three solvers as drop-ins for the same network; returns the optimal cost
+template <typename Solver>
+auto solve_dimacs_min(const dimacs_min& net, Solver& solver) {
+    for (int e = 0, E = net.g.size(); e < E; e++) {
+        auto [u, v] = net.g[e];
+        solver.add(u, v, net.lower[e], net.upper[e], net.cost[e]);
+    }
+    for (int u = 0; u < net.V; u++) {
+        solver.set_supply(u, net.supply[u]);
+    }
+    bool feasible = solver.mincost_circulation();
+    assert(feasible);
+    return solver.get_circulation_cost();
+}
+
+// mcmflow with a super source and sink, for networks without lower bounds
+auto solve_dimacs_min_mcmflow(const dimacs_min& net) {
+    int V = net.V, s = V, t = V + 1, E = net.g.size();
+    mcmflow<long, long> mcf(V + 2);
+    long demand = 0;
+    for (int e = 0; e < E; e++) {
+        assert(net.lower[e] == 0);
+        if (net.upper[e] > 0) {
+            mcf.add(net.g[e][0], net.g[e][1], net.upper[e], net.cost[e]);
+        }
+    }
+    for (int u = 0; u < V; u++) {
+        if (net.supply[u] > 0) {
+            mcf.add(s, u, net.supply[u], 0);
+        } else if (net.supply[u] < 0) {
+            mcf.add(u, t, -net.supply[u], 0), demand -= net.supply[u];
+        }
+    }
+    mcf.spfa_init(s, t);
+    auto [flow, cost, paths] = mcf.mincost_flow(s, t);
+    assert(flow == demand);
+    return cost;
+}
+
+void stress_test_cost_scaling() {
+    auto make_graph = []() {
+        int V = rand_wide<int>(2, 100, -4);
+        double p = rand_wide<double>(0.05, 0.9, -2);
+        double alpha = rand_grav<double>(-.9, .9, 2);
+        edges_t g;
+
+        discrete_distribution<int> typed({50, 30, 20, 10, 10});
+        int type = typed(mt);
+        if (type == 0) {
+            g = random_geometric_directed(V, p, alpha);
+        } else if (type == 1) {
+            g = random_uniform_directed_connected(V, p);
+        } else if (type == 2) {
+            g = random_uniform_directed(V, p);
+            add_uniform_self_loops(V, g, 0.2);
+        } else if (type == 3) {
+            g = cycle_graph(V);
+        } else if (type == 4) {
+            g = path_graph(V);
+        }
+
+        random_relabel_graph_inplace(V, g);
+        int E = g.size();
+        int maxcost = cointoss(0.3) ? rand_unif<int>(0, 5) : 100'000;
+        auto cost = rands_wide<int>(E, -maxcost / 2, maxcost, 0);
+        auto circulation = generate_feasible_circulation<int>(V, g, {0, 100'000}, -15);
+        auto [lower, upper, flow, supply] = circulation;
+        return make_tuple(V, E, g, lower, upper, supply, cost);
+    };
+
+    LOOP_FOR_DURATION_TRACKED_RUNS (20s, now, runs) {
+        print_time(now, 20s, "stress cost scaling ({} runs)", runs);
+
+        auto [V, E, g, lower, upper, supply, cost] = make_graph();
+
+        // a tighter edge or a moved supply may make the circulation infeasible
+        if (cointoss(0.3)) {
+            for (int e = 0; e < E; e++) {
+                if (cointoss(0.1)) {
+                    upper[e] = rand_unif<int>(lower[e], upper[e]);
+                }
+            }
+        }
+        bool unbalanced = cointoss(0.3);
+        if (unbalanced) {
+            supply[rand_unif<int>(0, V - 1)] += rand_unif<int>(-100'000, 100'000);
+        }
+
+        cost_scaling<int, long> cs(V);
+        network_simplex<int, long> netw(V);
+        cs.alpha = rand_unif<int>(2, 64);
+        netw.set_pivot_rule(decltype(netw)::PivotRule(rand_unif<int>(0, 2)),
+                            rand_unif<int>(1, 4) / 2.0);
+        for (int u = 0; u < V; u++) {
+            cs.add_supply(u, supply[u]), netw.add_supply(u, supply[u]);
+        }
+        for (int e = 0; e < E; e++) {
+            auto [u, v] = g[e];
+            cs.add(u, v, lower[e], upper[e], cost[e]);
+            netw.add(u, v, lower[e], upper[e], cost[e]);
+        }
+
+        if (unbalanced) {
+            auto flow = cs.mincost_flow();
+            assert(flow == netw.mincost_flow());
+        } else {
+            bool feasible = cs.mincost_circulation();
+            assert(feasible == netw.mincost_circulation());
+        }
+        cs.verify();
+        assert(cs.get_circulation_cost() == netw.get_circulation_cost());
+    }
+}
+
+// Optimal costs of the google OR example for each amount of flow
+void dataset_test_mincost_flow() {
+    ifstream in("datasets/mincost_flow.txt");
+    assert(in.is_open());
+    string line;
+    while (getline(in, line) && line[0] == '#') {}
+    int V, E, K, s, t;
+    in >> V >> E >> K >> s >> t;
+    edges_t g(E);
+    vector<long> cap(E), cost(E);
+    for (int e = 0; e < E; e++) {
+        in >> g[e][0] >> g[e][1] >> cap[e] >> cost[e];
+    }
+    for (long F, C; in >> F >> C;) {
+        cost_scaling<long, long> cs(V);
+        network_simplex<long, long> netw(V);
+        mcmflow<long, long> mcf(V);
+        cs.set_supply(s, F), cs.set_supply(t, -F);
+        netw.set_supply(s, F), netw.set_supply(t, -F);
+        for (int e = 0; e < E; e++) {
+            auto [u, v] = g[e];
+            cs.add(u, v, 0, cap[e], cost[e]);
+            netw.add(u, v, 0, cap[e], cost[e]);
+            mcf.add(u, v, cap[e], cost[e]);
+        }
+        bool feasible = cs.mincost_circulation() && netw.mincost_circulation();
+        assert(feasible);
+        assert(cs.get_circulation_cost() == C && netw.get_circulation_cost() == C);
+        mcf.dijkstra(s, t);
+        auto [flow, mcost, paths] = mcf.mincost_flow(s, t, F, LONG_MAX / 2, INT_MAX);
+        assert(flow == F && mcost == C);
+        println("{} F={} C={}", line, F, C);
+    }
+}
+
+using mincost_table_t = map<pair<string, string>, string>;
+
+// Time cost scaling, the pivot rules of network simplex and mcmflow on one network.
+// The slow ones take minutes on large networks and are skipped there
+void bench_mincost_solvers(mincost_table_t& table, const string& name,
+                           const dimacs_min& net) {
+    int E = net.g.size();
+    optional<long> expected = net.answer;
+    auto bench = [&](const string& solver, auto&& solve) {
+        printcl("speed test {} {}", name, solver);
+        START(solve);
+        long cost = solve();
+        TIME(solve);
+        assert(!expected || cost == *expected);
+        expected = cost;
+        table[{name, solver}] = FORMAT_TIME(solve);
+    };
+    table[{name, "V"}] = to_string(net.V);
+    table[{name, "E"}] = to_string(E);
+
+    bench("cost scaling", [&]() {
+        cost_scaling<long, long> cs(net.V);
+        return solve_dimacs_min(net, cs);
+    });
+    using simplex_t = network_simplex<long, long>;
+    for (auto [rule, label] : {pair(simplex_t::BLOCK_SEARCH, "simplex block"),
+                               pair(simplex_t::FIRST_ELIGIBLE, "simplex first"),
+                               pair(simplex_t::BEST_ELIGIBLE, "simplex best")}) {
+        if (rule != simplex_t::BLOCK_SEARCH && E > 100'000) {
+            continue;
+        }
+        bench(label, [&, rule = rule]() {
+            simplex_t netw(net.V);
+            netw.set_pivot_rule(rule);
+            return solve_dimacs_min(net, netw);
+        });
+    }
+    if (E <= 20'000) {
+        bench("mcmflow", [&]() { return solve_dimacs_min_mcmflow(net); });
+    }
+}
+
+// The DIMACS networks in datasets/mincost_circulation, with *.large.min if unpacked
+void speed_test_mincost_circulation_dataset() {
+    vector<string> files;
+    for (auto& entry : filesystem::directory_iterator("datasets/mincost_circulation")) {
+        if (entry.path().extension() == ".min") {
+            files.push_back(entry.path().string());
+        }
+    }
+    sort(begin(files), end(files));
+
+    mincost_table_t table;
+    for (const auto& file : files) {
+        auto net = read_dimacs_min(file);
+        auto name = filesystem::path(file).stem().string();
+        bench_mincost_solvers(table, name, net);
+    }
+
+    print_time_table(table, "Mincost circulation dataset");
+}
+
+// Transportation network: sources on the left, sinks on the right, large capacities
+auto make_transportation(int V, int E) {
+    int U = V / 2;
+    dimacs_min net;
+    net.V = V;
+    for (auto [u, v] : random_exact_bipartite(U, V - U, E)) {
+        net.g.push_back({u, U + v});
+    }
+    auto flows = rands_unif<int, long>(E, 0, 1'000'000);
+    net.upper = rands_unif<int, long>(E, 0, 1'000'000);
+    net.cost = rands_unif<int, long>(E, 1, 10'000);
+    net.lower.assign(E, 0), net.supply.assign(V, 0);
+    for (int e = 0; e < E; e++) {
+        auto [u, v] = net.g[e];
+        flows[e] = min(flows[e], net.upper[e]);
+        net.supply[u] += flows[e], net.supply[v] -= flows[e];
+    }
+    return net;
+}
+
+void speed_test_transportation() {
+    static const vector<pair<int, int>> inputs = {
+        {2'000, 20'000}, {10'000, 100'000}, {30'000, 300'000}, {100'000, 1'000'000}};
+
+    mincost_table_t table;
+    for (auto [V, E] : inputs) {
+        auto net = make_transportation(V, E);
+        bench_mincost_solvers(table, format("transport V={} E={}", V, E), net);
+    }
+
+    print_time_table(table, "Transportation networks");
+}
+
+int main() {
+    RUN_BLOCK(stress_test_cost_scaling());
+    RUN_BLOCK(dataset_test_mincost_flow());
+    RUN_BLOCK(speed_test_mincost_circulation_dataset());
+    RUN_BLOCK(speed_test_transportation());
+    return 0;
+}
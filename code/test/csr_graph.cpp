@@ -0,0 +1,198 @@
+#include "test_utils.hpp"
+#include "struct/csr_graph.hpp"
+#include "graphs/shortest_paths.hpp"
+#include "graphs/scc.hpp"
+#include "graphs/block_cut_tree.hpp"
+#include "flow/dinitz_flow.hpp"
+#include "flow/mincost_flow.hpp"
+#include "lib/graph_generator.hpp"
+#include <pthread.h>
+
+auto make_weighted_adjacency(int V, const edges_t& g, const vector<long>& w) {
+    vector<vector<pair<int, long>>> adj(V);
+    for (int i = 0, E = g.size(); i < E; i++) {
+        adj[g[i][0]].emplace_back(g[i][1], w[i]);
+    }
+    return adj;
+}
+
+// The recursive dfs of the adjacency list versions needs a deep stack on large graphs
+template <typename Fn>
+void run_with_stack(size_t bytes, Fn&& fn) {
+    pthread_attr_t attr;
+    pthread_t thread;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, bytes);
+    auto call = [](void* arg) -> void* { return (*static_cast<Fn*>(arg))(), nullptr; };
+    assert(pthread_create(&thread, &attr, call, &fn) == 0);
+    pthread_join(thread, nullptr);
+    pthread_attr_destroy(&attr);
+}
+
+void stress_test_csr_graph() {
+    LOOP_FOR_DURATION_TRACKED (3s, now) {
+        print_time(now, 3s, "stress test csr graph");
+        int V = rand_unif<int>(1, cointoss(0.5) ? 10 : 300);
+        int E = rand_unif<int>(0, min(4 * V, V * (V - 1)));
+        auto g = V > 1 ? random_exact_directed(V, E) : edges_t();
+        add_uniform_self_loops(V, g, 0.05);
+        E = g.size();
+        auto w = rands_unif<int, long>(E, 0, 1000);
+
+        // layout matches the adjacency lists built from the same edges
+        auto adj = make_adjacency_lists_directed(V, g);
+        auto wadj = make_weighted_adjacency(V, g, w);
+        csr_graph<> cg(V, g);
+        csr_graph<long> wg(V, g, w);
+        assert(csr_graph<>(adj).to == cg.to && csr_graph<long>(wadj).cost == wg.cost);
+        for (int u = 0; u < V; u++) {
+            assert(equal(begin(adj[u]), end(adj[u]), begin(cg[u]), end(cg[u])));
+        }
+        auto rg = wg.reversed();
+        auto radj = make_adjacency_lists_reverse(V, g);
+        for (int u = 0; u < V; u++) {
+            vector<int> in(begin(rg[u]), end(rg[u]));
+            sort(begin(in), end(in)), sort(begin(radj[u]), end(radj[u]));
+            assert(in == radj[u]);
+        }
+
+        int s = rand_unif<int>(0, V - 1);
+        assert(dijkstra(s, wg) == dijkstra(s, wadj));
+        assert(spfa(s, wg) == spfa(s, wadj));
+        assert(bellman_ford(s, wg) == dijkstra(s, wadj));
+        assert(build_scc(cg) == build_scc(adj));
+        assert(build_scc(cg, false) == build_scc(adj, false));
+
+        auto ug = V > 1 ? random_exact_undirected(V, min(E, V * (V - 1) / 2)) : edges_t();
+        block_cut_tree bct1(V, make_adjacency_lists_undirected(V, ug));
+        block_cut_tree bct2(V, csr_graph<>(V, ug, true));
+        assert(bct1.A == bct2.A && bct1.B == bct2.B && bct1.rep == bct2.rep);
+        assert(bct1.tree == bct2.tree && bct1.block == bct2.block);
+
+        if (V >= 2) {
+            int t = rand_unif<int>(0, V - 2);
+            t += t >= s;
+            dinitz_flow<long> mf1(V), mf2(wg);
+            for (int i = 0; i < E; i++) {
+                mf1.add(g[i][0], g[i][1], w[i]);
+            }
+            assert(mf1.maxflow(s, t) == mf2.maxflow(s, t));
+
+            edges_t h;
+            vector<long> caps, costs;
+            for (int i = 0; i < E; i++) {
+                if (g[i][0] != g[i][1]) {
+                    h.push_back(g[i]), caps.push_back(w[i] + 1);
+                    costs.push_back(w[E - 1 - i]);
+                }
+            }
+            csr_graph<long> hg(V, h, costs);
+            auto hcaps = csr_graph<long>(V, h, caps).cost; // capacities in csr order
+            mcmflow<long, long> mc1(V), mc2(hg, hcaps);
+            for (int i = 0, H = h.size(); i < H; i++) {
+                mc1.add(h[i][0], h[i][1], caps[i], costs[i]);
+            }
+            mc1.spfa_init(s, t), mc2.spfa_init(s, t);
+            assert(mc1.mincost_flow(s, t) == mc2.mincost_flow(s, t));
+        }
+    }
+}
+
+void speed_test_csr_graph() {
+    static vector<int> Vs = {100'000, 1'000'000, 3'000'000};
+    const int D = 5; // average out degree
+    map<pair<string, int>, string> table;
+
+    auto bench = [&](const string& name, int V, auto&& fn) {
+        printcl("speed test {} V={}", name, V);
+        START(run);
+        fn();
+        TIME(run);
+        table[{name, V}] = FORMAT_TIME(run);
+    };
+    auto memory = [&](const string& name, int V, auto&& build) {
+        int64_t before = resident_memory();
+        auto graph = build();
+        int64_t after = resident_memory();
+        table[{name, V}] = format("{:.1f}MB", (after - before) / 1e6);
+        return graph;
+    };
+
+    for (int V : Vs) {
+        int E = D * V;
+        auto g = random_exact_directed(V, E);
+        auto w = rands_unif<int, long>(E, 1, 1'000'000);
+        int64_t sink = 0;
+
+        // memory of the weighted graphs, then the unweighted ones
+        vector<vector<pair<int, long>>> wadj;
+        csr_graph<long> wg;
+        bench("build weighted lists", V, [&]() {
+            wadj = memory("memory weighted lists", V,
+                          [&]() { return make_weighted_adjacency(V, g, w); });
+        });
+        bench("build weighted csr", V, [&]() {
+            wg = memory("memory weighted csr", V,
+                        [&]() { return csr_graph<long>(V, g, w); });
+        });
+        bench("dijkstra lists", V, [&]() { sink += dijkstra(0, wadj)[V - 1]; });
+        bench("dijkstra csr", V, [&]() { sink += dijkstra(0, wg)[V - 1]; });
+        wadj.clear(), wadj.shrink_to_fit();
+
+        vector<vector<int>> adj;
+        csr_graph<> cg;
+        bench("build lists", V, [&]() {
+            adj = memory("memory lists", V,
+                         [&]() { return make_adjacency_lists_directed(V, g); });
+        });
+        bench("build csr", V, [&]() {
+            cg = memory("memory csr", V, [&]() { return csr_graph<>(V, g); });
+        });
+        run_with_stack(1 << 30, [&]() {
+            bench("scc lists", V, [&]() { sink += build_scc(adj).first; });
+        });
+        bench("scc csr", V, [&]() { sink += build_scc(cg).first; });
+        adj.clear(), adj.shrink_to_fit();
+
+        auto undirected = make_adjacency_lists_undirected(V, g);
+        csr_graph<> ug(V, g, true);
+        run_with_stack(1 << 30, [&]() {
+            bench("block cut tree lists", V, [&]() {
+                sink += block_cut_tree(V, undirected).num_nodes();
+            });
+        });
+        bench("block cut tree csr", V, [&]() {
+            sink += block_cut_tree(V, ug).num_nodes();
+        });
+        undirected.clear(), undirected.shrink_to_fit();
+
+        if (V <= 1'000'000) {
+            // dinitz before and after the residual lists moved to csr form
+            auto adjacency_dinitz = [&]() {
+                vector<vector<int>> res(V);
+                for (int i = 0; i < 2 * E; i++) {
+                    res[g[i >> 1][i & 1]].push_back(i);
+                }
+                return res;
+            };
+            memory("memory dinitz lists residual", V, adjacency_dinitz);
+            bench("dinitz csr", V, [&]() {
+                dinitz_flow<long> mf(wg);
+                sink += memory("memory dinitz csr residual", V, [&]() {
+                    mf.build_residual();
+                    return mf.res.E;
+                });
+                sink += mf.maxflow(0, V - 1);
+            });
+        }
+        printcl("sink: {}\n", sink);
+    }
+
+    print_time_table(table, "CSR graph vs adjacency lists, 5V edges (cols=V)");
+}
+
+int main() {
+    RUN_BLOCK(stress_test_csr_graph());
+    RUN_BLOCK(speed_test_csr_graph());
+    return 0;
+}
@@ -47,9 +47,16 @@ void stress_test_dynamic_segtree() {
             long actual = accumulate(begin(arr) + qL, begin(arr) + qR, 0LL);
             assert(got == actual);
         }
+        if (cointoss(0.001)) {
+            vector<int> roots = {root};
+            st.compact(roots);
+            root = roots[0];
+        }
     }
 
     print("final number of nodes: {}\n", st.num_nodes());
+    vector<int> roots = {root};
+    print("   compacted to nodes: {}\n", st.compact(roots));
     print("       normal segtree: {}\n", 2 * (R - L));
 }
 
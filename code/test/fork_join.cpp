@@ -0,0 +1,133 @@
+#include "test_utils.hpp"
+#include "parallel/fork_join.hpp"
+
+void stress_test_fork_join() {
+    thread_pool pool(6);
+
+    for (int run = 0; run < 300; run++) {
+        int N = rand_unif<int>(0, 50'000);
+        int grain = rand_unif<int>(1, 3000);
+        print_regular(run, 300, 10, "stress test fork join N={}", N);
+
+        vector<long> A(N);
+        for (int i = 0; i < N; i++) {
+            A[i] = rand_unif<long>(0, 1'000'000'000);
+        }
+
+        vector<int> marks(N, 0);
+        parallel_for(pool, 0, N, [&](int64_t i) { marks[i]++; }, grain);
+        assert(count(begin(marks), end(marks), 1) == N);
+
+        auto sum = parallel_reduce(
+            pool, 0, N, 7L,
+            [&](int64_t l, int64_t r) {
+                return accumulate(begin(A) + l, begin(A) + r, 0L);
+            },
+            plus<long>{}, grain);
+        assert(sum == accumulate(begin(A), end(A), 7L));
+
+        vector<long> B(N), C(N);
+        parallel_scan(pool, begin(A), end(A), begin(B), 3L, plus<long>{}, grain);
+        inclusive_scan(begin(A), end(A), begin(C), plus<long>{}, 3L);
+        assert(B == C);
+
+        // stability: sort pairs by first only and compare with stable_sort
+        vector<pair<int, int>> P(N), Q;
+        for (int i = 0; i < N; i++) {
+            P[i] = {rand_unif<int>(0, 50), i};
+        }
+        Q = P;
+        auto byfirst = [](const auto& a, const auto& b) { return a.first < b.first; };
+        parallel_sort(pool, begin(P), end(P), byfirst, grain);
+        stable_sort(begin(Q), end(Q), byfirst);
+        assert(P == Q);
+
+        vector<int> dist(N), idx, idx2;
+        for (int i = 0; i < N; i++) {
+            dist[i] = rand_unif<int>(0, run % 2 ? 1'000 : 1'000'000'000);
+        }
+        parallel_msb_radix_sort_idx(pool, idx, dist, grain);
+        assert(is_sorted(begin(idx), end(idx),
+                         [&](int u, int v) { return dist[u] < dist[v]; }));
+        idx2 = idx, sort(begin(idx2), end(idx2));
+        for (int i = 0; i < N; i++) {
+            assert(idx2[i] == i);
+        }
+
+        auto D = dist;
+        parallel_msb_radix_sort(pool, dist, grain);
+        sort(begin(D), end(D));
+        assert(D == dist);
+    }
+}
+
+void scaling_test_fork_join() {
+    static vector<int> Ts = {1, 2, 4, 8, 16};
+    static vector<long> Ns = {10'000'000, 100'000'000, 1'000'000'000};
+    static constexpr int64_t MAX_BYTES = 3LL << 30; // skip what does not fit
+    map<tuple<long, int, string>, string> table;
+    string skipped;
+
+    // A, plus the largest of the scan output B or a copy of A with its sort buffer
+    auto estimate = [&](long N) { return N * (sizeof(unsigned) + sizeof(unsigned long)); };
+
+    for (long N : Ns) {
+        if (estimate(N) >= MAX_BYTES) {
+            skipped += format(" N={} (~{:.0f}MB)", N, estimate(N) / 1e6);
+            continue;
+        }
+        vector<unsigned> A(N);
+        for (long i = 0; i < N; i++) {
+            A[i] = mt() >> 2;
+        }
+        for (int T : Ts) {
+            thread_pool pool(T);
+            printcl("scaling test fork join N={} T={}", N, T);
+
+            START(reduce);
+            auto sum = parallel_reduce(
+                pool, 0, N, 0UL,
+                [&](int64_t l, int64_t r) {
+                    return accumulate(begin(A) + l, begin(A) + r, 0UL);
+                },
+                plus<unsigned long>{});
+            TIME(reduce);
+
+            vector<unsigned long> B(N);
+            START(scan);
+            parallel_scan(pool, begin(A), end(A), begin(B), 0UL, plus<unsigned long>{});
+            TIME(scan);
+            assert(B.back() == sum);
+            B.clear(), B.shrink_to_fit();
+
+            auto S = A;
+            START(sort);
+            parallel_sort(pool, begin(S), end(S));
+            TIME(sort);
+            assert(is_sorted(begin(S), end(S)));
+            S.clear(), S.shrink_to_fit();
+
+            auto R = A;
+            START(radix);
+            parallel_msb_radix_sort(pool, R);
+            TIME(radix);
+            assert(is_sorted(begin(R), end(R)));
+
+            table[{N, T, "reduce"}] = FORMAT_TIME(reduce);
+            table[{N, T, "scan"}] = FORMAT_TIME(scan);
+            table[{N, T, "sort"}] = FORMAT_TIME(sort);
+            table[{N, T, "radix"}] = FORMAT_TIME(radix);
+        }
+    }
+
+    print_time_table(table, "Fork join scaling (rows=N, cols=threads)");
+    if (!skipped.empty()) {
+        println("skipped for memory:{}", skipped);
+    }
+}
+
+int main() {
+    RUN_BLOCK(stress_test_fork_join());
+    RUN_BLOCK(scaling_test_fork_join());
+    return 0;
+}
@@ -2,6 +2,9 @@
 #include "numeric/math.hpp"
 #include "numeric/modnum.hpp"
 #include "algo/floor_sum.hpp"
+#include "linear/matrix.hpp"
+#include "numeric/combinatorics.hpp"
+#include "numeric/fft.hpp"
 
 void stress_test_floor_sum() {
     vector<int> ns = {1, 2, 3, 4, 5, 37, 89, 913, 1024, 7302};
@@ -149,10 +152,205 @@ void stress_test_modnum() {
     }
 }
 
+// The previous dmodnum, reducing with a division on every product, for reference
+struct slow_dmodnum {
+    static inline uint32_t MOD = 998244353;
+    uint32_t n = 0;
+
+    slow_dmodnum() = default;
+    slow_dmodnum(int64_t v) : n(v >= 0 ? v % MOD : MOD - 1 - (-v - 1) % MOD) {}
+
+    slow_dmodnum inv() const {
+        int64_t x = n, y = MOD, nx = 1, ny = 0;
+        while (x) {
+            int64_t k = y / x;
+            y -= k * x, ny -= k * nx;
+            swap(x, y), swap(nx, ny);
+        }
+        return ny;
+    }
+    slow_dmodnum operator-() const { return n == 0 ? 0 : MOD - n; }
+    slow_dmodnum& operator+=(slow_dmodnum v) {
+        return n = n + v.n >= MOD ? n + v.n - MOD : n + v.n, *this;
+    }
+    slow_dmodnum& operator-=(slow_dmodnum v) { return *this += -v; }
+    slow_dmodnum& operator*=(slow_dmodnum v) {
+        return n = uint64_t(n) * v.n % MOD, *this;
+    }
+    slow_dmodnum& operator/=(slow_dmodnum v) { return *this *= v.inv(); }
+    friend slow_dmodnum operator+(slow_dmodnum a, slow_dmodnum b) { return a += b; }
+    friend slow_dmodnum operator-(slow_dmodnum a, slow_dmodnum b) { return a -= b; }
+    friend slow_dmodnum operator*(slow_dmodnum a, slow_dmodnum b) { return a *= b; }
+    friend slow_dmodnum operator/(slow_dmodnum a, slow_dmodnum b) { return a /= b; }
+    friend bool operator==(slow_dmodnum a, slow_dmodnum b) { return a.n == b.n; }
+};
+
+void stress_test_barrett() {
+    LOOP_FOR_DURATION_TRACKED (2s, now) {
+        print_time(now, 2s, "stress test barrett");
+        uint32_t m = cointoss(0.5) ? rand_unif<uint32_t>(2, 1000)
+                                   : rand_unif<uint32_t>(2, (1u << 31) - 1);
+        barrett br(m);
+        dmodnum::set_mod(m);
+        for (int i = 0; i < 1000; i++) {
+            uint64_t hi = cointoss(0.5) ? uint64_t(m) * m : UINT64_MAX;
+            uint64_t z = rand_unif<uint64_t>(0, hi);
+            assert(br.reduce(z) == z % m);
+            uint32_t a = rand_unif<uint32_t>(0, m - 1), b = rand_unif<uint32_t>(0, m - 1);
+            assert(br.mul(a, b) == uint64_t(a) * b % m);
+            assert(dmodnum(a) * dmodnum(b) == dmodnum(uint64_t(a) * b % m));
+            int64_t v = rand_unif<int64_t>(INT64_MIN + 1, INT64_MAX);
+            assert(int(dmodnum(v)) == (v % m + m) % m);
+        }
+        {
+            int A = rand_unif<int>(0, 30), B = rand_unif<int>(0, 30);
+            auto a = rands_unif<int64_t>(A, -3LL * m, 3LL * m);
+            auto b = rands_unif<int64_t>(B, -3LL * m, 3LL * m);
+            vector<int64_t> c(A && B ? A + B - 1 : 0);
+            for (int i = 0; i < A; i++) {
+                for (int j = 0; j < B; j++) {
+                    c[i + j] = (c[i + j] + __int128_t(a[i]) * b[j] % m + m) % m;
+                }
+            }
+            while (!c.empty() && c.back() == 0) {
+                c.pop_back();
+            }
+            assert(fft::naive_multiply(int64_t(m), a, b) == c);
+        }
+        if (m < (1u << 30)) {
+            int N = rand_unif<int>(0, 500);
+            auto a = rands_unif<uint32_t>(N, 0, m - 1);
+            auto b = rands_unif<uint32_t>(N, 0, m - 1);
+            vector<uint32_t> c(N);
+            mul_mod(m, c.data(), a.data(), b.data(), N);
+            for (int i = 0; i < N; i++) {
+                assert(c[i] == uint64_t(a[i]) * b[i] % m);
+            }
+        }
+    }
+}
+
+void speed_test_runtime_modnum() {
+    constexpr uint32_t mod = 998244353;
+    using num = modnum<mod>;
+    dmodnum::set_mod(mod), slow_dmodnum::MOD = mod;
+    map<pair<string, string>, string> table;
+
+    auto matrix_power = [&](auto type, const string& name) {
+        using T = decltype(type);
+        for (int n : {16, 64, 200}) {
+            mat<T> a(n, n);
+            for (int i = 0; i < n * n; i++) {
+                a.data[i] = T(rand_unif<int64_t>(0, mod - 1));
+            }
+            START_ACC(power);
+            LOOP_FOR_DURATION_OR_RUNS_TRACKED (1s, now, 1000, runs) {
+                print_time(now, 1s, "speed test matrix power {} n={}", name, n);
+                START(power);
+                auto b = a ^ 1'000'000'007;
+                ADD_TIME(power);
+            }
+            table[{format("mat^e n={}", n), name}] = FORMAT_EACH(power, runs);
+        }
+    };
+    auto poly_multiply = [&](auto type, const string& name) {
+        using T = decltype(type);
+        for (int n : {1000, 10'000}) {
+            vector<T> a(n), b(n), c(2 * n - 1);
+            for (int i = 0; i < n; i++) {
+                a[i] = T(rand_unif<int64_t>(0, mod - 1));
+                b[i] = T(rand_unif<int64_t>(0, mod - 1));
+            }
+            START_ACC(multiply);
+            LOOP_FOR_DURATION_OR_RUNS_TRACKED (1s, now, 1000, runs) {
+                print_time(now, 1s, "speed test poly multiply {} n={}", name, n);
+                START(multiply);
+                fill(begin(c), end(c), T(0));
+                for (int i = 0; i < n; i++)
+                    for (int j = 0; j < n; j++)
+                        c[i + j] += a[i] * b[j];
+                ADD_TIME(multiply);
+            }
+            table[{format("naive poly n={}", n), name}] = FORMAT_EACH(multiply, runs);
+        }
+    };
+    auto binomials = [&](auto type, const string& name) {
+        using T = decltype(type);
+        constexpr int N = 5'000'000, Q = 5'000'000;
+        printcl("speed test binomial {}", name);
+        START(table);
+        Binomial<T>::ensure_factorial(N);
+        TIME(table);
+        auto ns = rands_unif<int>(Q, 0, N);
+        START(choose);
+        T sum = 0;
+        for (int n : ns) {
+            sum += Binomial<T>::choose(n, n / 3);
+        }
+        TIME(choose);
+        table[{"binomial table 5M", name}] = FORMAT_TIME(table);
+        table[{"binomial choose 5M", name}] = FORMAT_TIME(choose);
+    };
+
+    auto run = [&](auto type, const string& name) {
+        matrix_power(type, name), poly_multiply(type, name), binomials(type, name);
+    };
+    run(num(), "modnum"), run(dmodnum(), "dmodnum"), run(slow_dmodnum(), "dmodnum %");
+
+    // fft::naive_multiply(mod, ...) over int64_t, and the batch mul_mod over arrays
+    for (int n : {1000, 10'000}) {
+        auto a = rands_unif<int64_t>(n, 0, mod - 1);
+        auto b = rands_unif<int64_t>(n, 0, mod - 1);
+        START_ACC(multiply);
+        LOOP_FOR_DURATION_OR_RUNS_TRACKED (1s, now, 1000, runs) {
+            print_time(now, 1s, "speed test naive_multiply n={}", n);
+            START(multiply);
+            auto c = fft::naive_multiply(int64_t(mod), a, b);
+            ADD_TIME(multiply);
+        }
+        table[{format("naive poly n={}", n), "naive_multiply(mod)"}] =
+            FORMAT_EACH(multiply, runs);
+    }
+    {
+        constexpr int N = 1 << 20;
+        auto a = rands_unif<uint32_t>(N, 0, mod - 1);
+        auto b = rands_unif<uint32_t>(N, 0, mod - 1);
+        vector<uint32_t> c(N);
+        barrett br(mod);
+        auto bench = [&](const string& name, auto&& fn) {
+            START_ACC(mul);
+            LOOP_FOR_DURATION_OR_RUNS_TRACKED (1s, now, 1000, runs) {
+                print_time(now, 1s, "speed test mul_mod {}", name);
+                START(mul);
+                fn();
+                ADD_TIME(mul);
+            }
+            table[{"mul 1M arrays", name}] = FORMAT_EACH(mul, runs);
+        };
+        bench("mul_mod batch", [&]() { mul_mod(mod, c.data(), a.data(), b.data(), N); });
+        bench("barrett", [&]() {
+            for (int i = 0; i < N; i++)
+                c[i] = br.mul(a[i], b[i]);
+        });
+        bench("dmodnum %", [&]() {
+            for (int i = 0; i < N; i++)
+                c[i] = uint64_t(a[i]) * b[i] % slow_dmodnum::MOD;
+        });
+        bench("modnum", [&]() {
+            for (int i = 0; i < N; i++)
+                c[i] = uint64_t(a[i]) * b[i] % mod;
+        });
+    }
+
+    print_time_table(table, "Runtime modulus arithmetic (cols=type)");
+}
+
 int main() {
     RUN_BLOCK(stress_test_floor_sum());
     RUN_BLOCK(unit_test_modsqrt());
     RUN_BLOCK(unit_test_modlog());
     RUN_BLOCK(stress_test_modnum());
+    RUN_BLOCK(stress_test_barrett());
+    RUN_BLOCK(speed_test_runtime_modnum());
     return 0;
 }
@@ -21,7 +21,124 @@ void unit_test_matrix() {
     }
 }
 
+template <typename T>
+auto random_matrix(int n, int m) {
+    mat<T> a(n, m);
+    for (int i = 0; i < n * m; i++) {
+        if constexpr (is_floating_point_v<T>) {
+            a.data[i] = rand_unif<T>(-1, 1);
+        } else if constexpr (is_integral_v<T>) { // products stay far from overflow
+            a.data[i] = rand_unif<T>(-1000, 1000);
+        } else {
+            a.data[i] = T(rand_unif<int64_t>(0, 1'000'000'000));
+        }
+    }
+    return a;
+}
+
+template <typename T>
+bool approx_equal(const mat<T>& a, const mat<T>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (int i = 0; i < a.n * a.m; i++) {
+        if constexpr (is_floating_point_v<T>) {
+            if (abs(a.data[i] - b.data[i]) > 1e-9 * (1 + abs(b.data[i])) * a.m)
+                return false;
+        } else if (!(a.data[i] == b.data[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T>
+auto naive_multiply(const mat<T>& a, const mat<T>& b) {
+    mat<T> c(a.n, b.m);
+    gemm_naive(a.n, a.m, b.m, a.data, b.data, c.data);
+    return c;
+}
+
+template <typename T>
+void stress_test_gemm(const string& name) {
+    thread_pool pool(3);
+    if constexpr (is_same_v<T, dmodnum>) {
+        dmodnum::set_mod(2'147'483'629); // just below 2^31, so the chunks of k are short
+    }
+    LOOP_FOR_DURATION_TRACKED (2s, now) {
+        print_time(now, 2s, "stress test gemm {}", name);
+        int n = rand_unif<int>(1, 300), m = rand_unif<int>(1, 300);
+        int p = rand_unif<int>(1, 300);
+        auto a = random_matrix<T>(n, m), b = random_matrix<T>(m, p);
+        auto c = naive_multiply(a, b);
+        assert(approx_equal(a * b, c));
+        assert(approx_equal(multiply(pool, a, b), c));
+
+        auto sa = random_matrix<T>(n, n), sb = random_matrix<T>(n, n);
+        assert(approx_equal(strassen_multiply(sa, sb, rand_unif<int>(8, 64)),
+                            naive_multiply(sa, sb)));
+
+        if (n <= 40) {
+            int e = rand_unif<int>(0, is_integral_v<T> ? 3 : 20); // int64_t stays exact
+            auto power = mat<T>::identity(n);
+            for (int i = 0; i < e; i++) {
+                power = naive_multiply(power, sa);
+            }
+            if constexpr (!is_floating_point_v<T>) {
+                assert(approx_equal(sa ^ e, power));
+            }
+        }
+    }
+}
+
+void speed_test_gemm() {
+    using num = modnum<998244353>;
+    static vector<int> Ns = {250, 500, 1000, 2000, 4000};
+    map<pair<string, int>, string> table;
+    thread_pool pool(4);
+
+    auto bench = [&](const string& name, int N, auto&& fn, int products = 1) {
+        START_ACC(mul);
+        LOOP_FOR_DURATION_OR_RUNS_TRACKED (2s, now, 20, runs) {
+            print_time(now, 2s, "speed test {} N={}", name, N);
+            START(mul);
+            fn();
+            ADD_TIME(mul);
+        }
+        double flops = 2.0 * N * N * N * products * runs;
+        table[{name, N}] = format("{:.2f}GF/s", flops / TIME_NS(mul));
+    };
+
+    for (int N : Ns) {
+        auto da = random_matrix<double>(N, N), db = random_matrix<double>(N, N);
+        auto ma = random_matrix<num>(N, N), mb = random_matrix<num>(N, N);
+        if (N <= 1000) {
+            bench("double naive", N, [&]() { naive_multiply(da, db); });
+            bench("modnum naive", N, [&]() { naive_multiply(ma, mb); });
+        }
+        bench("double gemm", N, [&]() { da* db; });
+        bench("double gemm T=4", N, [&]() { multiply(pool, da, db); });
+        bench("double strassen", N, [&]() { strassen_multiply(da, db, 512); });
+        bench("modnum gemm", N, [&]() { ma* mb; });
+        bench("modnum gemm T=4", N, [&]() { multiply(pool, ma, mb); });
+        bench("modnum strassen", N, [&]() { strassen_multiply(ma, mb, 512); });
+        if (N <= 500) {
+            const int64_t e = 1'000'000; // squarings plus a product per set bit
+            int products = 63 - __builtin_clzll(e) + __builtin_popcountll(e);
+            bench("modnum mat^e", N, [&]() { ma ^ e; }, products);
+        }
+    }
+
+    // GFLOP/s count 2N^3 flops per product, also for Strassen and each product of mat^e
+    print_time_table(table, "Matrix multiplication, GFLOP/s (cols=N)");
+}
+
 int main() {
     RUN_BLOCK(unit_test_matrix());
+    RUN_BLOCK(stress_test_gemm<double>("double"));
+    RUN_BLOCK(stress_test_gemm<modnum<998244353>>("modnum"));
+    RUN_BLOCK(stress_test_gemm<dmodnum>("dmodnum"));
+    RUN_BLOCK(stress_test_gemm<int64_t>("int64_t"));
+    RUN_BLOCK(speed_test_gemm());
     return 0;
 }
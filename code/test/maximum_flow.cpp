@@ -2,6 +2,7 @@
 #include "flow/dinitz_flow.hpp"
 #include "flow/edmonds_karp.hpp"
 #include "flow/tidal_flow.hpp"
+#include "flow/push_relabel.hpp"
 #include "flow/circulation.hpp"
 #include "flow/classical.hpp"
 #include "lib/graph_formats.hpp"
@@ -29,7 +30,31 @@ auto mid_cap(int V, const edges_t& g, T low, T high, int repulsion) {
     return cap;
 }
 
+// get_flow() is a feasible flow of the returned value and left_of_mincut() a cut of it
+template <typename MF, typename Caps>
+void verify_flow(const MF& mf, int V, const edges_t& g, const Caps& caps, int s, int t,
+                 int64_t value) {
+    int E = g.size();
+    vector<int64_t> balance(V);
+    int64_t cut = 0;
+    for (int i = 0; i < E; i++) {
+        auto [u, v] = g[i];
+        auto f = mf.get_flow(i);
+        assert(0 <= f && f <= caps[i]);
+        balance[u] -= f, balance[v] += f;
+        if (mf.left_of_mincut(u) && !mf.left_of_mincut(v)) {
+            cut += caps[i];
+        }
+    }
+    for (int u = 0; u < V; u++) {
+        assert(u == s || u == t || balance[u] == 0);
+    }
+    assert(balance[t] == value && balance[s] == -value && cut == value);
+    assert(mf.left_of_mincut(s) && !mf.left_of_mincut(t));
+}
+
 void stress_test_max_flow() {
+    thread_pool pool(4);
     auto make_graph = []() {
         int V = rand_wide<int>(10, 100, -4);
         int k = rand_wide<int>(1, V, -1);
@@ -73,18 +98,38 @@ void stress_test_max_flow() {
 
         auto [V, g, s, t, cap] = make_graph();
 
-        const int C = 2;
+        const int C = 4;
         dinitz_flow<int, int> g1(V);
         tidal_flow<int, int> g2(V);
+        push_relabel_flow<int, int> g3(V), g4(V);
 
         add_edges(g1, g, cap);
         add_edges(g2, g, cap);
+        add_edges(g3, g, cap);
+        add_edges(g4, g, cap);
 
         vector<int> ans(C);
         ans[0] = g1.maxflow(s, t);
         ans[1] = g2.maxflow(s, t);
+        ans[2] = g3.maxflow(s, t);
+        ans[3] = g4.maxflow(pool, s, t);
 
         assert(all_eq(ans));
+        verify_flow(g3, V, g, cap, s, t, ans[2]);
+        verify_flow(g4, V, g, cap, s, t, ans[3]);
+
+        if (g.empty()) {
+            continue;
+        }
+        // more capacity on top of the current flow, like dinitz continues from it
+        int e = rand_unif<int>(0, int(g.size()) - 1);
+        cap[e] += 1000;
+        g1.update_edge(e, cap[e]), g3.update_edge(e, cap[e]);
+        int more = g1.maxflow(s, t);
+        assert(g3.maxflow(s, t) == more);
+        verify_flow(g3, V, g, cap, s, t, ans[2] + more);
+        g3.clear_flow();
+        assert(g3.maxflow(s, t) == ans[2] + more);
     }
 }
 
@@ -110,7 +155,7 @@ void speed_test_max_flow() {
 
     for (auto [V, pV, alpha] : inputs) {
         double p = pV / V;
-        START_ACC2(dinitz, tidal);
+        START_ACC3(dinitz, tidal, push_relabel);
         int64_t Exp = pV * V, Es = 0;
 
         LOOP_FOR_DURATION_TRACKED_RUNS (runtime, now, runs) {
@@ -121,7 +166,7 @@ void speed_test_max_flow() {
             add_uniform_self_loops(V, g, 0.1);
             auto cap = mid_cap(V, g, 1, 100'000'000, -10);
 
-            vector<long> ans(2);
+            vector<long> ans(3);
 
             ADD_TIME_BLOCK(dinitz) {
                 dinitz_flow<int, long> mf(V);
@@ -139,20 +184,89 @@ void speed_test_max_flow() {
                 ans[1] = mf.maxflow(s, t);
             }
 
+            ADD_TIME_BLOCK(push_relabel) {
+                push_relabel_flow<int, long> mf(V);
+                for (int i = 0, E = g.size(); i < E; i++) {
+                    mf.add(g[i][0], g[i][1], cap[i]);
+                }
+                ans[2] = mf.maxflow(s, t);
+            }
+
             assert(all_eq(ans));
             Es += g.size();
         }
 
         table[{{pV, alpha}, V, "dinitz"}] = FORMAT_EACH(dinitz, runs);
         table[{{pV, alpha}, V, "tidal"}] = FORMAT_EACH(tidal, runs);
+        table[{{pV, alpha}, V, "push relabel"}] = FORMAT_EACH(push_relabel, runs);
         table[{{pV, alpha}, V, "E"}] = format("{:.1f}", 1.0 * Es / runs);
     }
 
     print_time_table(table, "Maximum flow");
 }
 
+// Dense graphs and bipartite s-U-W-t networks with ~10^6 arcs
+void speed_test_dense_max_flow() {
+    thread_pool pool(4);
+    map<pair<string, string>, string> table;
+
+    auto bench = [&](const string& input, int V, const edges_t& g,
+                     const vector<long>& cap, int s, int t) {
+        vector<long> ans;
+        auto run = [&](const string& name, auto&& fn) {
+            printcl("speed test {} {}", name, input);
+            START(run);
+            ans.push_back(fn());
+            TIME(run);
+            table[{input, name}] = FORMAT_TIME(run);
+        };
+        run("dinitz", [&]() {
+            dinitz_flow<long, long> mf(V);
+            add_edges(mf, g, cap);
+            return mf.maxflow(s, t);
+        });
+        run("push relabel", [&]() {
+            push_relabel_flow<long, long> mf(V);
+            add_edges(mf, g, cap);
+            return mf.maxflow(s, t);
+        });
+        run("push relabel T=4", [&]() {
+            push_relabel_flow<long, long> mf(V);
+            add_edges(mf, g, cap);
+            return mf.maxflow(pool, s, t);
+        });
+        assert(all_eq(ans));
+        table[{input, "E"}] = format("{}", g.size());
+    };
+
+    for (int V : {1000, 1500}) {
+        auto g = random_uniform_directed(V, 0.45);
+        auto cap = rands_wide<long>(g.size(), 1, 1'000'000, -3);
+        bench(format("dense V={}", V), V, g, cap, 0, V - 1);
+    }
+    for (auto [U, W, E] : {array<int, 3>{1000, 1000, 500'000}, {2000, 2000, 1'000'000},
+                           {20000, 20000, 1'000'000}}) {
+        int V = U + W + 2, s = U + W, t = s + 1;
+        edges_t g;
+        for (auto [u, w] : random_exact_bipartite(U, W, E)) {
+            g.push_back({u, U + w});
+        }
+        for (int u = 0; u < U; u++) {
+            g.push_back({s, u});
+        }
+        for (int w = 0; w < W; w++) {
+            g.push_back({U + w, t});
+        }
+        auto cap = rands_wide<long>(g.size(), 1, 1000, -3);
+        bench(format("bipartite {}x{}", U, W), V, g, cap, s, t);
+    }
+
+    print_time_table(table, "Maximum flow on dense and bipartite networks");
+}
+
 int main() {
     RUN_BLOCK(stress_test_max_flow());
     RUN_BLOCK(speed_test_max_flow());
+    RUN_BLOCK(speed_test_dense_max_flow());
     return 0;
 }
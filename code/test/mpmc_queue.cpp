@@ -0,0 +1,114 @@
+#include "test_utils.hpp"
+#include "parallel/mpmc_queue.hpp"
+#include "parallel/spinlock.hpp"
+
+void stress_test_mpmc_queue() {
+    for (int run = 0; run < 200; run++) {
+        int P = rand_unif<int>(1, 6), C = rand_unif<int>(1, 6);
+        int M = rand_unif<int>(1, 20'000), capacity = rand_unif<int>(1, 64);
+        print_regular(run, 200, 10, "stress test mpmc queue P={} C={}", P, C);
+
+        mpmc_queue<int> queue(capacity);
+        vector<atomic<int>> seen(M);
+        atomic<int> popped = 0;
+        vector<thread> threads;
+
+        for (int p = 0; p < P; p++) {
+            threads.emplace_back([&, p]() {
+                for (int i = p; i < M; i += P) {
+                    if (i % 2) {
+                        queue.push(i);
+                    } else {
+                        while (!queue.try_push(i)) {
+                            this_thread::yield();
+                        }
+                    }
+                }
+            });
+        }
+        for (int c = 0; c < C; c++) {
+            threads.emplace_back([&]() {
+                int i;
+                while (popped.load() < M) {
+                    if (queue.try_pop(i)) {
+                        seen[i]++, popped++;
+                    } else {
+                        this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+
+        assert(queue.empty() && popped == M);
+        for (int i = 0; i < M; i++) {
+            assert(seen[i] == 1);
+        }
+    }
+}
+
+template <typename Queue>
+double queue_throughput(Queue& queue, int P, int C, int M) {
+    atomic<int> popped = 0;
+    vector<thread> threads;
+    START(throughput);
+    for (int p = 0; p < P; p++) {
+        threads.emplace_back([&, p]() {
+            for (int i = p; i < M; i += P) {
+                queue.push(i);
+            }
+        });
+    }
+    for (int c = 0; c < C; c++) {
+        threads.emplace_back([&]() {
+            int i;
+            while (popped.load(memory_order_relaxed) < M) {
+                if (queue.maybe_pop(i)) {
+                    popped++;
+                } else {
+                    this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    TIME(throughput);
+    return 1e9 * M / TIME_NS(throughput);
+}
+
+void speed_test_mpmc_queue() {
+    static vector<int> Ps = {1, 2, 4, 8};
+    static vector<int> Cs = {1, 2, 4, 8};
+    const int M = 2'000'000;
+    map<tuple<int, int, string>, string> table;
+
+    // adapt mpmc_queue to the concurrent_queue interface for the benchmark
+    struct lockfree_queue : mpmc_queue<int> {
+        using mpmc_queue<int>::mpmc_queue;
+        bool maybe_pop(int& i) { return try_pop(i); }
+    };
+
+    for (int P : Ps) {
+        for (int C : Cs) {
+            printcl("speed test mpmc queue P={} C={}", P, C);
+            concurrent_queue<int> spin(M);
+            lockfree_queue lockfree(1024);
+            double a = queue_throughput(spin, P, C, M);
+            double b = queue_throughput(lockfree, P, C, M);
+            table[{P, C, "spinlock"}] = format("{:.2f}M/s", a / 1e6);
+            table[{P, C, "mpmc"}] = format("{:.2f}M/s", b / 1e6);
+        }
+    }
+
+    print_time_table(table, "Queue throughput (rows=producers, cols=consumers)");
+}
+
+int main() {
+    RUN_BLOCK(stress_test_mpmc_queue());
+    RUN_BLOCK(speed_test_mpmc_queue());
+    return 0;
+}
@@ -3,15 +3,17 @@
 
 using num = modnum<998244353>;
 
+template <uint32_t MOD>
 void stress_test_ntt_multiply() {
-    LOOP_FOR_DURATION_OR_RUNS_TRACKED (20s, now, 100'000, runs) {
-        print_time(now, 20s, "stress ntt ({} runs)", runs);
+    using T = modnum<MOD>;
+    LOOP_FOR_DURATION_OR_RUNS_TRACKED (10s, now, 100'000, runs) {
+        print_time(now, 10s, "stress ntt mod={} ({} runs)", MOD, runs);
 
         const int V = 100'000;
-        int A = rand_unif<int>(0, 1000);
-        int B = rand_unif<int>(0, 1000);
-        auto a = rands_unif<int, num>(A, -V, V);
-        auto b = rands_unif<int, num>(B, -V, V);
+        int A = rand_unif<int>(0, cointoss(0.9) ? 1000 : 5000);
+        int B = rand_unif<int>(0, cointoss(0.9) ? 1000 : 5000);
+        auto a = rands_unif<int, T>(A, -V, V);
+        auto b = rands_unif<int, T>(B, -V, V);
         auto c = fft::ntt_multiply(a, b);
         auto d = fft::naive_multiply(a, b);
 
@@ -53,7 +55,9 @@ void speed_test_ntt_multiply() {
 }
 
 int main() {
-    RUN_BLOCK(stress_test_ntt_multiply());
+    RUN_BLOCK(stress_test_ntt_multiply<998244353>());
+    RUN_BLOCK(stress_test_ntt_multiply<469762049>());
+    RUN_BLOCK(stress_test_ntt_multiply<167772161>());
     RUN_BLOCK(speed_test_ntt_multiply());
     return 0;
 }
@@ -0,0 +1,97 @@
+#include "test_utils.hpp"
+#include "numeric/parallel_ntt.hpp"
+
+using num = modnum<998244353>;
+
+void stress_test_parallel_ntt_multiply() {
+    thread_pool pool(4);
+
+    LOOP_FOR_DURATION_OR_RUNS_TRACKED (20s, now, 1000, runs) {
+        print_time(now, 20s, "stress parallel ntt ({} runs)", runs);
+
+        int A = rand_unif<int>(1, cointoss(0.5) ? 1000 : 200'000);
+        int B = rand_unif<int>(1, cointoss(0.5) ? 1000 : 200'000);
+        auto a = rands_unif<int, num>(A, 0, 998244352);
+        auto b = rands_unif<int, num>(B, 0, 998244352);
+        auto c = fft::ntt_multiply(pool, a, b);
+        auto d = fft::ntt_multiply(a, b);
+
+        assert(c == d);
+    }
+}
+
+void stress_test_parallel_ntt_multiply_mod() {
+    thread_pool pool(4);
+    const int MOD = 1'000'000'007;
+
+    LOOP_FOR_DURATION_OR_RUNS_TRACKED (20s, now, 1000, runs) {
+        print_time(now, 20s, "stress parallel ntt mod ({} runs)", runs);
+
+        // a modulus above 2^30 with negative inputs, against the naive product
+        bool wide = cointoss(0.3), large = !wide && cointoss(0.3);
+        int mod = wide ? rand_unif<int>(1 << 30, INT_MAX) : MOD;
+        int A = rand_unif<int>(1, large ? 100'000 : 1000);
+        int B = rand_unif<int>(1, large ? 100'000 : 1000);
+        auto a = rands_unif<int>(A, wide ? 1 - mod : 0, mod - 1);
+        auto b = rands_unif<int>(B, wide ? 1 - mod : 0, mod - 1);
+        auto c = fft::ntt_multiply(pool, mod, a, b);
+        auto d = large ? fft::fft_multiply(mod, a, b) : fft::naive_multiply(mod, a, b);
+
+        assert(c == d);
+    }
+}
+
+void speed_test_parallel_ntt_multiply() {
+    static vector<int> Ts = {1, 2, 4, 8};
+    static vector<int> Ss = {16, 18, 20, 22, 24};
+    const int MOD = 1'000'000'007;
+    map<tuple<string, int, string>, string> table;
+
+    for (int s : Ss) {
+        int A = 1 << (s - 1), B = 1 << (s - 1);
+        auto a = rands_unif<int, num>(A, 0, 998244352);
+        auto b = rands_unif<int, num>(B, 0, 998244352);
+        auto x = rands_unif<int>(A, 0, MOD - 1);
+        auto y = rands_unif<int>(B, 0, MOD - 1);
+        auto N = format("2^{}", s);
+        bool fits = s <= __builtin_ctz(num::MOD - 1); // 998244353 stops at 2^23
+
+        printcl("speed test parallel ntt N={} serial", N);
+        if (fits) {
+            START(ntt);
+            fft::ntt_multiply(a, b);
+            TIME(ntt);
+            table[{N, 0, "ntt"}] = FORMAT_TIME(ntt);
+        }
+        START(split);
+        fft::fft_multiply(MOD, x, y);
+        TIME(split);
+        table[{N, 0, "mod"}] = FORMAT_TIME(split) + "*";
+
+        for (int T : Ts) {
+            printcl("speed test parallel ntt N={} T={}", N, T);
+            thread_pool pool(T);
+
+            if (fits) {
+                START(pool_ntt);
+                fft::ntt_multiply(pool, a, b);
+                TIME(pool_ntt);
+                table[{N, T, "ntt"}] = FORMAT_TIME(pool_ntt);
+            }
+            START(pool_mod);
+            fft::ntt_multiply(pool, MOD, x, y);
+            TIME(pool_mod);
+            table[{N, T, "mod"}] = FORMAT_TIME(pool_mod);
+        }
+    }
+
+    // T=0 is sequential ntt_multiply and fft_multiply(mod) (marked *), no ntt past 2^23
+    print_time_table(table, "Parallel NTT multiply (rows=size, cols=threads)");
+}
+
+int main() {
+    RUN_BLOCK(stress_test_parallel_ntt_multiply());
+    RUN_BLOCK(stress_test_parallel_ntt_multiply_mod());
+    RUN_BLOCK(speed_test_parallel_ntt_multiply());
+    return 0;
+}
@@ -114,10 +114,55 @@ void stress_test_lazy_persistent_segtree() {
     print("          nodes / ops: {}\n", ratio);
 }
 
+void stress_test_persistent_segtree_compact() {
+    LOOP_FOR_DURATION_TRACKED (2s, now) {
+        print_time(now, 2s, "stress test persistent segtree compact");
+        int N = rand_unif<int>(1, 300), W = rand_unif<int>(1, 30);
+        auto arr = rands_unif<int>(N, -10, 10);
+        slow_version_array sva(0, N, arr);
+
+        persistent_segtree<sum_segnode> st;
+        st.add_root(st.build_array(N, arr));
+        deque<int> live = {0};
+
+        for (int run = 0; run < 300; run++) {
+            int version = live[rand_unif<int>(0, live.size() - 1)];
+            int v = rand_unif<int>(-10, 10);
+            int v1, v2;
+            if (cointoss(0.5)) {
+                int i = rand_unif<int>(0, N - 1);
+                v1 = st.update_point(version, 0, N, i, v);
+                v2 = sva.update_point(version, i, v);
+            } else {
+                auto [qL, qR] = diff_unif<int>(0, N);
+                v1 = st.update_range(version, 0, N, qL, qR, v);
+                v2 = sva.update_range(version, qL, qR, v);
+            }
+            assert(v1 == v2);
+            live.push_back(v1);
+            if (int(live.size()) > W) {
+                int k = cointoss(0.7) ? 0 : rand_unif<int>(0, live.size() - 1);
+                st.retire(live[k]), live.erase(begin(live) + k);
+            }
+            if (cointoss(0.1)) {
+                int S = st.compact();
+                assert(S == st.num_nodes() && S <= int(live.size()) * 2 * N);
+            }
+
+            version = live[rand_unif<int>(0, live.size() - 1)];
+            auto [qL, qR] = diff_unif<int>(0, N);
+            int i = rand_unif<int>(0, N - 1);
+            int u1 = st.query_range(version, 0, N, qL, qR);
+            assert(u1 == sva.query_range(version, qL, qR));
+            assert(st.query_point(version, 0, N, i) == sva.query_point(version, i));
+        }
+    }
+}
+
 void stress_test_linear_meld_count_nodes() {
     const int M = 1'000'000;
     for (int N = 4; N <= 1'200'000; N *= 2) {
-        auto G = random_tree(N);
+        auto G = random_rooted_tree(N);
         vector<vector<int>> tree(N);
         for (auto [u, v] : G) {
             tree[u].push_back(v);
@@ -165,8 +210,77 @@ void stress_test_linear_meld_count_nodes() {
     }
 }
 
+// Keep a sliding window of the last W versions live, retire older versions and compact
+// whenever the pool doubles in size since the last compaction
+void speed_test_persistent_segtree_window() {
+    static vector<int> Ws = {16, 1024, 65536};
+    const int N = 1 << 18, T = 1'000'000, Q = 1'000'000;
+    map<pair<string, int>, string> table;
+    auto MB = [](int64_t bytes) { return format("{:.1f}MB", bytes / 1e6); };
+
+    auto is = rands_unif<int>(T, 0, N - 1);
+    auto vs = rands_unif<int>(T, -100, 100);
+    auto qs = rands_unif<int>(Q, 0, N - 1);
+
+    auto bench = [&](int W, bool gc) {
+        printcl("speed test persistent segtree window W={} gc={}", W, gc);
+        int64_t base = resident_memory(), peak_memory = 0;
+        int peak_nodes = 0, live_nodes = 0;
+        {
+            persistent_segtree<sum_segnode> st;
+            st.add_root(st.build_array(N, vector<int>(N)));
+            live_nodes = st.num_nodes();
+
+            START_ACC(sample);
+            START(update);
+            for (int t = 0; t < T; t++) {
+                int version = st.update_point(st.versions() - 1, 0, N, is[t], vs[t]);
+                if (gc && version >= W) {
+                    st.retire(version - W);
+                }
+                if (gc && st.num_nodes() >= 2 * live_nodes) {
+                    START(sample);
+                    peak_nodes = max(peak_nodes, st.num_nodes());
+                    peak_memory = max(peak_memory, resident_memory() - base);
+                    ADD_TIME(sample);
+                    live_nodes = st.compact();
+                }
+            }
+            TIME(update);
+            time_update -= time_sample; // don't count the memory sampling
+            peak_nodes = max(peak_nodes, st.num_nodes());
+            peak_memory = max(peak_memory, resident_memory() - base);
+
+            // point queries over the window, compacted pools are laid out in dfs order
+            int64_t sink = 0;
+            START(query);
+            for (int q = 0; q < Q; q++) {
+                int version = st.versions() - 1 - q % min(W, T);
+                sink += st.query_point(version, 0, N, qs[q]).value;
+            }
+            TIME(query);
+            printcl("sink: {}\n", sink);
+
+            string name = gc ? "gc" : "no gc";
+            table[{name + " update", W}] = FORMAT_EACH(update, T);
+            table[{name + " query", W}] = FORMAT_EACH(query, Q);
+            table[{name + " peak nodes", W}] = format("{}", peak_nodes);
+            table[{name + " peak memory", W}] = MB(peak_memory);
+        }
+    };
+
+    for (int W : Ws) {
+        bench(W, true);
+        bench(W, false);
+    }
+
+    print_time_table(table, "Persistent segtree with a sliding window of W versions");
+}
+
 int main() {
     RUN_BLOCK(stress_test_lazy_persistent_segtree());
+    RUN_BLOCK(stress_test_persistent_segtree_compact());
     RUN_BLOCK(stress_test_linear_meld_count_nodes());
+    RUN_BLOCK(speed_test_persistent_segtree_window());
     return 0;
 }
@@ -1,3 +1,4 @@
+#define FFT_COUNT_TRANSFORMS
 #include "test_utils.hpp"
 #include "numeric/fft.hpp"
 #include "numeric/polynomial.hpp"
@@ -96,8 +97,125 @@ void unit_test_polyseries() {
     println("tangent: {}", series::tangent<num>(15));
 }
 
+auto distinct_points(int S) {
+    auto v = rands_unif<int>(S, 0, num::MOD - 1);
+    sort(begin(v), end(v)), v.erase(unique(begin(v), end(v)), end(v));
+    return vector<num>(begin(v), end(v));
+}
+
+void stress_test_multieval() {
+    LOOP_FOR_DURATION_OR_RUNS_TRACKED (20s, now, 500, runs) {
+        print_time(now, 20s, "stress multieval ({} runs)", runs);
+
+        int N = rand_unif<int>(1, cointoss(0.5) ? 1000 : 6000);
+        int S = rand_unif<int>(1, cointoss(0.5) ? 1000 : 6000);
+        auto p = rands_unif<int, num>(N, 0, num::MOD - 1);
+        auto x = distinct_points(S);
+        auto y = rands_unif<int, num>(size(x), 0, num::MOD - 1);
+
+        auto ans = multieval(p, x);
+        for (int i = 0; i < size(x); i++) {
+            assert(ans[i] == eval(p, x[i]));
+        }
+        auto q = interpolate(x, y);
+        assert(size(q) <= size(x) && multieval(q, x) == y);
+    }
+}
+
+void stress_test_middle_product() {
+    LOOP_FOR_DURATION_OR_RUNS_TRACKED (10s, now, 3000, runs) {
+        print_time(now, 10s, "stress middle product ({} runs)", runs);
+
+        int A = rand_unif<int>(1, cointoss(0.5) ? 100 : 5000);
+        int B = rand_unif<int>(1, A);
+        auto a = rands_unif<int, num>(A, 0, num::MOD - 1);
+        auto b = rands_unif<int, num>(B, 0, num::MOD - 1);
+
+        auto ab = resized(fft::naive_multiply(a, b), A + B - 1);
+        auto mid = vector<num>(begin(ab) + (B - 1), begin(ab) + A);
+        assert(middle_product(a, b) == mid);
+        assert(middle_product(prepare(a, A), prepare(b, A)) == mid);
+
+        auto q = a / b, r = a % b;
+        assert(size(r) < size(trimmed(b)) && trimmed(a) == trimmed(q * b + r));
+    }
+}
+
+void stress_test_kitamasa() {
+    LOOP_FOR_DURATION_OR_RUNS_TRACKED (10s, now, 500, runs) {
+        print_time(now, 10s, "stress kitamasa ({} runs)", runs);
+
+        int L = rand_unif<int>(1, cointoss(0.5) ? 30 : 1000);
+        int K = rand_unif<int>(0, 20 * L);
+        auto rec = rands_unif<int, num>(L, 0, num::MOD - 1);
+        auto x = rands_unif<int, num>(L, 0, num::MOD - 1);
+
+        auto seq = x;
+        for (int n = L; n <= K; n++) {
+            num next = 0;
+            for (int i = 0; i < L; i++) {
+                next += rec[i] * seq[n - 1 - i];
+            }
+            seq.push_back(next);
+        }
+        assert(kitamasa(x, rec, K) == seq[K]);
+    }
+}
+
+void stress_test_composition() {
+    LOOP_FOR_DURATION_OR_RUNS_TRACKED (10s, now, 300, runs) {
+        print_time(now, 10s, "stress composition ({} runs)", runs);
+
+        int P = rand_unif<int>(1, 300), Q = rand_unif<int>(1, 300);
+        int n = rand_unif<int>(1, 1000);
+        auto p = rands_unif<int, num>(P, 0, num::MOD - 1);
+        auto q = rands_unif<int, num>(Q, 0, num::MOD - 1);
+        q[0] = 0;
+
+        assert(composition(p, q, n) == naive_composition(p, q, n));
+    }
+}
+
+void speed_test_multieval() {
+    vector<int> Ns = {10'000, 30'000, 100'000, 300'000, 1 << 20};
+    map<tuple<int, string, string>, string> table;
+
+    // transforms per call, counted by fft::fft_transform_count with FFT_COUNT_TRANSFORMS
+    auto run = [&](int N, const string& name, auto&& fn) {
+        printcl("speed test {} N={}", name, N);
+        int64_t before = fft::fft_transform_count;
+        START(call);
+        fn();
+        TIME(call);
+        table[{N, name, "time"}] = FORMAT_TIME(call);
+        table[{N, name, "ffts"}] = to_string(fft::fft_transform_count - before);
+    };
+
+    for (int N : Ns) {
+        auto p = rands_unif<int, num>(N, 0, num::MOD - 1);
+        auto x = distinct_points(N);
+        auto y = rands_unif<int, num>(size(x), 0, num::MOD - 1);
+        auto q = rands_unif<int, num>(N / 10, 0, num::MOD - 1);
+        auto rec = rands_unif<int, num>(N, 0, num::MOD - 1);
+
+        run(N, "multieval", [&]() { multieval(p, x); });
+        run(N, "interpolate", [&]() { interpolate(x, y); });
+        run(N, "kitamasa", [&]() { kitamasa(p, rec, 1'000'000'000'000'000); });
+        if (N <= 300'000) {
+            run(N / 10, "composition", [&]() { composition(q, q, N / 10); });
+        }
+    }
+
+    print_time_table(table, "Multipoint evaluation (rows=size)");
+}
+
 int main() {
     RUN_BLOCK(unit_test_polyseries());
+    RUN_BLOCK(stress_test_multieval());
+    RUN_BLOCK(stress_test_middle_product());
+    RUN_BLOCK(stress_test_kitamasa());
+    RUN_BLOCK(stress_test_composition());
+    RUN_BLOCK(speed_test_multieval());
     RUN_BLOCK(speed_test_polynomial());
     return 0;
 }
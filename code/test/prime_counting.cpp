@@ -0,0 +1,128 @@
+#include "test_utils.hpp"
+#include "numeric/prime_counting.hpp"
+#include "numeric/modnum.hpp"
+
+void unit_test_prime_pi() {
+    vector<int64_t> pi = {0,       4,         25,         168,         1229,
+                          9592,    78498,     664579,     5761455,     50847534,
+                          455052511, 4118054813, 37607912018};
+    for (int64_t k = 0, x = 1; k < int(pi.size()); k++, x *= 10) {
+        assert(prime_pi(x) == pi[k]);
+        if (k <= 10) {
+            auto S = lucy_prime_sums<int64_t>(
+                x, classic_sieve(isqrt(x)), [](int64_t) { return 1; },
+                [](int64_t v) { return v - 1; });
+            assert(S[x] == pi[k]);
+        }
+    }
+    // Σp for p<=10^9, the mertens and phi sums for x=10^9
+    assert(to_string(prime_sum(1'000'000'000)) == "24739512092254535");
+    assert(mertens(1'000'000'000) == -222);
+    assert(to_string(phi_prefix_sum(1'000'000'000)) == "303963551173008414");
+}
+
+void stress_test_prime_counting() {
+    constexpr int N = 2'000'000;
+    auto primes = classic_sieve(N);
+    auto phi = phi_sieve(N);
+    auto mu = range_mobius_sieve(1, N, primes);
+    auto tau = num_divisors_sieve(N);
+    vector<int64_t> pi(N + 1), mus(N + 1);
+    vector<int128_t> psum(N + 1), phis(N + 1);
+    vector<int> taus(N + 1);
+    for (int n = 1, j = 0; n <= N; n++) {
+        bool isprime = j < int(primes.size()) && primes[j] == n;
+        j += isprime;
+        pi[n] = pi[n - 1] + isprime, psum[n] = psum[n - 1] + (isprime ? n : 0);
+        mus[n] = mus[n - 1] + mu[n - 1], phis[n] = phis[n - 1] + phi[n];
+        taus[n] = (taus[n - 1] + tau[n]) % 998244353;
+    }
+
+    LOOP_FOR_DURATION_TRACKED (3s, now) {
+        print_time(now, 3s, "stress test prime counting");
+        int64_t x = rand_unif<int64_t>(0, cointoss(0.5) ? 2000 : N);
+        assert(prime_pi(x) == pi[x]);
+        assert(prime_sum(x) == psum[x]);
+        assert(mertens(x) == mus[x]);
+        assert(phi_prefix_sum(x) == phis[x]);
+        if (x >= 1) {
+            // number of divisors with modular sums, f(p) = 2 is twice the prime count
+            using num = modnum<998244353>;
+            auto g = lucy_prime_sums<num>(
+                x, primes, [](int64_t) { return num(1); },
+                [](int64_t v) { return num(v - 1); });
+            for (auto& v : g.lo)
+                v *= 2;
+            for (auto& v : g.hi)
+                v *= 2;
+            auto sum = min25_sieve(g, primes, [](int64_t, int e, int64_t) {
+                return num(e + 1);
+            });
+            assert(sum == num(taus[x]));
+        }
+    }
+}
+
+void speed_test_prime_counting() {
+    static vector<int> Ks = {10, 11, 12, 13};
+    map<pair<string, string>, string> table;
+
+    for (int k : Ks) {
+        int64_t x = 1;
+        for (int i = 0; i < k; i++) {
+            x *= 10;
+        }
+        string col = format("10^{}", k);
+        auto primes = classic_sieve(isqrt(x));
+
+        printcl("speed test prime_pi x={}", col);
+        START(fenwick);
+        int64_t pi = prime_pi(x, primes);
+        TIME(fenwick);
+        table[{"prime_pi fenwick", col}] = FORMAT_TIME(fenwick);
+
+        printcl("speed test lucy x={}", col);
+        START(lucy);
+        auto S = lucy_prime_sums<int64_t>(
+            x, primes, [](int64_t) { return 1; }, [](int64_t v) { return v - 1; });
+        TIME(lucy);
+        assert(S[x] == pi);
+        table[{"prime_pi lucy", col}] = FORMAT_TIME(lucy);
+
+        printcl("speed test prime_sum x={}", col);
+        START(sum);
+        prime_sum(x);
+        TIME(sum);
+        table[{"prime_sum", col}] = FORMAT_TIME(sum);
+
+        if (k <= 12) {
+            printcl("speed test mertens x={}", col);
+            START(mertens);
+            mertens(x);
+            TIME(mertens);
+            table[{"mertens", col}] = FORMAT_TIME(mertens);
+
+            printcl("speed test phi_prefix_sum x={}", col);
+            START(phi);
+            phi_prefix_sum(x);
+            TIME(phi);
+            table[{"phi_prefix_sum", col}] = FORMAT_TIME(phi);
+        }
+        if (k == 10) {
+            printcl("speed test wheel x={}", col);
+            START(wheel);
+            assert(count_primes(1, x, primes) == pi);
+            TIME(wheel);
+            table[{"count_primes wheel", col}] = FORMAT_TIME(wheel);
+        }
+    }
+
+    print_time_table(table, "Prime counting");
+}
+
+int main() {
+    RUN_BLOCK(unit_test_prime_pi());
+    RUN_BLOCK(stress_test_prime_counting());
+    RUN_BLOCK(speed_test_prime_counting());
+    return 0;
+}
@@ -65,16 +65,176 @@ void stress_test_miller_rabin() {
         for (long n : large_primes) {
             large_prime[n - L] = true;
         }
-        for (long n = L; n <= N; n++) {
+        for (long n = L; n <= R; n++) {
             assert(large_prime[n - L] == miller_rabin(n));
         }
     }
 }
 
+// The previous trial division and modpow-based miller-rabin, for reference
+auto slow_factorize(int64_t n) {
+    map<int64_t, int> primes;
+    for (int64_t p = 2; p * p <= n; p++) {
+        while (n % p == 0) {
+            n /= p;
+            primes[p]++;
+        }
+    }
+    if (n > 1) {
+        primes[n]++;
+    }
+    return primes;
+}
+
+bool slow_miller_rabin(int64_t n) {
+    if (n < 5)
+        return n == 2 || n == 3;
+    if (n % 2 == 0)
+        return false;
+    int r = __builtin_ctzll(n - 1);
+    int64_t d = n >> r;
+    for (int witness : {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37}) {
+        if (witness == n)
+            return true;
+        auto x = modpow(int64_t(witness), d, n);
+        if (x == 1 || x == n - 1)
+            continue;
+        for (int i = 0; i < r - 1 && x != n - 1; i++) {
+            x = __int128_t(x) * __int128_t(x) % n;
+        }
+        if (x != n - 1)
+            return false;
+    }
+    return true;
+}
+
+int64_t random_prime(int64_t lo, int64_t hi) {
+    int64_t p;
+    do {
+        p = rand_unif<int64_t>(lo, hi);
+    } while (!miller_rabin(p));
+    return p;
+}
+
+void unit_test_miller_rabin() {
+    // strong pseudoprimes to the first several prime bases
+    for (int64_t n : {3215031751LL, 2152302898747LL, 3474749660383LL, 341550071728321LL,
+                      3825123056546413051LL}) {
+        assert(!miller_rabin(n));
+    }
+    assert(miller_rabin((1LL << 61) - 1) && miller_rabin(9223372036854775783LL));
+    assert(!miller_rabin(int64_t(2147483647) * 2147483647));
+    assert(!miller_rabin(0) && !miller_rabin(1) && !miller_rabin(-7));
+    for (int i = 0; i < 100'000; i++) {
+        int64_t n = rand_unif<int64_t>(1, INT64_MAX) | 1;
+        assert(miller_rabin(n) == slow_miller_rabin(n));
+    }
+}
+
+void stress_test_factorize() {
+    LOOP_FOR_DURATION_TRACKED (3s, now) {
+        print_time(now, 3s, "stress test factorize");
+        int64_t n;
+        if (cointoss(0.3)) {
+            n = rand_unif<int64_t>(1, 1'000'000'000'000);
+            assert(factorize(n) == slow_factorize(n));
+        } else {
+            // a product of random primes and prime powers below 2^62
+            map<int64_t, int> expected;
+            n = 1;
+            while (true) {
+                int bits = rand_unif<int>(2, 40);
+                int64_t p = random_prime(2, (1LL << bits) - 1);
+                int e = cointoss(0.8) || bits > 20 ? 1 : rand_unif<int>(2, 3);
+                int64_t pe = intpow(p, e);
+                if (n > (1LL << 62) / pe) {
+                    break;
+                }
+                n *= pe, expected[p] += e;
+            }
+            assert(factorize(n) == expected);
+        }
+        int64_t phi = 1, m = 1;
+        for (auto [p, e] : factorize(n)) {
+            phi *= intpow(p, e - 1) * (p - 1), m *= intpow(p, e);
+        }
+        assert(m == n && ::phi(n) == phi);
+        if (n <= 1'000'000'000'000) {
+            auto divs = get_divisors(n, true, true);
+            sort(begin(divs), end(divs));
+            int64_t cnt = 0;
+            for (int64_t d = 1; d * d <= n; d++) {
+                if (n % d == 0) {
+                    cnt += d * d == n ? 1 : 2;
+                    assert(binary_search(begin(divs), end(divs), d));
+                    assert(binary_search(begin(divs), end(divs), n / d));
+                }
+            }
+            assert(int64_t(divs.size()) == cnt);
+        }
+    }
+}
+
+void speed_test_factorize() {
+    constexpr int N = 20'000;
+    map<pair<string, string>, string> table;
+
+    auto bench = [&](const string& name, const string& col, auto&& fn) {
+        START_ACC(run);
+        LOOP_FOR_DURATION_OR_RUNS_TRACKED (2s, now, 100, runs) {
+            print_time(now, 2s, "speed test {} {}", name, col);
+            START(run);
+            fn();
+            ADD_TIME(run);
+        }
+        table[{name, col}] = format("{:.0f}/s", 1e9 * runs * N / TIME_NS(run));
+    };
+
+    for (int bits : {32, 40, 48, 56, 62}) {
+        int64_t hi = bits == 62 ? (1LL << 62) : (1LL << bits);
+        auto randoms = rands_unif<int64_t>(N, hi / 2, hi - 1);
+        vector<int64_t> semiprimes(N), primes(N);
+        for (int i = 0; i < N; i++) {
+            int64_t p = random_prime(1LL << (bits / 2 - 1), (1LL << bits / 2) - 1);
+            int64_t q = random_prime(hi / 2 / p + 1, (hi - 1) / p);
+            semiprimes[i] = p * q, primes[i] = random_prime(hi / 2, hi - 1);
+        }
+        string col = format("{}-bit", bits);
+        int64_t sink = 0;
+
+        bench("miller_rabin", col, [&]() {
+            for (int64_t n : primes)
+                sink += miller_rabin(n);
+        });
+        bench("slow miller_rabin", col, [&]() {
+            for (int64_t n : primes)
+                sink += slow_miller_rabin(n);
+        });
+        bench("factorize_batch random", col, [&]() {
+            sink += factorize_batch(randoms).back().size();
+        });
+        bench("factorize_batch semiprime", col, [&]() {
+            sink += factorize_batch(semiprimes).back().size();
+        });
+        if (bits <= 40) {
+            bench("trial division random", col, [&]() {
+                for (int64_t n : randoms)
+                    sink += slow_factorize(n).size();
+            });
+        }
+        printcl("sink: {}\n", sink);
+    }
+
+    print_time_table(table, "Factorizations and primality tests per second");
+}
+
 int main() {
     RUN_BLOCK(test_freq_primitive_root());
     RUN_BLOCK(stress_test_primitive_root());
     RUN_BLOCK(stress_test_jacobi());
     RUN_BLOCK(stress_test_miller_rabin());
+    RUN_BLOCK(unit_test_miller_rabin());
+    RUN_BLOCK(stress_test_factorize());
+    RUN_BLOCK(speed_test_factorize());
     return 0;
 }
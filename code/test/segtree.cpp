@@ -99,7 +99,7 @@ void stress_test_maxsubrange_iterative_segtree() {
     constexpr int N = 200;
 
     vector<int> arr(N, 0);
-    segtree<maxsubrange_segnode> st(N, 0);
+    bottomup_segtree<maxsubrange_segnode> st(N, 0);
 
     LOOP_FOR_DURATION_TRACKED_RUNS (1s, now, runs) {
         if (cointoss(0.5)) {
@@ -192,6 +192,199 @@ void stress_test_polyhash_segtree() {
     }
 }
 
+void stress_test_bottomup_segtree() {
+    using num = modnum<998244353>;
+    polyhash_segnode::init(300, 3);
+
+    LOOP_FOR_DURATION (1s) {
+        int N = rand_unif<int>(1, 300), B = rand_unif<int>(0, 40);
+        auto arr = rands_unif<int, num>(N, 0, 70000);
+        segtree<polyhash_segnode> seg(N, arr);
+        bottomup_segtree<polyhash_segnode> st(N, arr);
+
+        for (int run = 0; run < 20; run++) {
+            vector<pair<int, num>> updates(B);
+            for (auto& [i, v] : updates) {
+                i = rand_unif<int>(0, N - 1), v = rand_unif<int>(0, 70000);
+            }
+            sort(begin(updates), end(updates),
+                 [](auto& a, auto& b) { return a.first < b.first; });
+            for (auto [i, v] : updates) {
+                seg.update_point(i, v);
+            }
+            if (cointoss(0.5)) {
+                st.update_batch(updates);
+            } else {
+                for (auto [i, v] : updates) {
+                    st.update_point(i, v);
+                }
+            }
+
+            vector<pair<int, int>> queries(B);
+            for (auto& q : queries) {
+                auto [l, r] = diff_unif<int>(0, N);
+                q = {l, r};
+            }
+            sort(begin(queries), end(queries));
+            auto got = st.query_batch(queries);
+            for (int k = 0; k < B; k++) {
+                auto [l, r] = queries[k];
+                num actual = seg.query_range(l, r);
+                assert(num(got[k]) == actual);
+                assert(num(st.query_range(l, r)) == actual);
+            }
+            for (int i = 0; i < N; i++) {
+                assert(num(st.query_point(i)) == num(seg.query_point(i)));
+            }
+        }
+    }
+}
+
+void speed_test_bottomup_segtree() {
+    static vector<int> Ns = {1'000, 100'000, 10'000'000};
+    const int M = 1'000'000;
+    map<pair<string, int>, string> table;
+
+    // Every engine consumes the same M sorted operations per run, up to 10^8 operations
+    auto bench = [&](const string& name, int N, auto&& fn) {
+        START_ACC(ops);
+        LOOP_FOR_DURATION_OR_RUNS_TRACKED (2s, now, 100, runs) {
+            print_time(now, 2s, "speed test {} N={}", name, N);
+            START(ops);
+            fn();
+            ADD_TIME(ops);
+        }
+        table[{name, N}] = format("{:.2f}M/s", 1e3 * runs * M / TIME_NS(ops));
+    };
+
+    for (int N : Ns) {
+        auto arr = rands_unif<int, int64_t>(N, -1000, 1000);
+        segtree<simple_segnode> seg(N, arr);
+        bottomup_segtree<simple_segnode> st(N, arr);
+        int64_t sink = 0;
+
+        vector<pair<int, int64_t>> updates(M);
+        for (auto& [i, v] : updates) {
+            i = rand_unif<int>(0, N - 1), v = rand_unif<int>(-100, 100);
+        }
+        sort(begin(updates), end(updates));
+        vector<pair<int, int>> queries(M);
+        for (auto& q : queries) {
+            auto [l, r] = diff_unif<int>(0, N);
+            q = {l, r};
+        }
+        sort(begin(queries), end(queries));
+
+        bench("recursive update", N, [&]() {
+            for (auto [i, v] : updates)
+                seg.update_point(i, v);
+        });
+        bench("bottomup update", N, [&]() {
+            for (auto [i, v] : updates)
+                st.update_point(i, v);
+        });
+        bench("batched update", N, [&]() { st.update_batch(updates); });
+        bench("recursive query", N, [&]() {
+            for (auto [l, r] : queries)
+                sink += seg.query_range(l, r);
+        });
+        bench("bottomup query", N, [&]() {
+            for (auto [l, r] : queries)
+                sink += st.query_range(l, r);
+        });
+        bench("batched query", N, [&]() {
+            for (auto& x : st.query_batch(queries))
+                sink += x;
+        });
+        printcl("sink: {}\n", sink);
+    }
+
+    print_time_table(table, "Segtree engines, operations per second (cols=N)");
+}
+
+template <typename Layout>
+void stress_test_segtree_layout(const string& name) {
+    LOOP_FOR_DURATION_TRACKED (1s, now) {
+        print_time(now, 1s, "stress test {} layout", name);
+        int N = rand_unif<int>(1, 300);
+        auto arr = rands_unif<int, int64_t>(N, 0, 1000);
+        segtree<sum_segnode, Layout> st(N, arr);
+
+        for (int run = 0; run < 100; run++) {
+            auto [L, R] = diff_unif<int>(0, N);
+            if (cointoss(0.5)) {
+                int v = rand_unif<int>(0, 100);
+                st.update_range(L, R, v);
+                for (int i = L; i < R; i++) {
+                    arr[i] += v;
+                }
+            }
+            if (cointoss(0.5)) {
+                int i = rand_unif<int>(0, N - 1), v = rand_unif<int>(0, 100);
+                st.update_point(i, v);
+                arr[i] += v;
+            }
+            int64_t sum = accumulate(begin(arr) + L, begin(arr) + R, int64_t(0));
+            assert(st.query_range(L, R) == sum);
+            assert(st.query_point(L % N) == arr[L % N]);
+
+            auto total = st.query_all().value;
+            auto [k, prefix] = st.prefix_binary_search(
+                [&](auto& x) { return 2 * x.value > total; });
+            int64_t sk = accumulate(begin(arr), begin(arr) + k, int64_t(0));
+            assert(prefix.value == sk && 2 * sk <= total);
+            assert(k == N || 2 * (sk + arr[k]) > total);
+        }
+    }
+}
+
+template <typename Layout>
+void speed_test_segtree_layout(const string& name,
+                               map<pair<string, int>, string>& table) {
+    static vector<int> Ns = {1'000, 100'000, 10'000'000, 100'000'000};
+    const int M = 1'000'000;
+
+    for (int N : Ns) {
+        segtree<simple_segnode, Layout> st(N, rands_unif<int, int64_t>(N, 0, 1000));
+        vector<array<int, 2>> queries(M);
+        for (auto& q : queries) {
+            q = diff_unif<int>(0, N);
+        }
+        int64_t sink = 0, total = st.query_all();
+
+        START_ACC3(query, update, search);
+        LOOP_FOR_DURATION_OR_RUNS_TRACKED (2s, now, 100, runs) {
+            print_time(now, 2s, "speed test {} layout N={}", name, N);
+            START(query);
+            for (auto [l, r] : queries)
+                sink += st.query_range(l, r);
+            ADD_TIME(query);
+            START(update);
+            for (auto [i, v] : queries)
+                st.update_point(i, v % 1000);
+            ADD_TIME(update);
+            START(search);
+            for (auto [l, r] : queries) {
+                int64_t x = total / N * int64_t(l);
+                sink += st.prefix_binary_search([&](auto& v) { return v > x; }).first;
+            }
+            ADD_TIME(search);
+        }
+        table[{name + " query", N}] = FORMAT_EACH(query, runs * M);
+        table[{name + " update", N}] = FORMAT_EACH(update, runs * M);
+        table[{name + " search", N}] = FORMAT_EACH(search, runs * M);
+        printcl("sink: {}\n", sink);
+    }
+}
+
+void speed_test_segtree_layouts() {
+    map<pair<string, int>, string> table;
+    speed_test_segtree_layout<heap_layout>("heap", table);
+    speed_test_segtree_layout<blocked_layout<3>>("blocked<3>", table);
+    speed_test_segtree_layout<veb_layout>("veb", table);
+    print_time_table(table, "Segtree layouts, time per operation (cols=N)");
+}
+
 void speed_test_segtree() {
     constexpr int N = 500'000;
 
@@ -224,6 +417,13 @@ int main() {
     RUN_BLOCK(stress_test_maxsubrange_iterative_segtree());
     RUN_BLOCK(stress_test_affine_segtree());
     RUN_BLOCK(stress_test_polyhash_segtree());
+    RUN_BLOCK(stress_test_bottomup_segtree());
+    RUN_BLOCK(stress_test_segtree_layout<heap_layout>("heap"));
+    RUN_BLOCK(stress_test_segtree_layout<blocked_layout<2>>("blocked<2>"));
+    RUN_BLOCK(stress_test_segtree_layout<blocked_layout<5>>("blocked<5>"));
+    RUN_BLOCK(stress_test_segtree_layout<veb_layout>("veb"));
     RUN_BLOCK(speed_test_segtree());
+    RUN_BLOCK(speed_test_bottomup_segtree());
+    RUN_BLOCK(speed_test_segtree_layouts());
     return 0;
 }
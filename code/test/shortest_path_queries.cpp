@@ -0,0 +1,121 @@
+#include "test_utils.hpp"
+#include "graphs/shortest_path_queries.hpp"
+#include "lib/graph_generator.hpp"
+
+auto make_p2p_graph(const string& family, int V) {
+    if (family == "grid") {
+        int W = max(1, int(sqrt(V)));
+        return make_pair(W * W, grid_graph(W, W)); // both ways
+    } else if (family == "geometric") {
+        return make_pair(V, random_geometric_directed(V, min(1.0, 4.0 / V), 0.3));
+    } else {
+        return make_pair(V, random_exact_directed(V, min(3LL * V, 1LL * V * (V - 1))));
+    }
+}
+
+void stress_test_p2p_engines() {
+    static const vector<string> families = {"uniform", "grid", "geometric"};
+
+    LOOP_FOR_DURATION_TRACKED (4s, now) {
+        print_time(now, 4s, "stress test p2p engines");
+        auto family = families[rand_unif<int>(0, 2)];
+        int n = rand_unif<int>(1, cointoss(0.5) ? 30 : 1500);
+        auto [V, g] = make_p2p_graph(family, n);
+        int E = g.size();
+        long maxcost = cointoss(0.3) ? rand_unif<int>(0, 3) : rand_unif<int>(1, 100'000);
+        auto cost = rands_unif<int, long>(E, 0, maxcost);
+        csr_graph<long> csr(V, g, cost, family == "grid");
+
+        bidirectional_dijkstra<long> bidir(csr);
+        alt_landmarks<long> alt(csr, rand_unif<int>(1, 8));
+        int core = cointoss(0.5) ? INT_MAX : rand_unif<int>(0, 20);
+        contraction_hierarchy<long> ch(csr, rand_unif<int>(1, 100), core);
+
+        // the serialized form answers the same, and copies have their own workspace
+        stringstream ss;
+        ch.save(ss);
+        contraction_hierarchy<long> loaded;
+        loaded.load(ss);
+        assert(loaded.rank == ch.rank && loaded.up.to == ch.up.to);
+        assert(loaded.down.cost == ch.down.cost);
+        assert(loaded.index_size() == ch.index_size());
+        auto copy = ch;
+
+        for (int q = 0; q < 8; q++) {
+            int s = rand_unif<int>(0, V - 1);
+            auto dist = dijkstra(s, csr);
+            for (int r = 0; r < 10; r++) {
+                int t = rand_unif<int>(0, V - 1);
+                assert(bidir.query(s, t) == dist[t]);
+                assert(alt.query(s, t) == dist[t]);
+                assert(ch.query(s, t) == dist[t]);
+                assert(loaded.query(s, t) == dist[t]);
+                assert(copy.query(s, t) == dist[t]);
+            }
+        }
+    }
+}
+
+void speed_test_p2p_engines() {
+    static const vector<pair<string, int>> inputs = {
+        {"grid", 40'000}, {"grid", 250'000}, {"uniform", 10'000}, {"uniform", 100'000}};
+    const int Q = 1000, maxcost = 1000;
+    map<pair<string, string>, string> table;
+
+    for (auto [family, n] : inputs) {
+        auto [V, g] = make_p2p_graph(family, n);
+        auto cost = rands_unif<int, long>(g.size(), 1, maxcost);
+        csr_graph<long> csr(V, g, cost, family == "grid");
+        auto queries = rands_unif<int>(2 * Q, 0, V - 1);
+        vector<long> expected; // from the first engine, the others must match
+
+        auto bench = [&](const string& name, auto&& build, auto&& index_size) {
+            string row = format("{} V={} {}", family, V, name);
+            printcl("speed test {}", row);
+            START(preprocess);
+            auto engine = build();
+            TIME(preprocess);
+
+            vector<int64_t> latency(Q);
+            for (int q = 0; q < Q; q++) {
+                START(query);
+                auto d = engine.query(queries[2 * q], queries[2 * q + 1]);
+                TIME(query);
+                latency[q] = TIME_NS(query);
+                if (int(expected.size()) <= q) {
+                    expected.push_back(d);
+                } else {
+                    assert(d == expected[q]);
+                }
+            }
+            sort(begin(latency), end(latency));
+            table[{row, "preprocess"}] = FORMAT_TIME(preprocess);
+            table[{row, "index"}] = format("{:.1f}MB", index_size(engine) / 1e6);
+            table[{row, "p50"}] = format_duration(latency[Q / 2]);
+            table[{row, "p99"}] = format_duration(latency[Q * 99 / 100]);
+        };
+        int64_t graph_size = csr.E * (sizeof(int) + sizeof(long)) + (V + 1) * sizeof(int);
+
+        bench(
+            "bidir", [&]() { return bidirectional_dijkstra(csr); },
+            [&](auto&) { return 2 * graph_size; });
+        bench(
+            "alt K=16", [&]() { return alt_landmarks(csr, 16); },
+            [&](auto& alt) { return graph_size + 2 * alt.from.size() * sizeof(long); });
+
+        // random graphs have no hierarchy, contracting them fully takes minutes
+        int core = family == "grid" ? INT_MAX : 40;
+        bench(
+            core == INT_MAX ? "ch"s : format("ch core={}", core),
+            [&]() { return contraction_hierarchy(csr, 100, core); },
+            [&](auto& ch) { return ch.index_size(); });
+    }
+
+    print_time_table(table, "Point to point queries, 1000 random pairs");
+}
+
+int main() {
+    RUN_BLOCK(stress_test_p2p_engines());
+    RUN_BLOCK(speed_test_p2p_engines());
+    return 0;
+}
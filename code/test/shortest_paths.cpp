@@ -0,0 +1,90 @@
+#include "test_utils.hpp"
+#include "graphs/shortest_paths.hpp"
+#include "lib/graph_generator.hpp"
+
+auto make_sssp_graph(const string& family, int V) {
+    if (family == "grid") {
+        int W = max(1, int(sqrt(V)));
+        return make_pair(W * W, grid_graph(W, W)); // both ways
+    } else if (family == "geometric") {
+        return make_pair(V, random_geometric_directed(V, min(1.0, 4.0 / V), 0.3));
+    } else {
+        return make_pair(V, random_exact_directed(V, min(4LL * V, 1LL * V * (V - 1))));
+    }
+}
+
+void stress_test_sssp_engines() {
+    thread_pool pool(4);
+    static const vector<string> families = {"uniform", "grid", "geometric"};
+
+    LOOP_FOR_DURATION_TRACKED (4s, now) {
+        print_time(now, 4s, "stress test sssp engines");
+        auto family = families[rand_unif<int>(0, 2)];
+        int n = rand_unif<int>(2, cointoss(0.5) ? 30 : 3000);
+        auto [V, g] = make_sssp_graph(family, n);
+        int E = g.size();
+        long maxcost = cointoss(0.3) ? rand_unif<int>(0, 3) : rand_unif<int>(1, 100'000);
+        auto cost = rands_unif<int, long>(E, 0, maxcost);
+        csr_graph<long> csr(V, g, cost, family == "grid");
+        int s = rand_unif<int>(0, V - 1);
+
+        auto dist = dijkstra(s, csr);
+        assert(radix_dijkstra(s, csr) == dist);
+        assert(delta_stepping(pool, s, csr) == dist);
+        assert(delta_stepping(pool, s, csr, rand_unif<long>(1, maxcost + 1)) == dist);
+        if (maxcost <= 1000) {
+            assert(dial(s, csr) == dist);
+        }
+    }
+}
+
+void speed_test_sssp_engines() {
+    static const vector<string> families = {"uniform", "grid", "geometric"};
+    static const vector<int> maxcosts = {10, 1000, 1'000'000};
+    static const vector<int> Vs = {100'000, 1'000'000, 4'000'000};
+    thread_pool pool(4);
+    map<tuple<string, string, int>, string> table;
+
+    for (int n : Vs) {
+        for (const auto& family : families) {
+            auto [V, g] = make_sssp_graph(family, n);
+            for (int maxcost : maxcosts) {
+                auto cost = rands_unif<int, long>(g.size(), 1, maxcost);
+                csr_graph<long> csr(V, g, cost, family == "grid");
+                string row = format("{} C={}", family, maxcost);
+                auto sources = rands_unif<int>(3, 0, V - 1);
+                vector<vector<long>> dist; // from the first engine, the others must match
+
+                auto bench = [&](const string& name, auto&& fn) {
+                    printcl("speed test {} {} V={}", name, row, n);
+                    START(run);
+                    for (int i = 0, S = sources.size(); i < S; i++) {
+                        auto d = fn(sources[i]);
+                        if (int(dist.size()) <= i) {
+                            dist.push_back(move(d));
+                        } else {
+                            assert(d == dist[i]);
+                        }
+                    }
+                    TIME(run);
+                    table[{row, name, n}] = FORMAT_EACH(run, sources.size());
+                };
+
+                bench("pairing", [&](int s) { return dijkstra(s, csr); });
+                bench("radix", [&](int s) { return radix_dijkstra(s, csr); });
+                bench("delta T=4", [&](int s) { return delta_stepping(pool, s, csr); });
+                if (maxcost <= 1000) {
+                    bench("dial", [&](int s) { return dial(s, csr); });
+                }
+            }
+        }
+    }
+
+    print_time_table(table, "Single source shortest paths, time per source (cols=V)");
+}
+
+int main() {
+    RUN_BLOCK(stress_test_sssp_engines());
+    RUN_BLOCK(speed_test_sssp_engines());
+    return 0;
+}
@@ -48,6 +48,170 @@ void speed_test_sieves() {
     print_time_table(table, "Sieves");
 }
 
+// The previous count_primes over a vector<bool> of the whole range, for reference
+auto slow_range_isprime(int64_t L, int64_t R, const vector<int>& primes) {
+    vector<bool> isprime(R - L + 1, true);
+    for (int64_t p : primes) {
+        if (p * p > R)
+            break;
+        int64_t k = max((L + p - 1) / p, p);
+        for (int64_t n = k * p; n <= R; n += p)
+            isprime[n - L] = false;
+    }
+    isprime[0] = isprime[0] & (L > 1);
+    return isprime;
+}
+
+int64_t slow_count_primes(int64_t L, int64_t R, const vector<int>& primes) {
+    auto isprime = slow_range_isprime(L, R, primes);
+    return count(begin(isprime), end(isprime), true);
+}
+
+void stress_test_wheel_sieve() {
+    auto primes = classic_sieve(1'000'000);
+    thread_pool pool(3);
+
+    LOOP_FOR_DURATION_TRACKED (3s, now) {
+        print_time(now, 3s, "stress test wheel sieve");
+        int64_t L, R;
+        if (cointoss(0.5)) {
+            L = rand_unif<int64_t>(1, 3000), R = L + rand_unif<int64_t>(0, 3000);
+        } else {
+            int64_t M = cointoss(0.5) ? 1'000'000'000'000 : 1'000'000'000;
+            int64_t K = rand_unif<int64_t>(0, cointoss(0.9) ? 100'000 : 3'000'000);
+            R = rand_unif<int64_t>(K + 1, M), L = R - K;
+        }
+        auto isprime = slow_range_isprime(L, R, primes);
+        vector<int64_t> expected;
+        for (int64_t n = L; n <= R; n++) {
+            if (isprime[n - L]) {
+                expected.push_back(n);
+            }
+        }
+        int64_t cnt = expected.size();
+        assert(count_primes(L, R, primes) == cnt);
+        assert(get_primes(L, R, primes) == expected);
+        if (R - L > 100'000) {
+            assert(count_primes(pool, L, R, primes) == cnt);
+            assert(get_primes(pool, L, R, primes) == expected);
+        }
+    }
+}
+
+void unit_test_count_primes() {
+    auto primes = classic_sieve(1'000'000);
+    thread_pool pool(2);
+    vector<int64_t> pi = {0, 4, 25, 168, 1229, 9592, 78498, 664579, 5761455, 50847534};
+    for (int64_t k = 0, N = 1; k < int(pi.size()); k++, N *= 10) {
+        assert(count_primes(1, N, primes) == pi[k]);
+        assert(count_primes(pool, 1, N, primes) == pi[k]);
+    }
+    // pi(10^12) - pi(10^12 - 10^8)
+    int64_t M = 1'000'000'000'000;
+    assert(count_primes(pool, M - 100'000'000 + 1, M, primes) ==
+           slow_count_primes(M - 100'000'000 + 1, M, primes));
+}
+
+void stress_test_multiplicative_range_sieve() {
+    constexpr int N = 300'000;
+    auto primes = classic_sieve(1'000'000);
+    auto phi = phi_sieve(N);
+    auto tau = num_divisors_sieve(N);
+    auto [_, lp, nxt] = least_prime_sieve(N);
+    thread_pool pool(3);
+
+    LOOP_FOR_DURATION_TRACKED (2s, now) {
+        print_time(now, 2s, "stress test multiplicative range sieve");
+        auto [L, R] = diff_unif<int>(1, N);
+        auto phis = range_phi_sieve(L, R, primes);
+        auto mus = range_mobius_sieve(L, R, primes);
+        auto taus = range_num_divisors_sieve(L, R, primes);
+        auto pphis = multiplicative_range_sieve<int64_t>(
+            pool, L, R, primes, [](int64_t p, int, int64_t pe) { return pe - pe / p; });
+        for (int n = L; n <= R; n++) {
+            int mu = 1;
+            for (int m = n; m > 1; m = nxt[m]) {
+                mu = lp[m] == lp[nxt[m]] ? 0 : -mu;
+            }
+            assert(phis[n - L] == phi[n] && pphis[n - L] == phi[n]);
+            assert(taus[n - L] == tau[n]);
+            assert(mus[n - L] == mu);
+        }
+    }
+
+    // near 10^12 check against trial division
+    int64_t M = 1'000'000'000'000 - 1000;
+    auto phis = range_phi_sieve(M, M + 1000, primes);
+    for (int64_t n = M; n <= M + 1000; n++) {
+        int64_t m = n, ph = n;
+        for (int64_t p = 2; p * p <= m; p++) {
+            if (m % p == 0) {
+                ph -= ph / p;
+                while (m % p == 0)
+                    m /= p;
+            }
+        }
+        if (m > 1) {
+            ph -= ph / m;
+        }
+        assert(phis[n - M] == ph);
+    }
+}
+
+void speed_test_count_primes() {
+    static vector<int64_t> Ns = {10'000'000, 100'000'000, 1'000'000'000, 10'000'000'000};
+    auto primes = classic_sieve(1'000'000);
+    map<pair<string, int64_t>, string> table;
+
+    for (int64_t N : Ns) {
+        printcl("speed test count primes N={}", N);
+        if (N <= 1'000'000'000) {
+            START(classic);
+            auto cnt = classic_sieve(N).size();
+            TIME(classic);
+            START(slow);
+            assert(slow_count_primes(1, N, primes) == int64_t(cnt));
+            TIME(slow);
+            table[{"classic_sieve", N}] = FORMAT_TIME(classic);
+            table[{"vector<bool> range", N}] = FORMAT_TIME(slow);
+        }
+
+        START(wheel);
+        int64_t cnt = count_primes(1, N, primes);
+        TIME(wheel);
+        table[{"wheel", N}] = FORMAT_TIME(wheel);
+        table[{"wheel M/s", N}] = format("{:.0f}M/s", 1e3 * N / TIME_NS(wheel));
+
+        for (int T : {2, 4}) {
+            thread_pool pool(T);
+            START(parallel);
+            assert(count_primes(pool, 1, N, primes) == cnt);
+            TIME(parallel);
+            table[{format("wheel T={}", T), N}] = FORMAT_TIME(parallel);
+        }
+
+        // a window of the same length ending at 10^12
+        int64_t M = 1'000'000'000'000;
+        START(window);
+        count_primes(M - N + 1, M, primes);
+        TIME(window);
+        table[{"wheel at 10^12", N}] = FORMAT_TIME(window);
+
+        if (N <= 100'000'000) {
+            START(phi);
+            phi_sieve(N);
+            TIME(phi);
+            START(range_phi);
+            range_phi_sieve(1, N, primes);
+            TIME(range_phi);
+            table[{"phi_sieve", N}] = FORMAT_TIME(phi);
+            table[{"range_phi_sieve", N}] = FORMAT_TIME(range_phi);
+        }
+    }
+
+    print_time_table(table, "Prime counting and segmented sieves");
+}
+
 void unit_test_sieves() {
     constexpr int N = 100, M = 21;
 
@@ -104,6 +268,10 @@ void unit_test_num_divisors_sieve() {
 int main() {
     RUN_BLOCK(unit_test_sieves());
     RUN_BLOCK(unit_test_num_divisors_sieve());
+    RUN_BLOCK(unit_test_count_primes());
+    RUN_BLOCK(stress_test_wheel_sieve());
+    RUN_BLOCK(stress_test_multiplicative_range_sieve());
+    RUN_BLOCK(speed_test_count_primes());
     RUN_BLOCK(speed_test_sieves());
     return 0;
 }
@@ -143,6 +143,96 @@ void stress_test_disjoint_sparse_table_2d() {
     }
 }
 
+void stress_test_block_min_rmq() {
+    LOOP_FOR_DURATION_TRACKED (1s, now) {
+        print_time(now, 1s, "stress test block min rmq");
+        int N = rand_unif<int>(1, 300);
+        auto A = rands_unif<int>(N, -100, 100);
+        min_rmq<int> rmq(A);
+        block_min_rmq<int> brmq(A);
+
+        for (int a = 0; a < N; a++) {
+            for (int b = a + 1; b <= N; b++) {
+                int x = *min_element(begin(A) + a, begin(A) + b);
+                assert(rmq.query(a, b) == x && brmq.query(a, b) == x);
+            }
+        }
+    }
+}
+
+void speed_test_min_rmq() {
+    static vector<int64_t> Ns = {1'000'000, 10'000'000, 100'000'000, 1'000'000'000};
+    static constexpr int64_t MAX_BYTES = 3LL << 30; // skip what does not fit
+    const int Q = 10'000'000;
+    map<pair<string, int64_t>, string> table;
+
+    auto memory = [&](const auto& rmq) {
+        int64_t bytes = 0;
+        if constexpr (is_same_v<decay_t<decltype(rmq)>, min_rmq<int>>) {
+            for (const auto& row : rmq.jmp)
+                bytes += row.size() * sizeof(int);
+        } else {
+            bytes += rmq.v.size() * sizeof(int) + rmq.mask.size() * sizeof(uint32_t);
+            for (const auto& row : rmq.blocks.jmp)
+                bytes += row.size() * sizeof(int);
+        }
+        return format("{:.1f}MB", bytes / 1e6);
+    };
+    auto estimate = [&](int64_t N, bool sparse) {
+        double L = log2(N), M = N / 32.0;
+        return sparse ? N * L * sizeof(int) : N * 8.0 + M * log2(M) * sizeof(int);
+    };
+
+    for (int64_t N : Ns) {
+        bool fit_sparse = estimate(N, true) + N * 4 < MAX_BYTES;
+        bool fit_block = estimate(N, false) + N * 4 < MAX_BYTES;
+        if (!fit_sparse)
+            table[{"min_rmq memory", N}] = format("~{:.0f}MB", estimate(N, 1) / 1e6);
+        if (!fit_block)
+            table[{"block_min_rmq memory", N}] =
+                format("~{:.0f}MB", estimate(N, 0) / 1e6);
+        if (!fit_sparse && !fit_block)
+            continue;
+
+        printcl("speed test min rmq N={}", N);
+        auto A = rands_unif<int>(N, 0, 1'000'000'000);
+        vector<array<int, 2>> queries(Q);
+        for (auto& q : queries) {
+            q = diff_unif<int>(0, N);
+        }
+        int64_t sum = 0, bsum = 0;
+
+        if (fit_sparse) {
+            START(build);
+            min_rmq<int> rmq(A);
+            TIME(build);
+            START(query);
+            for (auto [a, b] : queries)
+                sum += rmq.query(a, b);
+            TIME(query);
+            table[{"min_rmq build", N}] = FORMAT_TIME(build);
+            table[{"min_rmq query", N}] = FORMAT_EACH(query, Q);
+            table[{"min_rmq memory", N}] = memory(rmq);
+        }
+        if (fit_block) {
+            START(build);
+            block_min_rmq<int> rmq(A);
+            TIME(build);
+            START(query);
+            for (auto [a, b] : queries)
+                bsum += rmq.query(a, b);
+            TIME(query);
+            table[{"block_min_rmq build", N}] = FORMAT_TIME(build);
+            table[{"block_min_rmq query", N}] = FORMAT_EACH(query, Q);
+            table[{"block_min_rmq memory", N}] = memory(rmq);
+        }
+        assert(!fit_sparse || !fit_block || sum == bsum);
+    }
+
+    // ~ marks estimated memory for sizes that do not fit here
+    print_time_table(table, "Min RMQ, random queries (cols=N)");
+}
+
 void speed_test_sparse_table_2d() {
     vector<int> Ns = {60, 100, 150, 220, 300, 400};
 
@@ -219,6 +309,8 @@ int main() {
     RUN_BLOCK(stress_test_sparse_index_table());
     RUN_BLOCK(stress_test_sparse_table_2d());
     RUN_BLOCK(stress_test_disjoint_sparse_table_2d());
+    RUN_BLOCK(stress_test_block_min_rmq());
     RUN_BLOCK(speed_test_sparse_table_2d());
+    RUN_BLOCK(speed_test_min_rmq());
     return 0;
 }
@@ -14,6 +14,7 @@ auto arr_key(const deque<int>& arr) { return arr[rand_unif<int>(0, arr.size() -
 
 auto key_range() { return diff_unif<int>(0, MAXKEY); }
 
+template <typename Splay>
 auto rand_splay() { return new Splay(any_key()); }
 
 auto ordered(int L, int R) {
@@ -21,9 +22,51 @@ auto ordered(int L, int R) {
     return a <= b ? array<int, 2>{a, b} : array<int, 2>{b, a};
 }
 
-void stress_test_splay_order() {
+// The Splay of splay.hpp over another node allocator
+template <typename Alloc>
+struct AllocSplay : basic_splay<AllocSplay<Alloc>, Alloc> {
+    int size = 1;
+    int64_t key;
+    int64_t sum = 0;
+    int64_t lazy = 0;
+
+    explicit AllocSplay(int64_t key) : key(key), sum(key) {}
+
+    static auto get_key(const AllocSplay* x) { return x->key; }
+    static int get_size(const AllocSplay* x) { return x ? x->size : 0; }
+    static int64_t get_sum(const AllocSplay* x) { return x ? x->sum : 0; }
+
+    void update_self(int64_t add) {
+        key += add;
+        sum += add;
+    }
+
+    void update_range(int64_t add) {
+        key += add;
+        lazy += add;
+        sum += 1LL * add * size;
+    }
+
+    void pushdown() {
+        if (lazy) {
+            if (this->kids[0])
+                this->kids[0]->update_range(lazy);
+            if (this->kids[1])
+                this->kids[1]->update_range(lazy);
+            lazy = 0;
+        }
+    }
+
+    void pushup() {
+        sum = key + get_sum(this->kids[0]) + get_sum(this->kids[1]);
+        size = 1 + get_size(this->kids[0]) + get_size(this->kids[1]);
+    }
+};
+
+template <typename Splay>
+void stress_test_splay_order(const string& name) {
     LOOP_FOR_DURATION_OR_RUNS_TRACKED (20s, now, 1000, runs) {
-        print_time(now, 20s, "stress splay order ({} runs)", runs);
+        print_time(now, 20s, "stress {} order ({} runs)", name, runs);
         const int MAX = 200;
         int N = 0;
         deque<int> arr;
@@ -53,7 +96,7 @@ void stress_test_splay_order() {
                 arr.pop_back(), N--;
             }
             if (cointoss(0.95) && N < MAX) { // * push_back
-                auto node = rand_splay();
+                auto node = rand_splay<Splay>();
                 push_back(tree, node);
                 arr.push_back(node->key), N++;
             }
@@ -62,7 +105,7 @@ void stress_test_splay_order() {
                 arr.pop_front(), N--;
             }
             if (cointoss(0.95) && N < MAX) { // * push_front
-                auto node = rand_splay();
+                auto node = rand_splay<Splay>();
                 push_front(tree, node);
                 arr.push_front(node->key), N++;
             }
@@ -75,7 +118,7 @@ void stress_test_splay_order() {
             }
             if (cointoss(0.95) && N < MAX) { // * insert_order
                 int order = rand_unif<int>(-1, N + 1);
-                auto node = rand_splay();
+                auto node = rand_splay<Splay>();
                 insert_order(tree, node, order);
                 order = clamp(order, 0, N);
                 arr.insert(begin(arr) + order, node->key), N++;
@@ -221,9 +264,10 @@ void stress_test_splay_order() {
     }
 }
 
-void stress_test_splay_key() {
+template <typename Splay>
+void stress_test_splay_key(const string& name) {
     LOOP_FOR_DURATION_OR_RUNS_TRACKED (20s, now, 1000, runs) {
-        print_time(now, 20s, "stress splay key ({} runs)", runs);
+        print_time(now, 20s, "stress {} key ({} runs)", name, runs);
         const int MAX = 200;
         int N = 0;
         deque<int> arr;
@@ -246,7 +290,7 @@ void stress_test_splay_key() {
                 arr.erase(get(key)), N--;
             }
             if (cointoss(0.95) && N < MAX) { // * insert_key
-                auto node = rand_splay();
+                auto node = rand_splay<Splay>();
                 insert_key(tree, node);
                 arr.insert(get(node->key), node->key), N++;
             }
@@ -366,7 +410,7 @@ void stress_test_splay_key() {
                 int G = (MAX - N + 1) / 2;
                 Splay* other = nullptr;
                 for (int i = 0; i < G; i++) {
-                    auto node = rand_splay();
+                    auto node = rand_splay<Splay>();
                     insert_key(other, node);
                     arr.push_back(node->key);
                 }
@@ -385,8 +429,82 @@ void stress_test_splay_key() {
     }
 }
 
+template <typename Alloc, typename Splay = AllocSplay<Alloc>>
+void speed_test_splay_allocator(const string& name,
+                                map<pair<string, int>, string>& table) {
+    static vector<int> Ns = {10'000, 100'000, 1'000'000};
+
+    for (int N : Ns) {
+        printcl("speed test splay allocator {} N={}", name, N);
+        vector<int> keys(2 * N);
+        iota(begin(keys), end(keys), 0);
+        shuffle(begin(keys), end(keys), mt);
+        vector<Splay*> nodes(N);
+        vector<int> picks = rands_unif<int>(N, 0, N - 1);
+
+        if constexpr (!is_same_v<Alloc, global_allocator>) {
+            Alloc::template release<Splay>(); // drop the nodes leaked by the stress tests
+        }
+        int64_t before = resident_memory();
+        if constexpr (is_same_v<Alloc, index_allocator>) {
+            Alloc::template reserve<Splay>(N + 1);
+        }
+        START(alloc);
+        for (int i = 0; i < N; i++) {
+            nodes[i] = new Splay(keys[i]);
+        }
+        TIME(alloc);
+        int64_t after = resident_memory();
+
+        Splay* tree = nullptr;
+        START(build);
+        for (int i = 0; i < N; i++) {
+            insert_key(tree, nodes[i]);
+        }
+        TIME(build);
+
+        // erase a random key and insert a fresh one, so the allocator recycles nodes
+        START(churn);
+        for (int t = 0; t < N; t++) {
+            int i = picks[t];
+            delete_key(tree, keys[i]);
+            keys[i] = keys[N + t];
+            insert_key(tree, new Splay(keys[i]));
+        }
+        TIME(churn);
+
+        START(release);
+        if constexpr (is_same_v<Alloc, global_allocator>) {
+            delete_all(tree);
+        } else {
+            Alloc::template release<Splay>();
+        }
+        TIME(release);
+
+        table[{name + " alloc", N}] = FORMAT_EACH(alloc, N);
+        table[{name + " build", N}] = FORMAT_EACH(build, N);
+        table[{name + " churn", N}] = FORMAT_EACH(churn, N);
+        table[{name + " release", N}] = FORMAT_EACH(release, N);
+        table[{name + " rss/node", N}] = format("{:.1f}B", 1.0 * (after - before) / N);
+    }
+}
+
+void speed_test_splay_allocators() {
+    map<pair<string, int>, string> table;
+    speed_test_splay_allocator<global_allocator>("global", table);
+    speed_test_splay_allocator<arena_allocator>("arena", table);
+    speed_test_splay_allocator<pool_allocator>("pool", table);
+    speed_test_splay_allocator<index_allocator>("index", table);
+    print_time_table(table, "Splay allocators, time per node (cols=N)");
+}
+
 int main() {
-    RUN_BLOCK(stress_test_splay_order());
-    RUN_BLOCK(stress_test_splay_key());
+    RUN_BLOCK(stress_test_splay_order<Splay>("splay"));
+    RUN_BLOCK(stress_test_splay_key<Splay>("splay"));
+    RUN_BLOCK(stress_test_splay_order<AllocSplay<pool_allocator>>("pool splay"));
+    RUN_BLOCK(stress_test_splay_key<AllocSplay<pool_allocator>>("pool splay"));
+    RUN_BLOCK(stress_test_splay_order<AllocSplay<index_allocator>>("index splay"));
+    RUN_BLOCK(stress_test_splay_key<AllocSplay<index_allocator>>("index splay"));
+    RUN_BLOCK(speed_test_splay_allocators());
     return 0;
 }
@@ -3,6 +3,10 @@
 #include "random.hpp"
 #include "lib/test_chrono.hpp"
 #include "lib/test_progress.hpp"
+#ifdef __linux__
+#include <malloc.h>
+#include <unistd.h>
+#endif
 
 template <typename Container>
 bool all_eq(const Container& v) {
@@ -24,6 +28,18 @@ void print_time_table(const vector<vector<U>>& times, const string& label) {
     printcl("===== {}\n{}=====\n", label, mat_to_string(times));
 }
 
+// Resident set size of the process in bytes, after handing free heap pages back to the OS
+int64_t resident_memory() {
+#ifdef __linux__
+    malloc_trim(0);
+    int64_t pages = 0, resident = 0;
+    if (ifstream statm("/proc/self/statm"); statm >> pages >> resident) {
+        return resident * sysconf(_SC_PAGESIZE);
+    }
+#endif
+    return 0;
+}
+
 #define RUN_BLOCK(test)                                                  \
     do {                                                                 \
         printcl("{:<10} === {}\n", "RUN", #test);                        \
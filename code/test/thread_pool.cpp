@@ -5,6 +5,7 @@
 #include "parallel/fn_orchestrator.hpp"
 #include "parallel/graph_orchestrator.hpp"
 #include "parallel/priority_thread_pool.hpp"
+#include "algo/y_combinator.hpp"
 
 using mat_t = mat<unsigned>;
 
@@ -88,6 +89,71 @@ void stress_test_priority_pool_submit(int N = 200, int rate = 47, int nthreads =
     }
 }
 
+void stress_test_pool_nested_submit(int N = 20000, int nthreads = 8) {
+    thread_pool pool(nthreads);
+    atomic<int> sum = 0;
+    // Each job spawns its children in the binary heap numbering, submitted from workers
+    auto spawn = y_combinator([&](auto self, int u) -> void {
+        sum += u;
+        if (2 * u <= N)
+            pool.submit(self, 2 * u);
+        if (2 * u + 1 <= N)
+            pool.submit(self, 2 * u + 1);
+    });
+    spawn(1);
+    pool.wait();
+    assert(pool.empty() && sum == 1L * N * (N + 1) / 2);
+    pool.finish();
+}
+
+void spin_for(chrono::nanoseconds duration) {
+    auto end = chrono::steady_clock::now() + duration;
+    while (chrono::steady_clock::now() < end) {}
+}
+
+template <typename Pool>
+double pool_throughput(int nthreads, int submitters, int J, chrono::nanoseconds dur) {
+    Pool pool(nthreads);
+    vector<thread> threads;
+    START(throughput);
+    for (int s = 0; s < submitters; s++) {
+        threads.emplace_back([&, s]() {
+            for (int j = s; j < J; j += submitters) {
+                pool.submit(spin_for, dur);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    pool.wait();
+    TIME(throughput);
+    pool.finish();
+    return 1e9 * J / TIME_NS(throughput);
+}
+
+void speed_test_pool_throughput() {
+    static vector<int> Ts = {1, 2, 4, 8, 16, 32, 64};
+    static vector<int> Ds = {1, 10, 100, 1000};
+    const auto budget = 200ms;
+    map<tuple<int, int, string>, string> table;
+
+    for (int T : Ts) {
+        for (int D : Ds) {
+            printcl("speed test pool throughput T={} D={}us", T, D);
+            auto duration = chrono::microseconds(D);
+            int J = max(200L, budget / duration);
+            int submitters = min(T, 4);
+            double fifo = pool_throughput<fifo_thread_pool>(T, submitters, J, duration);
+            double steal = pool_throughput<thread_pool>(T, submitters, J, duration);
+            table[{T, D, "fifo"}] = format("{:.0f}/s", fifo);
+            table[{T, D, "steal"}] = format("{:.0f}/s", steal);
+        }
+    }
+
+    print_time_table(table, "Pool throughput (jobs/sec, rows=threads, cols=job us)");
+}
+
 void speed_test_fn_orchestrator() {
     static vector<int> Vs = {100, 500, 1000, 2000};
     static vector<int> Bs = {3, 10, 20, 50};
@@ -189,11 +255,76 @@ void speed_test_graph_orchestrator() {
     print_time_table(table, "Graph orchestrator");
 }
 
+auto read_dot_dag(const string& filename) {
+    ifstream in(filename);
+    assert(in.is_open());
+    vector<array<int, 2>> g;
+    int V = 0;
+    regex edge(R"((\d+)\s*->\s*(\d+))");
+    for (string line; getline(in, line);) {
+        if (smatch m; regex_search(line, m, edge)) {
+            int u = stoi(m[1]), v = stoi(m[2]);
+            g.push_back({u, v}), V = max({V, u + 1, v + 1});
+        }
+    }
+    return make_pair(V, g);
+}
+
+void speed_test_graph_orchestrator_schedules() {
+    vector<tuple<string, int, vector<array<int, 2>>>> dags;
+    auto [dotV, dotg] = read_dot_dag("datasets/dag.dot");
+    dags.emplace_back("dag.dot", dotV, dotg);
+    for (int V : {100, 300, 1000}) {
+        dags.emplace_back("random " + to_string(V), V,
+                          random_exact_rooted_dag_connected(V, 2 * V));
+    }
+    filesystem::create_directories("output");
+    map<tuple<string, int, string>, string> table;
+
+    for (auto& [name, V, g] : dags) {
+        // uneven costs: most jobs are short, a few are 20x longer
+        vector<double> cost(V);
+        for (int u = 0; u < V; u++) {
+            cost[u] = rand_unif<int>(20, 200) * (cointoss(0.1) ? 20 : 1);
+        }
+        auto job = [&](int u) { spin_for(chrono::microseconds(long(cost[u]))); };
+
+        for (int T : {2, 4, 8}) {
+            printcl("speed test orchestrator schedules {} T={}", name, T);
+            graph_orchestrator plain(V, g), critical(V, g);
+            critical.set_costs(cost);
+
+            plain.concurrent_make(job, T);
+            critical.concurrent_make(job, T);
+
+            auto path = critical.bottom_levels();
+            double cp = *max_element(begin(path), end(path));
+            double total = accumulate(begin(cost), end(cost), 0.0);
+            double bound = max(cp, total / T);
+
+            table[{name, T, "bound"}] = format_duration(1e3 * bound);
+            table[{name, T, "plain"}] = format_duration(plain.makespan());
+            table[{name, T, "cp"}] = format_duration(critical.makespan());
+            table[{name, T, "plain%"}] = format("{:.1f}", 100 * plain.utilization());
+            table[{name, T, "cp%"}] = format("{:.1f}", 100 * critical.utilization());
+
+            auto file = "output/" + name + "_" + to_string(T) + ".trace.json";
+            replace(begin(file), end(file), ' ', '_');
+            ofstream(file) << critical.chrome_trace();
+        }
+    }
+
+    print_time_table(table, "Orchestrator makespan, critical path vs plain priorities");
+}
+
 int main() {
     setbuf(stdout, nullptr), setbuf(stderr, nullptr);
+    RUN_BLOCK(speed_test_graph_orchestrator_schedules());
     RUN_BLOCK(speed_test_graph_orchestrator());
     RUN_BLOCK(speed_test_fn_orchestrator());
     RUN_BLOCK(stress_test_pool_submit());
     RUN_BLOCK(stress_test_priority_pool_submit());
+    RUN_BLOCK(stress_test_pool_nested_submit());
+    RUN_BLOCK(speed_test_pool_throughput());
     return 0;
 }
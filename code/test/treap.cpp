@@ -6,15 +6,37 @@ auto operator+(deque<int> a, const deque<int>& b) {
     return a;
 }
 
+// The Treap of treap.hpp over another node allocator
+template <typename Alloc>
+struct AllocTreap : basic_treap<AllocTreap<Alloc>, Alloc> {
+    int size = 1;
+    int64_t key;
+    int64_t sum = 0;
+
+    explicit AllocTreap(int key, int value = 0) : key(key), sum(value) {}
+
+    static int get_size(const AllocTreap* x) { return x ? x->size : 0; }
+    static auto get_key(const AllocTreap* x) { return x->key; }
+    static int64_t get_sum(const AllocTreap* x) { return x ? x->sum : 0; }
+
+    void pushdown() {}
+    void pushup() {
+        sum = key + get_sum(this->kids[0]) + get_sum(this->kids[1]);
+        size = 1 + get_size(this->kids[0]) + get_size(this->kids[1]);
+    }
+};
+
+template <typename Treap>
 auto rand_treap() {
     int key = rand_unif<int>(0, INT_MAX);
     int value = rand_unif<int>(0, 1'000'000);
     return new Treap(key, value);
 }
 
-void stress_test_treap_order() {
+template <typename Treap>
+void stress_test_treap_order(const string& name) {
     LOOP_FOR_DURATION_OR_RUNS_TRACKED (20s, now, 1000, runs) {
-        print_time(now, 20s, "stress treap order ({} runs)", runs);
+        print_time(now, 20s, "stress {} order ({} runs)", name, runs);
 
         const int MAX = 150;
         int N = 0;
@@ -27,7 +49,7 @@ void stress_test_treap_order() {
                 arr.pop_back(), N--;
             }
             if (cointoss(0.95) && N < MAX) { // * push_back
-                auto node = rand_treap();
+                auto node = rand_treap<Treap>();
                 root = push_back(root, node);
                 arr.push_back(node->key), N++;
             }
@@ -36,13 +58,13 @@ void stress_test_treap_order() {
                 arr.pop_front(), N--;
             }
             if (cointoss(0.95) && N < MAX) { // * push_front
-                auto node = rand_treap();
+                auto node = rand_treap<Treap>();
                 root = push_front(root, node);
                 arr.push_front(node->key), N++;
             }
             if (cointoss(0.75) && N < MAX) { // * insert_order
                 int order = rand_unif<int>(0, N);
-                auto node = rand_treap();
+                auto node = rand_treap<Treap>();
                 root = insert_order(root, node, order);
                 arr.insert(begin(arr) + order, node->key), N++;
             }
@@ -107,9 +129,10 @@ void stress_test_treap_order() {
     }
 }
 
-void stress_test_treap_key() {
+template <typename Treap>
+void stress_test_treap_key(const string& name) {
     LOOP_FOR_DURATION_OR_RUNS_TRACKED (20s, now, 1000, runs) {
-        print_time(now, 20s, "stress treap key ({} runs)\r", runs);
+        print_time(now, 20s, "stress {} key ({} runs)", name, runs);
 
         const int MAX = 150;
         int N = 0;
@@ -127,7 +150,7 @@ void stress_test_treap_key() {
 
         for (int loop = 0; loop < 20'000; loop++) {
             if (cointoss(0.75) && N < MAX) { // insert by order
-                auto node = rand_treap();
+                auto node = rand_treap<Treap>();
                 root = insert_key(root, node);
                 arr.insert(lower_bound(begin(arr), end(arr), node->key), node->key), N++;
             }
@@ -216,8 +239,82 @@ void stress_test_treap_key() {
     }
 }
 
+template <typename Alloc, typename Treap = AllocTreap<Alloc>>
+void speed_test_treap_allocator(const string& name,
+                                map<pair<string, int>, string>& table) {
+    static vector<int> Ns = {10'000, 100'000, 1'000'000};
+
+    for (int N : Ns) {
+        printcl("speed test treap allocator {} N={}", name, N);
+        vector<int> keys(2 * N);
+        iota(begin(keys), end(keys), 0);
+        shuffle(begin(keys), end(keys), mt);
+        vector<Treap*> nodes(N);
+        vector<int> picks = rands_unif<int>(N, 0, N - 1);
+
+        if constexpr (!is_same_v<Alloc, global_allocator>) {
+            Alloc::template release<Treap>(); // drop the nodes leaked by the stress tests
+        }
+        int64_t before = resident_memory();
+        if constexpr (is_same_v<Alloc, index_allocator>) {
+            Alloc::template reserve<Treap>(N + 1);
+        }
+        START(alloc);
+        for (int i = 0; i < N; i++) {
+            nodes[i] = new Treap(keys[i]);
+        }
+        TIME(alloc);
+        int64_t after = resident_memory();
+
+        Treap* root = nullptr;
+        START(build);
+        for (int i = 0; i < N; i++) {
+            root = insert_key(root, nodes[i]);
+        }
+        TIME(build);
+
+        // erase a random key and insert a fresh one, so the allocator recycles nodes
+        START(churn);
+        for (int t = 0; t < N; t++) {
+            int i = picks[t];
+            root = delete_key(root, keys[i]);
+            keys[i] = keys[N + t];
+            root = insert_key(root, new Treap(keys[i]));
+        }
+        TIME(churn);
+
+        START(release);
+        if constexpr (is_same_v<Alloc, global_allocator>) {
+            delete_all(root);
+        } else {
+            Alloc::template release<Treap>();
+        }
+        TIME(release);
+
+        table[{name + " alloc", N}] = FORMAT_EACH(alloc, N);
+        table[{name + " build", N}] = FORMAT_EACH(build, N);
+        table[{name + " churn", N}] = FORMAT_EACH(churn, N);
+        table[{name + " release", N}] = FORMAT_EACH(release, N);
+        table[{name + " rss/node", N}] = format("{:.1f}B", 1.0 * (after - before) / N);
+    }
+}
+
+void speed_test_treap_allocators() {
+    map<pair<string, int>, string> table;
+    speed_test_treap_allocator<global_allocator>("global", table);
+    speed_test_treap_allocator<arena_allocator>("arena", table);
+    speed_test_treap_allocator<pool_allocator>("pool", table);
+    speed_test_treap_allocator<index_allocator>("index", table);
+    print_time_table(table, "Treap allocators, time per node (cols=N)");
+}
+
 int main() {
-    RUN_BLOCK(stress_test_treap_order());
-    RUN_BLOCK(stress_test_treap_key());
+    RUN_BLOCK(stress_test_treap_order<Treap>("treap"));
+    RUN_BLOCK(stress_test_treap_key<Treap>("treap"));
+    RUN_BLOCK(stress_test_treap_order<AllocTreap<pool_allocator>>("pool treap"));
+    RUN_BLOCK(stress_test_treap_key<AllocTreap<pool_allocator>>("pool treap"));
+    RUN_BLOCK(stress_test_treap_order<AllocTreap<index_allocator>>("index treap"));
+    RUN_BLOCK(stress_test_treap_key<AllocTreap<index_allocator>>("index treap"));
+    RUN_BLOCK(speed_test_treap_allocators());
     return 0;
 }
@@ -0,0 +1,200 @@
+#include "test_utils.hpp"
+#include "struct/wide_segtree.hpp"
+#include "struct/segtree.hpp"
+#include "struct/segtree_nodes.hpp"
+#include "struct/binary_indexed_tree.hpp"
+
+// Exact for integers, relative tolerance for floating point sums
+template <typename T>
+bool approx_equal(T a, T b) {
+    if constexpr (is_floating_point_v<T>) {
+        return abs(a - b) <= 1e-9 * (1 + abs(b));
+    } else {
+        return a == b;
+    }
+}
+
+template <typename T>
+void stress_test_sum_wide_segtree() {
+    LOOP_FOR_DURATION_TRACKED (1s, now) {
+        print_time(now, 1s, "stress test sum wide segtree {}", 8 * sizeof(T));
+        int N = rand_unif<int>(1, cointoss(0.5) ? 40 : 5000);
+        auto arr = rands_unif<int, T>(N, 0, 1000);
+        sum_wide_segtree<T> st(N, arr);
+
+        for (int run = 0; run < 100; run++) {
+            if (cointoss(0.5)) {
+                int i = rand_unif<int>(0, N - 1);
+                T v = rand_unif<int>(0, 1000);
+                st.update_point(i, v);
+                arr[i] += v;
+            }
+            vector<T> prefix(N + 1);
+            partial_sum(begin(arr), end(arr), begin(prefix) + 1);
+            auto [l, r] = diff_unif<int>(0, N);
+            assert(approx_equal(st.query_range(l, r), prefix[r] - prefix[l]));
+            assert(approx_equal(st.query_all(), prefix[N]));
+            assert(approx_equal(st.query_point(l % N), arr[l % N]));
+
+            T x = rand_unif<int64_t>(-5, prefix[N] + 5);
+            auto [i, sum] = st.prefix_lower_bound(x);
+            auto it = lower_bound(begin(prefix) + 1, end(prefix), x);
+            int j = x <= 0 ? 0 : it - begin(prefix) - 1;
+            assert(i == j && approx_equal(sum, prefix[i]));
+        }
+    }
+}
+
+template <typename T, bool MAX>
+void stress_test_extremum_wide_segtree() {
+    LOOP_FOR_DURATION_TRACKED (1s, now) {
+        print_time(now, 1s, "stress test {} wide segtree {}", MAX ? "max" : "min",
+                   8 * sizeof(T));
+        int N = rand_unif<int>(1, cointoss(0.5) ? 40 : 5000);
+        auto arr = rands_unif<int, T>(N, -1'000'000, 1'000'000);
+        extremum_wide_segtree<T, MAX> st(N, arr);
+
+        for (int run = 0; run < 100; run++) {
+            if (cointoss(0.5)) {
+                int i = rand_unif<int>(0, N - 1);
+                T v = rand_unif<int>(-1'000'000, 1'000'000);
+                st.update_point(i, v);
+                arr[i] = v;
+            }
+            auto [l, r] = diff_unif<int>(0, N);
+            T x = st.ID;
+            for (int i = l; i < r; i++) {
+                x = MAX ? max(x, arr[i]) : min(x, arr[i]);
+            }
+            assert(st.query_range(l, r) == x);
+            assert(approx_equal(st.query_point(l % N), arr[l % N]));
+        }
+    }
+}
+
+struct max_segnode {
+    static constexpr bool LAZY = false, RANGES = false;
+    int value = INT_MIN;
+
+    max_segnode() = default;
+    max_segnode(int value) : value(value) {}
+    operator int() const { return value; }
+
+    void pushup(const max_segnode& lhs, const max_segnode& rhs) {
+        value = max(lhs.value, rhs.value);
+    }
+    void apply(int v) { value = v; }
+};
+
+void speed_test_wide_segtree() {
+    static vector<int> Ns = {10'000, 1'000'000, 30'000'000};
+    const int M = 1'000'000;
+    map<pair<string, int>, string> table;
+
+    auto bench = [&](const string& name, int N, auto&& fn) {
+        START_ACC(ops);
+        LOOP_FOR_DURATION_OR_RUNS_TRACKED (1s, now, 100, runs) {
+            print_time(now, 1s, "speed test {} N={}", name, N);
+            START(ops);
+            fn();
+            ADD_TIME(ops);
+        }
+        table[{name, N}] = FORMAT_EACH(ops, runs * M);
+    };
+
+    for (int N : Ns) {
+        auto arr = rands_unif<int, int64_t>(N, 0, 1000);
+        vector<int> is(M), xs(M);
+        vector<array<int, 2>> ranges(M);
+        for (int k = 0; k < M; k++) {
+            is[k] = rand_unif<int>(0, N - 1), ranges[k] = diff_unif<int>(0, N);
+        }
+        int64_t sink = 0;
+
+        {
+            sum_wide_segtree<int64_t> wide(N, arr);
+            segtree<sum_segnode> seg(N, arr);
+            bitree<int64_t, plus<int64_t>> bit(N, arr);
+            int64_t total = wide.query_all();
+            for (int k = 0; k < M; k++) {
+                xs[k] = rand_unif<int64_t>(1, total);
+            }
+
+            bench("sum update wide", N, [&]() {
+                for (int i : is)
+                    wide.update_point(i, 1);
+            });
+            bench("sum update segtree", N, [&]() {
+                for (int i : is)
+                    seg.update_point(i, 1);
+            });
+            bench("sum update bitree", N, [&]() {
+                for (int i : is)
+                    bit.combine(i, 1);
+            });
+            bench("sum range wide", N, [&]() {
+                for (auto [l, r] : ranges)
+                    sink += wide.query_range(l, r);
+            });
+            bench("sum range segtree", N, [&]() {
+                for (auto [l, r] : ranges)
+                    sink += seg.query_range(l, r);
+            });
+            bench("sum range bitree", N, [&]() {
+                for (auto [l, r] : ranges)
+                    sink += bit.prefix(r) - bit.prefix(l);
+            });
+            bench("sum search wide", N, [&]() {
+                for (int64_t x : xs)
+                    sink += wide.prefix_lower_bound(x).first;
+            });
+            bench("sum search segtree", N, [&]() {
+                for (int64_t x : xs)
+                    sink += seg.prefix_binary_search([&](auto& v) { return x <= v; })
+                                .first;
+            });
+            bench("sum search bitree", N, [&]() {
+                for (int64_t x : xs)
+                    sink += bit.lower_bound([&](auto v) { return x <= v; });
+            });
+        }
+        {
+            vector<int> small(begin(arr), end(arr));
+            max_wide_segtree<int> wide(N, small);
+            bottomup_segtree<max_segnode> seg(N, small);
+
+            bench("max update wide", N, [&]() {
+                for (int i : is)
+                    wide.update_point(i, i & 1023);
+            });
+            bench("max update segtree", N, [&]() {
+                for (int i : is)
+                    seg.update_point(i, i & 1023);
+            });
+            bench("max range wide", N, [&]() {
+                for (auto [l, r] : ranges)
+                    sink += wide.query_range(l, r);
+            });
+            bench("max range segtree", N, [&]() {
+                for (auto [l, r] : ranges)
+                    sink += seg.query_range(l, r);
+            });
+        }
+        printcl("sink: {}\n", sink);
+    }
+
+    // segtree is segtree<sum_segnode> for sums and bottomup_segtree for max
+    print_time_table(table, "Wide segtree, time per operation (cols=N)");
+}
+
+int main() {
+    RUN_BLOCK(stress_test_sum_wide_segtree<int32_t>());
+    RUN_BLOCK(stress_test_sum_wide_segtree<int64_t>());
+    RUN_BLOCK(stress_test_sum_wide_segtree<double>());
+    RUN_BLOCK((stress_test_extremum_wide_segtree<int32_t, false>()));
+    RUN_BLOCK((stress_test_extremum_wide_segtree<int32_t, true>()));
+    RUN_BLOCK((stress_test_extremum_wide_segtree<int64_t, false>()));
+    RUN_BLOCK((stress_test_extremum_wide_segtree<int16_t, true>()));
+    RUN_BLOCK(speed_test_wide_segtree());
+    return 0;
+}